@@ -0,0 +1,237 @@
+/** \file
+ * Synthetic program generators for the compiler benchmark suite.
+ */
+
+#include "generators.h"
+
+#include <cmath>
+#include <random>
+#include "ql/utils/pair.h"
+#include "ql/utils/exception.h"
+
+namespace ql {
+namespace bench {
+
+namespace {
+
+/**
+ * Helper class for building the cQASM representation of a program while
+ * keeping track of gate counts.
+ */
+class Builder {
+private:
+
+    /**
+     * The program being built.
+     */
+    Program program;
+
+    /**
+     * Stream for the body of the program.
+     */
+    utils::StrStrm body;
+
+public:
+
+    /**
+     * Starts building a program with the given name and qubit count.
+     */
+    Builder(const utils::Str &name, utils::UInt num_qubits) {
+        if (!num_qubits) {
+            throw utils::Exception("benchmark programs need at least one qubit");
+        }
+        program.name = name;
+        program.num_qubits = num_qubits;
+        program.num_gates = 0;
+        program.num_two_qubit_gates = 0;
+    }
+
+    /**
+     * Adds a single-qubit gate.
+     */
+    void gate(const utils::Str &name, utils::UInt q) {
+        body << "    " << name << " q[" << q << "]\n";
+        program.num_gates++;
+    }
+
+    /**
+     * Adds a two-qubit gate.
+     */
+    void gate(const utils::Str &name, utils::UInt q0, utils::UInt q1) {
+        body << "    " << name << " q[" << q0 << "], q[" << q1 << "]\n";
+        program.num_gates++;
+        program.num_two_qubit_gates++;
+    }
+
+    /**
+     * Finishes the program.
+     */
+    Program finish() {
+        utils::StrStrm ss;
+        ss << "version 1.2\n";
+        ss << "qubits " << program.num_qubits << "\n";
+        ss << "\n";
+        ss << "pragma @ql.name(\"" << program.name << "\")\n";
+        ss << "\n";
+        ss << ".main\n";
+        ss << body.str();
+        program.cqasm = ss.str();
+        return program;
+    }
+
+};
+
+/**
+ * Returns a uniformly-distributed random integer in [0, n).
+ */
+utils::UInt pick(Rng &rng, utils::UInt n) {
+    return std::uniform_int_distribution<utils::UInt>(0, n - 1)(rng);
+}
+
+/**
+ * Returns a uniformly-distributed random real number in [0, 1).
+ */
+utils::Real uniform(Rng &rng) {
+    return (utils::Real)(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+} // anonymous namespace
+
+/**
+ * Generates a random circuit of num_gates gates over num_qubits qubits, with
+ * the given fraction of two-qubit gates.
+ */
+Program generate_random(
+    const GateSet &gates,
+    utils::UInt num_qubits,
+    utils::UInt num_gates,
+    utils::Real two_qubit_fraction,
+    Rng &rng
+) {
+    Builder b("random_" + utils::to_string(num_qubits) + "q_" + utils::to_string(num_gates) + "g", num_qubits);
+    for (utils::UInt i = 0; i < num_gates; i++) {
+        if (num_qubits > 1 && uniform(rng) < two_qubit_fraction) {
+            auto q0 = pick(rng, num_qubits);
+            auto q1 = pick(rng, num_qubits - 1);
+            if (q1 >= q0) q1++;
+            b.gate(gates.two_qubit[pick(rng, gates.two_qubit.size())], q0, q1);
+        } else {
+            b.gate(gates.single_qubit[pick(rng, gates.single_qubit.size())], pick(rng, num_qubits));
+        }
+    }
+    return b.finish();
+}
+
+/**
+ * Generates the gate structure of a quantum Fourier transform over num_qubits
+ * qubits. Controlled phase rotations are approximated by a two-qubit gate
+ * followed by a phase gate, which retains the O(n^2) interaction structure
+ * that matters for compilation.
+ */
+Program generate_qft(
+    const GateSet &gates,
+    utils::UInt num_qubits
+) {
+    Builder b("qft_" + utils::to_string(num_qubits) + "q", num_qubits);
+    for (utils::UInt i = 0; i < num_qubits; i++) {
+        b.gate(gates.hadamard, i);
+        for (utils::UInt j = i + 1; j < num_qubits; j++) {
+            b.gate(gates.two_qubit.front(), j, i);
+            b.gate(gates.phase, i);
+        }
+    }
+    return b.finish();
+}
+
+/**
+ * Generates a simultaneous single-qubit randomized benchmarking sequence of
+ * num_cliffords random gates on each of num_qubits qubits, surrounded by
+ * preparation and measurement, and interleaved with two-qubit gates between
+ * neighboring qubit pairs every interleave layers (0 to disable).
+ */
+Program generate_rb(
+    const GateSet &gates,
+    utils::UInt num_qubits,
+    utils::UInt num_cliffords,
+    utils::UInt interleave,
+    Rng &rng
+) {
+    Builder b("rb_" + utils::to_string(num_qubits) + "q_" + utils::to_string(num_cliffords) + "c", num_qubits);
+    for (utils::UInt q = 0; q < num_qubits; q++) {
+        b.gate(gates.prepare, q);
+    }
+    for (utils::UInt layer = 0; layer < num_cliffords; layer++) {
+        for (utils::UInt q = 0; q < num_qubits; q++) {
+            b.gate(gates.single_qubit[pick(rng, gates.single_qubit.size())], q);
+        }
+        if (interleave && (layer + 1) % interleave == 0) {
+            for (utils::UInt q = layer % 2; q + 1 < num_qubits; q += 2) {
+                b.gate(gates.two_qubit.front(), q, q + 1);
+            }
+        }
+    }
+    for (utils::UInt q = 0; q < num_qubits; q++) {
+        b.gate(gates.measure, q);
+    }
+    return b.finish();
+}
+
+/**
+ * Generates num_cycles surface-code-like syndrome extraction cycles. The
+ * qubits are laid out on a square grid in row-major order, alternating between
+ * data and ancilla qubits; each ancilla interacts with its (up to four)
+ * neighbors in every cycle, and is then measured and reset.
+ */
+Program generate_surface(
+    const GateSet &gates,
+    utils::UInt num_qubits,
+    utils::UInt num_cycles
+) {
+    Builder b("surface_" + utils::to_string(num_qubits) + "q_" + utils::to_string(num_cycles) + "c", num_qubits);
+
+    // Lay the qubits out on a grid that is as square as possible.
+    auto width = (utils::UInt)std::ceil(std::sqrt((utils::Real)num_qubits));
+    auto is_ancilla = [width](utils::UInt q) {
+        return ((q / width) + (q % width)) % 2 == 1;
+    };
+
+    // Build the interaction order: north, west, east, south, such that no
+    // qubit is used twice within a round.
+    utils::Vec<utils::Vec<utils::Pair<utils::UInt, utils::UInt>>> rounds(4);
+    for (utils::UInt a = 0; a < num_qubits; a++) {
+        if (!is_ancilla(a)) continue;
+        auto row = a / width;
+        auto col = a % width;
+        if (row > 0) rounds[0].push_back({a, a - width});
+        if (col > 0) rounds[1].push_back({a, a - 1});
+        if (col + 1 < width && a + 1 < num_qubits) rounds[2].push_back({a, a + 1});
+        if (a + width < num_qubits) rounds[3].push_back({a, a + width});
+    }
+
+    for (utils::UInt q = 0; q < num_qubits; q++) {
+        b.gate(gates.prepare, q);
+    }
+    for (utils::UInt cycle = 0; cycle < num_cycles; cycle++) {
+        for (utils::UInt a = 0; a < num_qubits; a++) {
+            if (is_ancilla(a)) b.gate(gates.hadamard, a);
+        }
+        for (const auto &round : rounds) {
+            for (const auto &pair : round) {
+                b.gate(gates.two_qubit.front(), pair.first, pair.second);
+            }
+        }
+        for (utils::UInt a = 0; a < num_qubits; a++) {
+            if (is_ancilla(a)) b.gate(gates.hadamard, a);
+        }
+        for (utils::UInt a = 0; a < num_qubits; a++) {
+            if (is_ancilla(a)) b.gate(gates.measure, a);
+        }
+        for (utils::UInt a = 0; a < num_qubits; a++) {
+            if (is_ancilla(a)) b.gate(gates.prepare, a);
+        }
+    }
+    return b.finish();
+}
+
+} // namespace bench
+} // namespace ql
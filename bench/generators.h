@@ -0,0 +1,143 @@
+/** \file
+ * Synthetic program generators for the compiler benchmark suite.
+ */
+
+#pragma once
+
+#include <random>
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * The names of the gates that the generators may use for a particular
+ * platform. All gates must be available in the platform as either an
+ * instruction or a decomposition rule for arbitrary qubit operands.
+ */
+struct GateSet {
+
+    /**
+     * Single-qubit gates without parameters, used for random single-qubit
+     * layers.
+     */
+    utils::Vec<utils::Str> single_qubit;
+
+    /**
+     * A Hadamard-like single-qubit gate, used for basis changes.
+     */
+    utils::Str hadamard;
+
+    /**
+     * A phase-like single-qubit gate, used for the phase corrections in QFT.
+     */
+    utils::Str phase;
+
+    /**
+     * Two-qubit entangling gates.
+     */
+    utils::Vec<utils::Str> two_qubit;
+
+    /**
+     * Single-qubit preparation gate.
+     */
+    utils::Str prepare;
+
+    /**
+     * Single-qubit measurement gate.
+     */
+    utils::Str measure;
+
+};
+
+/**
+ * A generated program.
+ */
+struct Program {
+
+    /**
+     * The name of the program.
+     */
+    utils::Str name;
+
+    /**
+     * The cQASM 1.2 representation of the program.
+     */
+    utils::Str cqasm;
+
+    /**
+     * Number of qubits used by the program.
+     */
+    utils::UInt num_qubits;
+
+    /**
+     * Number of gates in the program before decomposition.
+     */
+    utils::UInt num_gates;
+
+    /**
+     * Number of two-qubit gates in the program before decomposition.
+     */
+    utils::UInt num_two_qubit_gates;
+
+};
+
+/**
+ * Random number generator type used by the generators. Fixed such that the
+ * generated programs are reproducible across platforms for a given seed.
+ */
+using Rng = std::mt19937_64;
+
+/**
+ * Generates a random circuit of num_gates gates over num_qubits qubits, with
+ * the given fraction of two-qubit gates.
+ */
+Program generate_random(
+    const GateSet &gates,
+    utils::UInt num_qubits,
+    utils::UInt num_gates,
+    utils::Real two_qubit_fraction,
+    Rng &rng
+);
+
+/**
+ * Generates the gate structure of a quantum Fourier transform over num_qubits
+ * qubits. Controlled phase rotations are approximated by a two-qubit gate
+ * followed by a phase gate, which retains the O(n^2) interaction structure
+ * that matters for compilation.
+ */
+Program generate_qft(
+    const GateSet &gates,
+    utils::UInt num_qubits
+);
+
+/**
+ * Generates a simultaneous single-qubit randomized benchmarking sequence of
+ * num_cliffords random gates on each of num_qubits qubits, surrounded by
+ * preparation and measurement, and interleaved with two-qubit gates between
+ * neighboring qubit pairs every interleave layers (0 to disable).
+ */
+Program generate_rb(
+    const GateSet &gates,
+    utils::UInt num_qubits,
+    utils::UInt num_cliffords,
+    utils::UInt interleave,
+    Rng &rng
+);
+
+/**
+ * Generates num_cycles surface-code-like syndrome extraction cycles. The
+ * qubits are laid out on a square grid in row-major order, alternating between
+ * data and ancilla qubits; each ancilla interacts with its (up to four)
+ * neighbors in every cycle, and is then measured and reset.
+ */
+Program generate_surface(
+    const GateSet &gates,
+    utils::UInt num_qubits,
+    utils::UInt num_cycles
+);
+
+} // namespace bench
+} // namespace ql
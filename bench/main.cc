@@ -0,0 +1,633 @@
+/** \file
+ * Reproducible compiler benchmark suite.
+ *
+ * Generates synthetic programs for a number of platforms, runs them through
+ * the main compilation stages (cQASM reading, decomposition, mapping,
+ * scheduling, and code generation), and reports the time, throughput, and
+ * memory usage of each stage as JSON for regression tracking. Run with
+ * --help for usage information.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <regex>
+#include "ql/version.h"
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/json.h"
+#include "ql/utils/logger.h"
+#include "ql/utils/profile.h"
+#include "ql/utils/arena.h"
+#include "ql/utils/parallel.h"
+#include "ql/utils/filesystem.h"
+#include "ql/ir/compat/platform.h"
+#include "ql/ir/compat/names.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/cqasm/read.h"
+#include "ql/pmgr/manager.h"
+#include "ql/pmgr/profile.h"
+#include "generators.h"
+
+using namespace ql;
+using namespace ql::bench;
+
+/**
+ * Description of a platform to benchmark against.
+ */
+struct PlatformConfig {
+
+    /**
+     * Short name of the platform, used in result names.
+     */
+    utils::Str name;
+
+    /**
+     * Platform configuration filename (relative to the configuration
+     * directory) or architecture name.
+     */
+    utils::Str config;
+
+    /**
+     * Whether config is a filename (true) or an architecture name (false).
+     */
+    utils::Bool is_file;
+
+    /**
+     * The number of qubits that the generators may use.
+     */
+    utils::UInt num_qubits;
+
+    /**
+     * The gates that the generators may use.
+     */
+    GateSet gates;
+
+    /**
+     * Whether the platform has a topology that the mapper can route for.
+     */
+    utils::Bool map;
+
+    /**
+     * The type of the code generation pass.
+     */
+    utils::Str codegen;
+
+    /**
+     * Whether this platform is only benchmarked when --large is passed.
+     */
+    utils::Bool large;
+
+};
+
+/**
+ * Returns the platforms to benchmark against.
+ */
+static utils::Vec<PlatformConfig> get_platforms() {
+    GateSet cc_light_gates;
+    cc_light_gates.single_qubit = {"x", "y", "z", "h", "s", "sdag", "t", "tdag", "x45", "xm45", "xm90", "ym90"};
+    cc_light_gates.hadamard = "h";
+    cc_light_gates.phase = "t";
+    cc_light_gates.two_qubit = {"cz", "cnot"};
+    cc_light_gates.prepare = "prepz";
+    cc_light_gates.measure = "measure";
+
+    GateSet cc_gates;
+    cc_gates.single_qubit = {"x", "y", "rx90", "ry90", "rxm90", "rym90"};
+    cc_gates.hadamard = "ry90";
+    cc_gates.phase = "rx90";
+    cc_gates.two_qubit = {"cz", "cnot"};
+    cc_gates.prepare = "prepz";
+    cc_gates.measure = "measure";
+
+    return {
+        {"cc_light_s7", "cc_light", false, 7, cc_light_gates, true, "io.cqasm.Report", false},
+        {"cc_light_s17", "cc_light.s17", false, 17, cc_light_gates, true, "io.cqasm.Report", false},
+        {"mc_4x4", "test_multi_core_4x4_full.json", true, 16, cc_light_gates, true, "io.cqasm.Report", false},
+        {"mc_8x1024", "test_multi_core_8x1024_full.json", true, 8192, cc_light_gates, true, "io.cqasm.Report", true},
+        {"cc_s17", "cc/test_cfg_cc.json", true, 17, cc_gates, false, "arch.cc.gen.VQ1Asm", false}
+    };
+}
+
+/**
+ * Returns the programs to benchmark for the given platform. scale multiplies
+ * the size of the programs.
+ */
+static utils::Vec<Program> get_programs(
+    const PlatformConfig &platform,
+    utils::UInt scale,
+    utils::UInt seed
+) {
+    utils::Vec<Program> programs;
+    Rng rng(seed);
+    auto n = platform.num_qubits;
+    programs.push_back(generate_random(platform.gates, n, 1000 * scale, 0.3, rng));
+    programs.push_back(generate_qft(platform.gates, utils::min<utils::UInt>(n, 32 * scale)));
+    programs.push_back(generate_rb(platform.gates, n, 100 * scale, 10, rng));
+    programs.push_back(generate_surface(platform.gates, n, 10 * scale));
+    return programs;
+}
+
+/**
+ * Builds the pass manager for the given platform, with one pass per stage.
+ */
+static pmgr::Manager build_strategy(
+    const PlatformConfig &platform,
+    const utils::Str &output_dir
+) {
+    pmgr::Manager manager;
+    utils::Str output_prefix = output_dir + "/%N";
+    manager.append_pass(
+        "dec.Instructions",
+        "decompose",
+        {{"output_prefix", output_prefix}}
+    );
+    if (platform.map) {
+        manager.append_pass(
+            "map.qubits.Map",
+            "map",
+            {
+                {"output_prefix", output_prefix},
+                {"tie_break_method", "first"}
+            }
+        );
+    }
+    manager.append_pass(
+        "sch.ListSchedule",
+        "schedule",
+        {
+            {"output_prefix", output_prefix},
+            {"resource_constraints", "yes"}
+        }
+    );
+    manager.append_pass(
+        platform.codegen,
+        "codegen",
+        {{"output_prefix", output_prefix}}
+    );
+    return manager;
+}
+
+/**
+ * Converts resource usage for a stage to JSON, including throughput in terms
+ * of the number of input gates.
+ */
+static utils::Json usage_to_json(
+    const utils::ResourceUsage &usage,
+    utils::UInt num_gates
+) {
+    utils::Json json;
+    json["wall_time"] = usage.wall_time;
+    json["cpu_time"] = usage.cpu_time;
+    json["peak_rss_delta"] = usage.peak_rss;
+    if (usage.wall_time > 0.0) {
+        json["gates_per_second"] = num_gates / usage.wall_time;
+    } else {
+        json["gates_per_second"] = nullptr;
+    }
+    return json;
+}
+
+/**
+ * Runs a single benchmark case, returning the JSON result record. If
+ * use_arena is set, all IR nodes are allocated from an arena.
+ */
+static utils::Json run_case(
+    const PlatformConfig &platform,
+    const utils::Str &config_dir,
+    const Program &program,
+    const utils::Str &output_dir,
+    utils::Bool use_arena
+) {
+    utils::Json result;
+    result["name"] = platform.name + "/" + program.name;
+    result["platform"] = platform.name;
+    result["program"] = program.name;
+    result["num_qubits"] = program.num_qubits;
+    result["num_gates"] = program.num_gates;
+    result["num_two_qubit_gates"] = program.num_two_qubit_gates;
+    utils::Json stages;
+    utils::ArenaRef arena;
+    if (use_arena) {
+        arena = utils::Arena::create();
+    }
+    auto total_start = utils::ResourceUsage::now();
+
+    try {
+        utils::ArenaScope arena_scope(arena);
+
+        // Platform construction and conversion.
+        auto start = utils::ResourceUsage::now();
+        auto old_platform = ir::compat::Platform::build(
+            platform.name,
+            platform.is_file ? (config_dir + "/" + platform.config) : platform.config
+        );
+        auto ir = ir::convert_old_to_new(old_platform);
+        stages["platform"] = usage_to_json(utils::ResourceUsage::now().since(start), 0);
+
+        // cQASM reading.
+        start = utils::ResourceUsage::now();
+        ir::cqasm::read(ir, program.cqasm, program.name + ".cq");
+        stages["read"] = usage_to_json(utils::ResourceUsage::now().since(start), program.num_gates);
+
+        // The pass-based stages.
+        auto manager = build_strategy(platform, output_dir);
+        pmgr::profile::Ref profiler;
+        profiler.emplace();
+        manager.compile(ir, profiler);
+        for (const auto &record : profiler->get_records()) {
+            if (record.depth == 1 && record.kind == pmgr::profile::RecordKind::PASS) {
+                stages[record.name] = usage_to_json(record.usage, program.num_gates);
+                stages[record.name]["statements_out"] = record.statements_out;
+            }
+        }
+
+        result["status"] = "ok";
+    } catch (std::exception &e) {
+        result["status"] = "error";
+        result["error"] = e.what();
+    }
+
+    result["stages"] = stages;
+    result["total"] = usage_to_json(utils::ResourceUsage::now().since(total_start), program.num_gates);
+    result["peak_rss"] = utils::get_peak_rss();
+    if (arena) {
+        result["arena"] = {
+            {"allocations", arena->get_num_allocations()},
+            {"reuses", arena->get_num_reuses()},
+            {"forwarded", arena->get_num_forwarded()},
+            {"chunk_bytes", arena->get_num_chunk_bytes()}
+        };
+    }
+    return result;
+}
+
+/**
+ * The platform used for the instruction name microbenchmark, relative to the
+ * configuration directory. This is the largest CC platform configuration file
+ * in the test suite.
+ */
+static const utils::Str NAMES_PLATFORM = "cc/config_cc_s17_direct_iq.json";
+
+/**
+ * Name of the instruction name microbenchmark case.
+ */
+static const utils::Str NAMES_CASE = "micro/instruction_names";
+
+/**
+ * Normalizes an instruction name using the std::regex-based rules that were
+ * used by the platform loader and the IR conversion before they were replaced
+ * by the tokenizer in ql/ir/compat/names.h, for comparison.
+ */
+static utils::UInt regex_normalize(const utils::Str &name) {
+    static const std::regex TRIM("^(\\s)+|(\\s)+$");
+    static const std::regex MULTIPLE_SPACES("(\\s)+");
+    static const std::regex COMMA_SPACES("\\s*,\\s*");
+    static const std::regex SEPARATORS("[\\s,]+");
+    static const std::regex REGISTER("[qbc][0-9]+");
+
+    // Platform loader rules.
+    auto lower = utils::to_lower(name);
+    auto trimmed = std::regex_replace(lower, TRIM, "");
+    auto key = std::regex_replace(trimmed, MULTIPLE_SPACES, " ");
+    key = std::regex_replace(key, COMMA_SPACES, ",");
+
+    // Conversion rules.
+    auto split = std::regex_replace(trimmed, SEPARATORS, " ");
+    utils::UInt num_registers = 0;
+    utils::UInt pos = 0;
+    while (true) {
+        auto next = split.find_first_of(' ', pos);
+        if (std::regex_match(split.substr(pos, next - pos), REGISTER)) {
+            num_registers++;
+        }
+        if (next == utils::Str::npos) break;
+        pos = next + 1;
+    }
+
+    return key.size() + num_registers;
+}
+
+/**
+ * Normalizes an instruction name using the tokenizer used by the platform
+ * loader and the IR conversion.
+ */
+static utils::UInt tokenizer_normalize(const utils::Str &name) {
+    auto key = ir::compat::normalize_instruction_name(name);
+    utils::UInt num_registers = 0;
+    for (const auto &part : ir::compat::split_instruction_name(name)) {
+        if (ir::compat::is_register_operand(part)) {
+            num_registers++;
+        }
+    }
+    return key.size() + num_registers;
+}
+
+/**
+ * Runs the instruction name microbenchmark: normalizes all instruction names,
+ * decomposition keys, and decomposition sub-instructions of a large CC
+ * platform iterations times with both the old regex-based rules and the
+ * tokenizer, and times a complete platform load and conversion. Returns the
+ * JSON result record.
+ */
+static utils::Json run_instruction_names(
+    const utils::Str &config_dir,
+    utils::UInt iterations
+) {
+    utils::Json result;
+    result["name"] = NAMES_CASE;
+    result["platform"] = NAMES_PLATFORM;
+    utils::Json stages;
+    auto total_start = utils::ResourceUsage::now();
+
+    try {
+
+        // Platform load and conversion.
+        auto start = utils::ResourceUsage::now();
+        auto platform = ir::compat::Platform::build("cc", config_dir + "/" + NAMES_PLATFORM);
+        ir::convert_old_to_new(platform);
+        stages["platform"] = usage_to_json(utils::ResourceUsage::now().since(start), 0);
+
+        // Gather the names from the preprocessed configuration.
+        utils::Vec<utils::Str> names;
+        const auto &config = platform->platform_config;
+        for (auto it = config["instructions"].begin(); it != config["instructions"].end(); ++it) {
+            names.push_back(it.key());
+        }
+        if (config.count("gate_decomposition")) {
+            const auto &decompositions = config["gate_decomposition"];
+            for (auto it = decompositions.begin(); it != decompositions.end(); ++it) {
+                names.push_back(it.key());
+                for (const auto &sub : *it) {
+                    if (sub.is_string()) {
+                        names.push_back(sub.get<utils::Str>());
+                    }
+                }
+            }
+        }
+        result["num_names"] = names.size();
+        result["iterations"] = iterations;
+
+        // Normalize the names with both methods. The results are checksummed
+        // to check that they agree, and to keep the optimizer from eliding
+        // the work.
+        utils::UInt regex_checksum = 0;
+        start = utils::ResourceUsage::now();
+        for (utils::UInt i = 0; i < iterations; i++) {
+            for (const auto &name : names) {
+                regex_checksum += regex_normalize(name);
+            }
+        }
+        stages["regex"] = usage_to_json(utils::ResourceUsage::now().since(start), names.size() * iterations);
+        utils::UInt tokenizer_checksum = 0;
+        start = utils::ResourceUsage::now();
+        for (utils::UInt i = 0; i < iterations; i++) {
+            for (const auto &name : names) {
+                tokenizer_checksum += tokenizer_normalize(name);
+            }
+        }
+        stages["tokenizer"] = usage_to_json(utils::ResourceUsage::now().since(start), names.size() * iterations);
+        if (regex_checksum != tokenizer_checksum) {
+            throw utils::Exception("tokenizer and regex-based normalization disagree");
+        }
+
+        result["status"] = "ok";
+    } catch (std::exception &e) {
+        result["status"] = "error";
+        result["error"] = e.what();
+    }
+
+    result["stages"] = stages;
+    result["total"] = usage_to_json(utils::ResourceUsage::now().since(total_start), 0);
+    result["peak_rss"] = utils::get_peak_rss();
+    return result;
+}
+
+/**
+ * Name of the IR node allocation microbenchmark case.
+ */
+static const utils::Str ARENA_CASE = "micro/ir_node_allocation";
+
+/**
+ * Allocates and drops the given number of IR nodes per thread (four times
+ * over, to also exercise reuse of deallocated nodes) on the given number of
+ * threads, using the given arena (if any).
+ */
+static void allocate_ir_nodes(
+    utils::UInt count,
+    utils::UInt num_threads,
+    const utils::ArenaRef &arena
+) {
+    utils::ArenaScope arena_scope(arena);
+    utils::parallel_for(num_threads, [count](utils::UInt) {
+        utils::Vec<utils::One<ir::IntLiteral>> nodes;
+        nodes.reserve(count);
+        for (utils::UInt round = 0; round < 4; round++) {
+            for (utils::UInt i = 0; i < count; i++) {
+                nodes.push_back(utils::make<ir::IntLiteral>((utils::Int)i, ir::DataTypeLink()));
+            }
+            nodes.clear();
+        }
+    }, num_threads);
+}
+
+/**
+ * Runs the IR node allocation microbenchmark, comparing allocation of IR
+ * nodes on the heap with allocation from an arena, on a single thread and
+ * on all hardware threads. The throughput is reported in nodes per second.
+ */
+static utils::Json run_ir_node_allocation(utils::UInt count) {
+    utils::Json result;
+    result["name"] = ARENA_CASE;
+    utils::Json stages;
+    auto total_start = utils::ResourceUsage::now();
+
+    try {
+        auto num_threads = utils::get_num_threads();
+        result["num_nodes"] = count;
+        result["num_threads"] = num_threads;
+        for (utils::UInt threads : {(utils::UInt)1, num_threads}) {
+            for (utils::Bool use_arena : {false, true}) {
+                utils::ArenaRef arena;
+                if (use_arena) {
+                    arena = utils::Arena::create();
+                }
+                auto start = utils::ResourceUsage::now();
+                allocate_ir_nodes(count, threads, arena);
+                utils::Str stage = use_arena ? "arena" : "heap";
+                if (threads > 1) {
+                    stage += "_parallel";
+                }
+                stages[stage] = usage_to_json(
+                    utils::ResourceUsage::now().since(start),
+                    4 * count * threads
+                );
+            }
+            if (num_threads == 1) {
+                break;
+            }
+        }
+        result["status"] = "ok";
+    } catch (std::exception &e) {
+        result["status"] = "error";
+        result["error"] = e.what();
+    }
+
+    result["stages"] = stages;
+    result["total"] = usage_to_json(utils::ResourceUsage::now().since(total_start), 0);
+    result["peak_rss"] = utils::get_peak_rss();
+    return result;
+}
+
+/**
+ * Prints a one-line summary of the given result record. Returns whether the
+ * case succeeded.
+ */
+static utils::Bool print_result(const utils::Str &name, const utils::Json &result) {
+    std::cout << std::left << std::setw(48) << name << std::right;
+    if (result["status"] != "ok") {
+        std::cout << "  error: " << result["error"].get<utils::Str>() << "\n";
+        return false;
+    }
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(10) << result["total"]["wall_time"].get<utils::Real>() << " s";
+    std::cout << std::setw(12) << (result["peak_rss"].get<utils::UInt>() >> 20) << " MiB peak\n";
+    return true;
+}
+
+/**
+ * Prints usage information.
+ */
+static void print_usage(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [options]\n";
+    std::cout << "\n";
+    std::cout << "Options:\n";
+    std::cout << "  --list               list the benchmark cases and exit\n";
+    std::cout << "  --filter <substr>    only run cases whose name contains <substr>\n";
+    std::cout << "  --large              include the large (8192-qubit) platform\n";
+    std::cout << "  --arena              allocate IR nodes from an arena\n";
+    std::cout << "  --scale <n>          multiply program sizes by <n> (default 1)\n";
+    std::cout << "  --repeat <n>         run every case <n> times (default 1)\n";
+    std::cout << "  --seed <n>           random seed for the generators (default 0)\n";
+    std::cout << "  --config-dir <dir>   directory containing the platform files\n";
+    std::cout << "  --output-dir <dir>   directory for compiler output (default bench_output)\n";
+    std::cout << "  --output <file>      JSON result file (default ql_bench.json)\n";
+    std::cout << "  --help               print this message\n";
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command-line arguments.
+    utils::Bool list = false;
+    utils::Bool large = false;
+    utils::Bool arena = false;
+    utils::Str filter;
+    utils::UInt scale = 1;
+    utils::UInt repeat = 1;
+    utils::UInt seed = 0;
+    utils::Str config_dir = QL_BENCH_CONFIG_DIR;
+    utils::Str output_dir = "bench_output";
+    utils::Str output = "ql_bench.json";
+    try {
+        for (int i = 1; i < argc; i++) {
+            utils::Str arg = argv[i];
+            auto next = [&]() -> utils::Str {
+                if (i + 1 >= argc) {
+                    throw utils::Exception("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--list") {
+                list = true;
+            } else if (arg == "--filter") {
+                filter = next();
+            } else if (arg == "--large") {
+                large = true;
+            } else if (arg == "--arena") {
+                arena = true;
+            } else if (arg == "--scale") {
+                scale = utils::parse_uint(next());
+            } else if (arg == "--repeat") {
+                repeat = utils::parse_uint(next());
+            } else if (arg == "--seed") {
+                seed = utils::parse_uint(next());
+            } else if (arg == "--config-dir") {
+                config_dir = next();
+            } else if (arg == "--output-dir") {
+                output_dir = next();
+            } else if (arg == "--output") {
+                output = next();
+            } else if (arg == "--help") {
+                print_usage(argv[0]);
+                return 0;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (utils::Exception &e) {
+        std::cerr << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    utils::logger::set_log_level("LOG_NOTHING");
+
+    // Run the benchmark cases.
+    utils::Json results = utils::Json::array();
+    utils::UInt num_errors = 0;
+    for (const auto &platform : get_platforms()) {
+        if (platform.large && !large) continue;
+        for (const auto &program : get_programs(platform, scale, seed)) {
+            auto name = platform.name + "/" + program.name;
+            if (!filter.empty() && name.find(filter) == utils::Str::npos) continue;
+            if (list) {
+                std::cout << name << "\n";
+                continue;
+            }
+            for (utils::UInt rep = 0; rep < repeat; rep++) {
+                auto result = run_case(platform, config_dir, program, output_dir, arena);
+                result["repetition"] = rep;
+                if (!print_result(name, result)) num_errors++;
+                results.push_back(result);
+            }
+        }
+    }
+    if (filter.empty() || NAMES_CASE.find(filter) != utils::Str::npos) {
+        if (list) {
+            std::cout << NAMES_CASE << "\n";
+        } else {
+            for (utils::UInt rep = 0; rep < repeat; rep++) {
+                auto result = run_instruction_names(config_dir, 100 * scale);
+                result["repetition"] = rep;
+                if (!print_result(NAMES_CASE, result)) num_errors++;
+                results.push_back(result);
+            }
+        }
+    }
+    if (filter.empty() || ARENA_CASE.find(filter) != utils::Str::npos) {
+        if (list) {
+            std::cout << ARENA_CASE << "\n";
+        } else {
+            for (utils::UInt rep = 0; rep < repeat; rep++) {
+                auto result = run_ir_node_allocation(1000000 * scale);
+                result["repetition"] = rep;
+                if (!print_result(ARENA_CASE, result)) num_errors++;
+                results.push_back(result);
+            }
+        }
+    }
+    if (list) {
+        return 0;
+    }
+
+    // Write the JSON output.
+    utils::Json json;
+    json["openql_version"] = OPENQL_VERSION_STRING;
+    json["scale"] = scale;
+    json["seed"] = seed;
+    json["arena"] = arena;
+    json["results"] = results;
+    utils::OutFile(output) << json.dump(4) << "\n";
+
+    return num_errors ? 1 : 0;
+}
@@ -74,6 +74,15 @@ private:
         bool dummy
     );
 
+    /**
+     * Internal constructor to implement get_shared().
+     */
+    Platform(
+        const std::string &name,
+        const std::string &platform_config,
+        const ql::ir::compat::PlatformRef &platform
+    );
+
 public:
 
     /**
@@ -91,9 +100,11 @@ public:
      * Constructs a platform. name is any name the user wants to give to the
      * platform; it is only used for report messages. platform_config must be
      * a recognized architecture (variant) name, or must point to a JSON file
-     * that represents the platform directly. Optionally, compiler_config can be
-     * specified to override the compiler configuration specified by the
-     * platform (if any).
+     * that represents the platform directly or to a preprocessed
+     * configuration file written by save_preprocessed_config(). Optionally,
+     * compiler_config can be specified to override the compiler configuration
+     * specified by the platform (if any); this is not supported for
+     * preprocessed configurations.
      */
     Platform(
         const std::string &name,
@@ -127,6 +138,39 @@ public:
      */
     static std::string get_platform_json_string(const std::string &platform_config="none");
 
+    /**
+     * Returns a platform from the in-process platform registry, constructing
+     * it in the same way as the constructor with the same arguments if it is
+     * not registered yet. Platforms requested with the same arguments share
+     * the loaded platform data (including its conversion to the new IR), so
+     * this is much faster than constructing a new platform each time when
+     * many programs are compiled for the same platform. The configuration
+     * files are reread and the platform is rebuilt if they were modified.
+     */
+    static Platform get_shared(
+        const std::string &name,
+        const std::string &platform_config,
+        const std::string &compiler_config = ""
+    );
+
+    /**
+     * Removes all platforms from the in-process platform registry, such that
+     * subsequent calls to get_shared() construct them again. Existing
+     * platforms remain valid.
+     */
+    static void clear_shared();
+
+    /**
+     * Writes the preprocessed platform configuration to the given file, as a
+     * cache for loading the same platform again: passing its filename as
+     * platform_config to the constructor or to get_shared() skips JSON
+     * parsing, resolution of the compiler configuration, and
+     * architecture-specific preprocessing. Everything that is built from the
+     * configuration is still built as usual. The file can only be loaded by
+     * the version of OpenQL that wrote it.
+     */
+    void save_preprocessed_config(const std::string &filename) const;
+
     /**
      * Returns the number of qubits in the platform.
      */
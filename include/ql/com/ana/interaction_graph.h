@@ -0,0 +1,174 @@
+/** \file
+ * Sparse, weighted qubit interaction graph.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/map.h"
+#include "ql/ir/ir.h"
+#include "ql/com/ana/metrics.h"
+
+namespace ql {
+namespace com {
+namespace ana {
+
+/**
+ * Undirected, weighted graph with the qubits as vertices and an edge between
+ * each pair of qubits that interact, i.e. that are operands of the same
+ * multi-qubit gate, weighted by the number of such gates. Only pairs that
+ * actually interact are stored, so memory usage scales with the number of
+ * distinct interactions rather than with the square of the number of qubits.
+ * Operand order is not respected.
+ */
+class InteractionGraph {
+public:
+
+    /**
+     * Map from neighboring qubit index to edge weight.
+     */
+    using Neighbors = utils::Map<utils::UInt, utils::UInt>;
+
+    /**
+     * Dense matrix representation, as returned by get_dense_matrix().
+     */
+    using Matrix = utils::Vec<utils::Vec<utils::UInt>>;
+
+private:
+
+    /**
+     * Adjacency map for each qubit. This grows as needed when interactions are
+     * added.
+     */
+    utils::Vec<Neighbors> adjacency;
+
+    /**
+     * The number of distinct interacting qubit pairs.
+     */
+    utils::UInt num_edges = 0;
+
+    /**
+     * The sum of all edge weights.
+     */
+    utils::UInt total_weight = 0;
+
+public:
+
+    /**
+     * Constructs an empty interaction graph for the given number of qubits.
+     */
+    explicit InteractionGraph(utils::UInt num_qubits = 0);
+
+    /**
+     * Adds the given weight to the edge between qubits a and b. Interactions of
+     * a qubit with itself are ignored.
+     */
+    void add_interaction(utils::UInt a, utils::UInt b, utils::UInt weight = 1);
+
+    /**
+     * Adds an interaction between each pair of the given qubits, i.e. the
+     * interactions due to a single gate operating on these qubits.
+     */
+    void add_gate(const utils::Vec<utils::UInt> &qubits, utils::UInt weight = 1);
+
+    /**
+     * Adds all interactions of the given graph to this one.
+     */
+    void merge(const InteractionGraph &other);
+
+    /**
+     * Returns the number of qubits, i.e. one more than the highest qubit index
+     * that has been seen or the number of qubits passed to the constructor,
+     * whichever is larger.
+     */
+    utils::UInt get_num_qubits() const;
+
+    /**
+     * Returns the weight of the edge between qubits a and b, or 0 if they don't
+     * interact.
+     */
+    utils::UInt get_weight(utils::UInt a, utils::UInt b) const;
+
+    /**
+     * Returns the neighbors of the given qubit along with the edge weights.
+     */
+    const Neighbors &get_neighbors(utils::UInt qubit) const;
+
+    /**
+     * Returns the number of qubits that the given qubit interacts with.
+     */
+    utils::UInt get_degree(utils::UInt qubit) const;
+
+    /**
+     * Returns the sum of the weights of the edges of the given qubit.
+     */
+    utils::UInt get_weighted_degree(utils::UInt qubit) const;
+
+    /**
+     * Returns the number of distinct interacting qubit pairs.
+     */
+    utils::UInt get_num_edges() const;
+
+    /**
+     * Returns the sum of all edge weights.
+     */
+    utils::UInt get_total_weight() const;
+
+    /**
+     * Returns the interactions as a dense, symmetric matrix. Note that this
+     * requires memory quadratic in the number of qubits, so this should only
+     * be used when this is actually needed, for instance for writing the
+     * matrix to a file.
+     */
+    Matrix get_dense_matrix() const;
+
+    /**
+     * Returns the dense matrix as a human-readable string. Same caveats as for
+     * get_dense_matrix() apply.
+     */
+    utils::Str get_string() const;
+
+};
+
+/**
+ * A metric that constructs the interaction graph for all gates with exactly
+ * two qubit operands.
+ */
+class TwoQubitInteractions : public SimpleClassMetric<InteractionGraph> {
+public:
+    void process_instruction(
+        const ir::Ref &ir,
+        const ir::InstructionRef &instruction
+    ) override;
+    void merge(const MetricBase &other) override;
+};
+
+/**
+ * A metric that constructs the interaction graph for all gates with two or
+ * more qubit operands. Gates with more than two qubit operands contribute an
+ * interaction for each pair of qubit operands.
+ */
+class MultiQubitInteractions : public SimpleClassMetric<InteractionGraph> {
+public:
+    void process_instruction(
+        const ir::Ref &ir,
+        const ir::InstructionRef &instruction
+    ) override;
+    void merge(const MetricBase &other) override;
+};
+
+/**
+ * Returns the indices of the qubits referred to by the operands of the given
+ * instruction, in operand order. Only references to the main qubit register
+ * with a literal index are considered.
+ */
+utils::Vec<utils::UInt> get_qubit_operands(
+    const ir::Ref &ir,
+    const ir::InstructionRef &instruction
+);
+
+} // namespace ana
+} // namespace com
+} // namespace ql
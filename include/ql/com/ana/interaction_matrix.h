@@ -8,6 +8,7 @@
 #include "ql/utils/str.h"
 #include "ql/utils/vec.h"
 #include "ql/ir/compat/compat.h"
+#include "ql/com/ana/interaction_graph.h"
 
 namespace ql {
 namespace com {
@@ -17,8 +18,10 @@ namespace ana {
 //  as such sometime.
 
 /**
- * Utility for counting the number of two-qubit gates, grouped by their qubit
- * operands.
+ * Utility for counting the number of two-qubit gates in a kernel of the old
+ * IR, grouped by their qubit operands. This is a thin wrapper around
+ * InteractionGraph; new code operating on the new IR should use the
+ * TwoQubitInteractions or MultiQubitInteractions metrics instead.
  */
 class InteractionMatrix {
 private:
@@ -26,19 +29,13 @@ private:
     /**
      * Shorthand for the matrix type.
      */
-    using Matrix = utils::Vec<utils::Vec<utils::UInt>>;
+    using Matrix = InteractionGraph::Matrix;
 
     /**
-     * Size of the matrix, i.e. the number of qubits.
+     * Sparse graph representing the number of two-qubit gates spanning each
+     * pair of qubits. Operand order is not respected.
      */
-    const utils::UInt size;
-
-    /**
-     * Square matrix of unsigned integers, representing the number of two-qubit
-     * gates spanning the indexed qubits. Operand order is not respected; the
-     * matrix is symmetric.
-     */
-    Matrix matrix;
+    InteractionGraph graph;
 
 public:
 
@@ -48,9 +45,15 @@ public:
     InteractionMatrix(const ir::compat::KernelRef &kernel);
 
     /**
-     * Returns the embedded matrix.
+     * Returns the interaction graph.
+     */
+    const InteractionGraph &get_graph() const;
+
+    /**
+     * Returns the interactions as a dense matrix. This is constructed on
+     * request, as it requires memory quadratic in the number of qubits.
      */
-    const Matrix &get_matrix() const;
+    Matrix get_matrix() const;
 
     /**
      * Returns the matrix as a string.
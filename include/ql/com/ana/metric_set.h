@@ -0,0 +1,164 @@
+/** \file
+ * Engine for computing a set of metrics in a single traversal.
+ */
+
+#pragma once
+
+#include <functional>
+#include "ql/utils/num.h"
+#include "ql/utils/ptr.h"
+#include "ql/utils/vec.h"
+#include "ql/ir/ir.h"
+#include "ql/com/ana/metrics.h"
+
+namespace ql {
+namespace com {
+namespace ana {
+
+class MetricSet;
+
+/**
+ * Handle for a metric added to a MetricSet, used to retrieve its results.
+ */
+template <class M>
+class MetricHandle {
+private:
+    friend class MetricSet;
+
+    /**
+     * Index of the metric within the set.
+     */
+    utils::UInt index;
+
+    /**
+     * Constructs a handle for the metric with the given index.
+     */
+    explicit MetricHandle(utils::UInt index) : index(index) {}
+
+};
+
+/**
+ * A set of metrics that is computed in a single traversal of the IR. When
+ * computed for a program, the top-level blocks are processed in parallel, each
+ * with its own instances of the metrics. The results for the individual blocks
+ * remain available, and the program-wide results are obtained by merging them
+ * in program order, so all metrics in the set must support merging.
+ *
+ * Usage is for instance:
+ *
+ * ```
+ * MetricSet metrics;
+ * auto gates = metrics.add<QuantumGateCount>();
+ * auto latency = metrics.add<Latency>();
+ * metrics.compute_program(ir);
+ * metrics.get_program_result(gates);
+ * metrics.get_block_result(latency, 0);
+ * ```
+ */
+class MetricSet {
+private:
+
+    /**
+     * Function that constructs a new instance of a metric.
+     */
+    using Factory = std::function<utils::Ptr<MetricBase>()>;
+
+    /**
+     * Factories for the metrics in this set, in the order in which they were
+     * added.
+     */
+    utils::Vec<Factory> factories;
+
+    /**
+     * The metric instances used for each block, indexed by block and then by
+     * metric.
+     */
+    utils::Vec<utils::Vec<utils::Ptr<MetricBase>>> block_metrics;
+
+    /**
+     * The merged metric instances for the program, indexed by metric.
+     */
+    utils::Vec<utils::Ptr<MetricBase>> program_metrics;
+
+    /**
+     * Constructs a fresh instance of each metric in the set.
+     */
+    utils::Vec<utils::Ptr<MetricBase>> make_metrics() const;
+
+    /**
+     * Returns the metric instance for the given handle and block, throwing an
+     * exception if it has not been computed.
+     */
+    MetricBase &get_block_metric(utils::UInt index, utils::UInt block) const;
+
+    /**
+     * Returns the merged metric instance for the given handle, throwing an
+     * exception if it has not been computed.
+     */
+    MetricBase &get_program_metric(utils::UInt index) const;
+
+public:
+
+    /**
+     * Adds a metric of type M to the set. If multiply_static_loops is set, the
+     * statements in the body of static loops are weighted by the trip count of
+     * the loop (see MetricBase::set_multiply_static_loops()). The same metric
+     * type can be added more than once, for instance with and without this
+     * flag. Any previously computed results are discarded.
+     */
+    template <class M>
+    MetricHandle<M> add(utils::Bool multiply_static_loops = false) {
+        factories.push_back([multiply_static_loops]() {
+            utils::Ptr<MetricBase> metric;
+            metric.emplace<M>();
+            metric->set_multiply_static_loops(multiply_static_loops);
+            return metric;
+        });
+        block_metrics.clear();
+        program_metrics.clear();
+        return MetricHandle<M>(factories.size() - 1);
+    }
+
+    /**
+     * Computes all metrics for the given block. The results are available as
+     * block 0.
+     */
+    void compute_block(const ir::Ref &ir, const ir::BlockBaseRef &block);
+
+    /**
+     * Computes all metrics for each top-level block of the program in
+     * parallel, using at most num_threads threads (0 means the hardware
+     * concurrency), and merges the results into program-wide results.
+     */
+    void compute_program(const ir::Ref &ir, utils::UInt num_threads = 0);
+
+    /**
+     * Returns the number of blocks for which results are available.
+     */
+    utils::UInt get_num_blocks() const;
+
+    /**
+     * Returns the result of the given metric for the block with the given
+     * index.
+     */
+    template <class M>
+    typename M::ReturnType get_block_result(
+        const MetricHandle<M> &handle,
+        utils::UInt block = 0
+    ) const {
+        return dynamic_cast<M&>(get_block_metric(handle.index, block)).get_result();
+    }
+
+    /**
+     * Returns the program-wide result of the given metric.
+     */
+    template <class M>
+    typename M::ReturnType get_program_result(const MetricHandle<M> &handle) const {
+        return dynamic_cast<M&>(get_program_metric(handle.index)).get_result();
+    }
+
+};
+
+} // namespace ana
+} // namespace com
+} // namespace ql
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "ql/utils/num.h"
+#include "ql/utils/vec.h"
 #include "ql/utils/map.h"
 #include "ql/utils/exception.h"
 #include "ql/ir/ir.h"
@@ -17,16 +18,60 @@ namespace com {
 namespace ana {
 
 /**
- * Base class for a metric. T is the type returned when the metric is computed.
+ * Base class for all metrics, independent of the type of their result.
+ *
+ * Metrics are computed by traversing the IR tree and calling the hooks of the
+ * metric (enter_block(), enter_statement(), and process_instruction()) for
+ * each node encountered. The traversal itself is not customizable, such that
+ * any number of metrics can be computed in a single traversal (see MetricSet).
  */
-template <typename T>
-class Metric {
-public:
+class MetricBase {
+protected:
 
     /**
-     * The type returned by get_result().
+     * The number of times the statement currently being processed is executed
+     * for each execution of the block or program that the metric is being
+     * computed for. This is always 1 unless static loop multiplication is
+     * enabled (see set_multiply_static_loops()), in which case it is the
+     * product of the trip counts of the static loops that the statement is
+     * nested in. Counting metrics should add this rather than 1.
      */
-    using ReturnType = T;
+    utils::UInt weight = 1;
+
+    /**
+     * The nesting depth of the block currently being processed, where 0 is the
+     * block (or the top-level blocks of the program) that the metric is being
+     * computed for.
+     */
+    utils::UInt depth = 0;
+
+    /**
+     * Whether statements in static loops are weighted by the trip counts of
+     * the loops.
+     */
+    utils::Bool multiply_static_loops = false;
+
+    /**
+     * Called for each block before its statements are processed. Default
+     * implementation is no-op.
+     */
+    virtual void enter_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block
+    );
+
+    /**
+     * Called for each statement before the statements in its sub-blocks (if
+     * any) are processed. Default implementation calls process_instruction()
+     * for instructions, including the initialize and update instructions of
+     * for loops.
+     */
+    virtual void enter_statement(
+        const ir::Ref &ir,
+        const ir::StatementRef &statement
+    );
+
+public:
 
     /**
      * Updates the metric using the given instruction. Default implementation
@@ -35,77 +80,87 @@ public:
     virtual void process_instruction(
         const ir::Ref &ir,
         const ir::InstructionRef &instruction
-    ) {
-        throw utils::Exception("metric is not implemented for instructions");
-    }
+    );
+
+    /**
+     * Virtual destructor.
+     */
+    virtual ~MetricBase() = default;
 
     /**
-     * Updates the metric using the given statement. Default implementation
-     * recurses into sub-blocks and calls process_instruction for all
-     * instructions encountered.
+     * Sets whether the statements in the body of static loops should be
+     * weighted by the trip count of the loop, so the metric reflects the work
+     * actually executed rather than the size of the code. Disabled by default.
      */
-    virtual void process_statement(
+    void set_multiply_static_loops(utils::Bool enable);
+
+    /**
+     * Updates the metric using the given statement, recursing into sub-blocks.
+     */
+    void process_statement(
         const ir::Ref &ir,
         const ir::StatementRef &statement
-    ) {
-        if (statement->as_instruction()) {
-            process_instruction(ir, statement.as<ir::Instruction>());
-        } else if (auto if_else = statement->as_if_else()) {
-            for (const auto &branch : if_else->branches) {
-                process_block(ir, branch->body);
-            }
-            if (!if_else->otherwise.empty()) {
-                process_block(ir, if_else->otherwise);
-            }
-        } else if (auto static_loop = statement->as_static_loop()) {
-            process_block(ir, static_loop->body);
-        } else if (auto for_loop = statement->as_for_loop()) {
-            if (!for_loop->initialize.empty()) {
-                process_instruction(ir, for_loop->initialize);
-            }
-            if (!for_loop->update.empty()) {
-                process_instruction(ir, for_loop->update);
-            }
-            process_block(ir, for_loop->body);
-        } else if (auto repeat_until = statement->as_repeat_until_loop()) {
-            process_block(ir, repeat_until->body);
-        } else if (statement->as_loop_control_statement()) {
-            // no-op.
-        } else {
-            QL_ASSERT(false);
-        }
-    }
+    );
 
     /**
-     * Updates the metric using the given block. Default implementation just
-     * calls process_statement() for each contained statement.
+     * Updates the metric using the given block, recursing into sub-blocks.
      */
-    virtual void process_block(
+    void process_block(
         const ir::Ref &ir,
         const ir::BlockBaseRef &block
-    ) {
-        for (const auto &statement : block->statements) {
-            process_statement(ir, statement);
-        }
-    }
+    );
 
     /**
-     * Updates the metric using the given program. Default implementation just
-     * calls process_block() for each contained block.
+     * Updates the metric using all blocks of the given program.
      */
-    virtual void process_program(
+    void process_program(
         const ir::Ref &ir,
         const ir::ProgramRef &program
-    ) {
-        for (const auto &block : program->blocks) {
-            process_block(ir, block);
-        }
-    }
+    );
 
     /**
-     * Virtual destructor.
+     * Merges the result of the given metric, which must be of the same type
+     * and computed for a different block of the same program, into this one,
+     * such that the result is as if both blocks were processed by this metric.
+     * Default implementation throws an unimplemented exception. Metrics must
+     * override this according to how their results combine;
+     * SimpleValueMetric adds them.
      */
-    virtual ~Metric() = default;
+    virtual void merge(const MetricBase &other);
+
+    /**
+     * Processes the given statement for all the given metrics in a single
+     * traversal.
+     */
+    static void process_statement(
+        const utils::Vec<MetricBase*> &metrics,
+        const ir::Ref &ir,
+        const ir::StatementRef &statement
+    );
+
+    /**
+     * Processes the given block for all the given metrics in a single
+     * traversal.
+     */
+    static void process_block(
+        const utils::Vec<MetricBase*> &metrics,
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block
+    );
+
+};
+
+/**
+ * Base class for a metric. T is the type returned when the metric is computed.
+ */
+template <typename T>
+class Metric : public MetricBase {
+public:
+
+    /**
+     * The type returned by get_result().
+     */
+    using ReturnType = T;
 
     /**
      * Returns the results gathered thus far.
@@ -154,7 +209,10 @@ typename M::ReturnType compute_program(const ir::Ref &ir) {
 
 /**
  * A metric that just returns a simple C++ primitive value with the given
- * initial value.
+ * initial value. The value must be additive over blocks, as it is merged by
+ * addition; metrics for which this is not the case (for instance a maximum)
+ * must override merge(). All metrics derived from this in this file are
+ * additive.
  */
 template <typename T, T INITIAL_VALUE>
 class SimpleValueMetric : public Metric<T> {
@@ -174,6 +232,14 @@ public:
         return value;
     }
 
+    /**
+     * Merges by adding the values together. Override this for values that are
+     * not additive.
+     */
+    void merge(const MetricBase &other) override {
+        value += dynamic_cast<const SimpleValueMetric&>(other).value;
+    }
+
 };
 
 /**
@@ -200,6 +266,18 @@ public:
 
 };
 
+/**
+ * A metric that counts the number of statements, including structured
+ * control-flow statements and the statements in their sub-blocks.
+ */
+class StatementCount : public SimpleValueMetric<utils::UInt, 0> {
+protected:
+    void enter_statement(
+        const ir::Ref &ir,
+        const ir::StatementRef &statement
+    ) override;
+};
+
 /**
  * A metric that counts the number of classical operations.
  */
@@ -242,6 +320,7 @@ public:
         const ir::Ref &ir,
         const ir::InstructionRef &instruction
     ) override;
+    void merge(const MetricBase &other) override;
 };
 
 /**
@@ -253,17 +332,26 @@ public:
         const ir::Ref &ir,
         const ir::InstructionRef &instruction
     ) override;
+    void merge(const MetricBase &other) override;
 };
 
 /**
- * A metric that returns the duration of a scheduled block in cycles.
+ * A metric that returns the duration of a scheduled block in cycles, or the
+ * sum of the durations of the blocks of a program. Structured control-flow
+ * statements count as zero cycles, unless static loops are multiplied, in
+ * which case the duration of the body of each static loop is added once for
+ * each iteration.
  */
 class Latency : public SimpleValueMetric<utils::UInt, 0> {
-public:
-    void process_block(
+protected:
+    void enter_block(
         const ir::Ref &ir,
         const ir::BlockBaseRef &block
     ) override;
+    void enter_statement(
+        const ir::Ref &ir,
+        const ir::StatementRef &statement
+    ) override;
 };
 
 } // namespace ana
@@ -421,6 +421,20 @@ struct Graph {
      */
     utils::Int direction;
 
+    /**
+     * Whether COMMUTE_* operand access modes were respected for multi-qubit
+     * gates when the graph was built. Incremental updates (see update.h) use
+     * the same setting for the statements they (re)evaluate.
+     */
+    utils::Bool commute_multi_qubit;
+
+    /**
+     * Whether COMMUTE_* operand access modes were respected for single-qubit
+     * gates when the graph was built. Incremental updates (see update.h) use
+     * the same setting for the statements they (re)evaluate.
+     */
+    utils::Bool commute_single_qubit;
+
 };
 
 } // namespace ddg
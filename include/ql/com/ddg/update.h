@@ -0,0 +1,64 @@
+/** \file
+ * Defines functions for incrementally updating the data dependency graph of a
+ * block when statements are inserted, removed, or replaced.
+ */
+
+#pragma once
+
+#include "ql/com/ddg/types.h"
+
+namespace ql {
+namespace com {
+namespace ddg {
+
+/**
+ * Inserts the given statement into the given block at the given index, and
+ * adds it to the block's data dependency graph. Only the statements around
+ * the insertion point that access the objects accessed by the new statement
+ * are considered: the block is scanned backward and forward from the index
+ * until each object access of the new statement is ordered by an edge with a
+ * statement whose access to a superset of the object does not commute with
+ * it, or until the source or sink is reached.
+ *
+ * The graph must have been constructed using build() and must not be reversed.
+ * The resulting graph respects all data dependencies, but it may contain more
+ * edges than a graph built from scratch, as edges made redundant by the new
+ * statement are not removed.
+ */
+void insert_statement(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    utils::UInt index,
+    const ir::StatementRef &statement
+);
+
+/**
+ * Removes the statement at the given index from the given block and from the
+ * block's data dependency graph. The dependencies that ran through the removed
+ * statement are preserved by connecting its predecessors to its successors
+ * where the causes of the respective edges refer to overlapping objects.
+ *
+ * The graph must have been constructed using build() and must not be reversed.
+ * The resulting graph respects all data dependencies, but it may be more
+ * conservative than a graph built from scratch.
+ */
+void remove_statement(
+    const ir::BlockBaseRef &block,
+    utils::UInt index
+);
+
+/**
+ * Replaces the statement at the given index of the given block with the given
+ * statement, updating the block's data dependency graph accordingly. This is
+ * equivalent to remove_statement() followed by insert_statement().
+ */
+void replace_statement(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    utils::UInt index,
+    const ir::StatementRef &statement
+);
+
+} // namespace ddg
+} // namespace com
+} // namespace ql
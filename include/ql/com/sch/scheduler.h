@@ -7,6 +7,8 @@
 
 #include "ql/utils/num.h"
 #include "ql/utils/opt.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/list.h"
 #include "ql/ir/ir.h"
 #include "ql/ir/describe.h"
 #include "ql/com/ddg/ops.h"
@@ -320,10 +322,16 @@ public:
      * decreasing criticality.
      */
     utils::List<ir::StatementRef> get_available() const {
-        utils::List<ir::StatementRef> result;
+        utils::Vec<ir::StatementRef> candidates;
+        candidates.reserve(available.size());
         for (const auto &statement : available) {
-            if (resource_state->available(cycle, statement)) {
-                result.push_back(statement);
+            candidates.push_back(statement);
+        }
+        auto mask = resource_state->available_batch(cycle, candidates);
+        utils::List<ir::StatementRef> result;
+        for (utils::UInt i = 0; i < candidates.size(); i++) {
+            if (mask[i]) {
+                result.push_back(candidates[i]);
             }
         }
         return result;
@@ -345,10 +353,24 @@ public:
             // Try to schedule statements that are available w.r.t. data
             // dependencies. Note that the iteration order here is implicitly by
             // decreasing criticality, because available is a set that uses the
-            // criticality heuristic for its comparator.
-            for (const auto &statement : available) {
-                if (try_schedule(statement)) {
-                    return true;
+            // criticality heuristic for its comparator. The resources are
+            // checked for small batches of statements at a time, which is
+            // cheaper than checking them one by one, without spending too much
+            // time on less critical statements when a more critical one fits.
+            const utils::UInt BATCH_SIZE = 16;
+            utils::Vec<ir::StatementRef> batch;
+            auto it = available.begin();
+            while (it != available.end()) {
+                batch.clear();
+                while (it != available.end() && batch.size() < BATCH_SIZE) {
+                    batch.push_back(*it);
+                    ++it;
+                }
+                auto mask = resource_state->available_batch(cycle, batch);
+                for (utils::UInt i = 0; i < batch.size(); i++) {
+                    if (mask[i]) {
+                        return try_schedule(batch[i]);
+                    }
                 }
             }
             return false;
@@ -0,0 +1,70 @@
+/** \file
+ * Hand-written tokenizer for the instruction names and decomposition keys used
+ * in platform configuration files, and for other names coming from the old IR.
+ *
+ * These replace the std::regex-based "sanitization" rules that were used
+ * before, which were rather slow for large platform files. The behavior is
+ * identical to those rules; the equivalent regular expressions are documented
+ * for each function.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/list.h"
+
+namespace ql {
+namespace ir {
+namespace compat {
+
+/**
+ * Returns whether the given character is whitespace, i.e. matches \s.
+ */
+utils::Bool is_name_space(char c);
+
+/**
+ * Normalizes an instruction name or decomposition key from a platform
+ * configuration file, i.e. the key format used for the instruction map of the
+ * old platform. The name is converted to lower case, leading and trailing
+ * whitespace is removed, sequences of whitespace are collapsed to a single
+ * space, and whitespace around commas is removed. This is equivalent to
+ * applying the replacements `^\s+|\s+$` -> ``, `\s+` -> ` `, and `\s*,\s*` ->
+ * `,` in that order. For example, `" CZ  q0 , q1 "` becomes `"cz q0,q1"`.
+ */
+utils::Str normalize_instruction_name(const utils::Str &name);
+
+/**
+ * Splits an instruction name or decomposition key from a platform
+ * configuration file into the instruction name followed by its
+ * specialization/decomposition template parameters. The name is converted to
+ * lower case, leading and trailing whitespace is ignored, and the parts are
+ * separated by any sequence of whitespace and commas. This is equivalent to
+ * applying the replacements `^\s+|\s+$` -> `` and `[\s,]+` -> ` ` and then
+ * splitting on spaces. The result always contains at least one element.
+ */
+utils::List<utils::Str> split_instruction_name(const utils::Str &name);
+
+/**
+ * Returns whether the given instruction parameter is a register reference of
+ * the form `[qbc][0-9]+`.
+ */
+utils::Bool is_register_operand(const utils::Str &operand);
+
+/**
+ * Returns whether the given string is a valid identifier for the new IR, i.e.
+ * whether it matches `[a-zA-Z_][a-zA-Z0-9_]*`.
+ */
+utils::Bool is_identifier(const utils::Str &str);
+
+/**
+ * Turns an arbitrary string into a valid identifier for the new IR by
+ * replacing all characters other than `[a-zA-Z0-9_]` with underscores, and
+ * prefixing an underscore if the result would otherwise be empty or start with
+ * a digit.
+ */
+utils::Str make_identifier(const utils::Str &str);
+
+} // namespace compat
+} // namespace ir
+} // namespace ql
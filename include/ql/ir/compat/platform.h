@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <unordered_map>
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/opt.h"
+#include "ql/utils/map.h"
 #include "ql/utils/json.h"
 #include "ql/utils/tree.h"
 #include "ql/ir/compat/gate.h"
@@ -148,6 +150,23 @@ public:
      */
     utils::Json platform_config;
 
+    /**
+     * The name of the JSON file that the platform configuration was loaded
+     * from, or empty if it was built from an architecture name or from JSON
+     * data. Platforms loaded from a preprocessed configuration file take this
+     * from the platform they were saved from.
+     */
+    utils::Str platform_config_fname;
+
+    /**
+     * Hash of the dump of platform_config, computed once after loading, as
+     * platform_config is not modified afterwards. Used to identify the
+     * configuration cheaply, such as when checking whether the new-IR
+     * conversion of the platform cached by convert_old_to_new() still
+     * applies.
+     */
+    std::size_t platform_config_hash = 0;
+
 public:
 
     /**
@@ -157,6 +176,43 @@ public:
 
 private:
 
+    /**
+     * Entry of the custom gate index, for a single gate name.
+     */
+    struct CustomGateIndexEntry {
+
+        /**
+         * The instruction_map entry with exactly this name, if any.
+         */
+        utils::Maybe<gate_types::Custom> generic;
+
+        /**
+         * The instruction_map entries specialized for specific qubits, i.e.
+         * of the form "<name> q<i>,q<j>,...", keyed by the qubit indices.
+         */
+        utils::Map<utils::Vec<utils::UInt>, utils::Maybe<gate_types::Custom>> specialized;
+
+    };
+
+    /**
+     * Index over instruction_map, used by find_custom_gate() to resolve gates
+     * without formatting a canonical instruction name for every gate. Built by
+     * build_custom_gate_index() after loading.
+     */
+    std::unordered_map<utils::Str, CustomGateIndexEntry> custom_gate_index;
+
+    /**
+     * The size of instruction_map when custom_gate_index was built. If the map
+     * no longer has this size, the index is considered to be stale, and
+     * find_custom_gate() falls back to string lookups.
+     */
+    utils::UInt custom_gate_index_size = 0;
+
+    /**
+     * (Re)builds custom_gate_index from instruction_map.
+     */
+    void build_custom_gate_index();
+
     /**
      * Loads the platform members from the given JSON data and optional
      * auxiliary compiler configuration file.
@@ -167,6 +223,19 @@ private:
         const utils::Str &compiler_config = ""
     );
 
+    /**
+     * Loads the platform members from platform_config, after the architecture
+     * and compiler settings have been determined and platform_config has been
+     * preprocessed by the architecture.
+     */
+    void load_preprocessed();
+
+    /**
+     * Loads the platform members from the preprocessed platform configuration
+     * file with the given name, as written by save_preprocessed_config().
+     */
+    void load_preprocessed_config(const utils::Str &fname);
+
     /**
      * Constructs a platform from the given configuration filename.
      */
@@ -205,6 +274,47 @@ public:
         const utils::Str &compiler_config = ""
     );
 
+    /**
+     * Returns whether the given file is a preprocessed platform configuration
+     * file, as written by save_preprocessed_config(). Such files can be used
+     * in place of a platform configuration filename.
+     */
+    static utils::Bool is_preprocessed_config(const utils::Str &fname);
+
+    /**
+     * Writes the preprocessed platform configuration to the given file, as a
+     * cache for loading the same platform again. The file is a binary (CBOR)
+     * encoding of the platform configuration after compiler configuration
+     * files have been resolved and architecture-specific preprocessing has
+     * been applied. Loading it only skips JSON parsing, resolution of the
+     * compiler configuration, and preprocessing; everything that is built
+     * from the configuration (instruction map, topology, resources, and the
+     * conversion to the new IR) is still built as usual. Such files can only
+     * be loaded by the same version of OpenQL that wrote them.
+     */
+    void save_preprocessed_config(const utils::Str &fname) const;
+
+    /**
+     * Returns the platform for the given configuration from the in-process
+     * platform registry, building and registering it if it is not there yet.
+     * The same platform instance (and the cached template for its conversion
+     * to the new IR) is thus shared by everything that requests the same
+     * configuration, rather than being loaded again each time. The configuration files are reread to
+     * detect changes, in which case the platform is rebuilt; files included by
+     * the platform configuration file are not checked.
+     */
+    static PlatformRef get_shared(
+        const utils::Str &name,
+        const utils::Str &platform_config,
+        const utils::Str &compiler_config = ""
+    );
+
+    /**
+     * Removes all platforms from the in-process platform registry. Platforms
+     * that are still in use elsewhere remain valid.
+     */
+    static void clear_shared();
+
     /**
      * Dumps some basic info about the platform to the given stream.
      */
@@ -219,6 +329,17 @@ public:
      */
     const utils::Json &find_instruction(const utils::Str &iname) const;
 
+    /**
+     * Returns the custom gate template for a gate with the given name and
+     * qubit operands, or an empty reference if there is none. A specialized
+     * instruction (e.g. "cz q0,q3") takes precedence over the generic one
+     * (e.g. "cz").
+     */
+    utils::Maybe<gate_types::Custom> find_custom_gate(
+        const utils::Str &name,
+        const utils::Vec<utils::UInt> &qubits
+    ) const;
+
     /**
      * Returns the JSON data for all instructions as a JSON map.
      *
@@ -4,18 +4,69 @@
 
 #pragma once
 
+#include "ql/utils/vec.h"
 #include "ql/ir/ir.h"
 
 namespace ql {
 namespace ir {
 
+/**
+ * The amount of checking done by check_consistency().
+ */
+enum class ConsistencyCheckLevel {
+
+    /**
+     * No checks are done at all.
+     */
+    OFF,
+
+    /**
+     * Only the checks that don't require a traversal of the statements and
+     * expressions in the tree are done, i.e. the platform-level ordering and
+     * presence constraints, block name uniqueness, and entry point validity.
+     */
+    CHEAP,
+
+    /**
+     * Everything is checked, including tree well-formedness and the types and
+     * prototypes of all statements and expressions. The blocks of the program
+     * are checked in parallel if the `num_threads` global option allows it.
+     */
+    FULL
+
+};
+
+/**
+ * Returns the consistency check level selected via the `consistency_checks`
+ * global option.
+ */
+ConsistencyCheckLevel get_consistency_check_level();
+
 /**
  * Performs a consistency check of the IR. An exception is thrown if a problem
  * is found. The constraints checked by this must be met on any interface that
  * passes an IR reference, although actually checking it on every interface
- * might be detrimental for performance.
+ * might be detrimental for performance. The amount of checking is controlled
+ * by the `consistency_checks` global option.
  */
 void check_consistency(const Ref &ir);
 
+/**
+ * Same as check_consistency(const Ref&), but using the given check level
+ * rather than the one selected via the global option.
+ */
+void check_consistency(const Ref &ir, ConsistencyCheckLevel level);
+
+/**
+ * Incremental version of check_consistency(), for use after a transformation
+ * that only modified the given blocks of the program. The contents of all
+ * other blocks are assumed to still be consistent, so the statements and
+ * expressions within them are not traversed. The platform, the program-level
+ * constraints, and (for the full check) the well-formedness of the complete
+ * tree are still checked. The amount of checking is controlled by the
+ * `consistency_checks` global option.
+ */
+void check_consistency(const Ref &ir, const utils::Vec<BlockRef> &modified_blocks);
+
 } // namespace ir
 } // namespace ql
@@ -18,5 +18,12 @@ namespace ir {
  */
 compat::ProgramRef convert_new_to_old(const Ref &ir);
 
+/**
+ * Returns the number of times a program has been converted from the new to the
+ * old IR using convert_new_to_old() thus far. Used for profiling the overhead
+ * of legacy passes.
+ */
+utils::UInt get_num_new_to_old_conversions();
+
 } // namespace ir
 } // namespace ql
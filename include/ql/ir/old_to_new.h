@@ -73,10 +73,24 @@ struct PrototypeInferred {};
 /**
  * Converts the old platform to the new IR structure.
  *
+ * The conversion is expensive, because the legacy decomposition rules are
+ * parsed using the cQASM reader. Therefore, the converted platform is cached
+ * as a template via an annotation on the old platform, keyed on a hash of the
+ * preprocessed platform configuration and the members of the old platform that
+ * can still change. Each returned root gets its own copy of the template (see
+ * clone_platform()) with its own resource manager, so instruction overloads
+ * and annotations added while compiling one program do not affect others.
+ *
  * See convert_old_to_new(const compat::ProgramRef&) for details.
  */
 Ref convert_old_to_new(const compat::PlatformRef &old);
 
+/**
+ * Returns the number of times an old platform has actually been converted to
+ * the new IR thus far, as opposed to having been taken from the cache.
+ */
+utils::UInt get_num_old_to_new_platform_conversions();
+
 /**
  * Converts the old IR (program and platform) to the new one.
  *
@@ -320,5 +334,12 @@ Ref convert_old_to_new(const compat::PlatformRef &old);
  */
 Ref convert_old_to_new(const compat::ProgramRef &old);
 
+/**
+ * Returns the number of times a program has been converted from the old to the
+ * new IR using convert_old_to_new() thus far. Used for profiling the overhead
+ * of legacy passes.
+ */
+utils::UInt get_num_old_to_new_conversions();
+
 } // namespace ir
 } // namespace ql
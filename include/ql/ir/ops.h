@@ -115,6 +115,33 @@ InstructionTypeLink find_instruction_type(
     utils::Bool generate_overload_if_needed = false
 );
 
+/**
+ * Builds the lookup indices for the instruction types of the given IR's
+ * platform and their specializations, if they don't exist or are out of date.
+ * The indices are otherwise built lazily on first use; building them up front
+ * avoids serializing the first lookups of threads that use the platform
+ * concurrently.
+ */
+void build_instruction_type_indices(const Ref &ir);
+
+/**
+ * Invalidates the lookup indices for the instruction types of the given IR's
+ * platform and their specializations. This must be called after modifying the
+ * instruction type list or a specialization list of the platform by any means
+ * other than add_instruction_type(), find_instruction_type(), and
+ * make_instruction().
+ */
+void invalidate_instruction_type_indices(const Ref &ir);
+
+/**
+ * Returns a deep copy of the given platform. Unlike clone(), links within the
+ * platform refer to the copied nodes rather than to the original ones, and the
+ * annotations of all nodes are copied along, except for the instruction type
+ * lookup indices. The resource manager is shared with the original, so it
+ * still refers to the IR it was built for.
+ */
+utils::One<Platform> clone_platform(const utils::One<Platform> &platform);
+
 /**
  * Builds a new instruction node based on the given name and operand list. Its
  * behavior depends on name.
@@ -18,6 +18,7 @@
 #include "ql/ir/ir.h"
 #include "ql/pmgr/declarations.h"
 #include "ql/pmgr/pass_types/base.h"
+#include "ql/pmgr/profile.h"
 #include "ql/pmgr/factory.h"
 
 namespace ql {
@@ -311,6 +312,13 @@ public:
      */
     void compile(const ir::Ref &ir);
 
+    /**
+     * Like compile(), but records profiling information for all passes in the
+     * given profiler, regardless of the profile_passes option. No profiling
+     * output files are written.
+     */
+    void compile(const ir::Ref &ir, const profile::Ref &profiler);
+
 };
 
 /**
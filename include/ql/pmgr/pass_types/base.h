@@ -14,6 +14,7 @@
 #include "ql/ir/ir.h"
 #include "ql/pmgr/declarations.h"
 #include "ql/pmgr/condition.h"
+#include "ql/pmgr/profile.h"
 
 namespace ql {
 namespace pmgr {
@@ -586,30 +587,39 @@ private:
 
     /**
      * Wrapper around running the main pass implementation for this pass, taking
-     * care of logging, profiling, etc.
+     * care of logging, profiling, etc. iteration is the loop iteration index
+     * for looping pass groups, used only for profiling.
      */
     utils::Int run_main_pass(
         const ir::Ref &ir,
-        const Context &context
+        const Context &context,
+        const profile::Ref &profiler,
+        utils::UInt iteration = 0
     ) const;
 
     /**
      * Wrapper around running the sub-passes for this pass, taking care of logging,
-     * profiling, etc.
+     * profiling, etc. iteration is the loop iteration index for looping pass
+     * groups, used only for profiling.
      */
     void run_sub_passes(
         const ir::Ref &ir,
-        const Context &context
+        const Context &context,
+        const profile::Ref &profiler,
+        utils::UInt iteration = 0
     ) const;
 
 public:
 
     /**
-     * Executes this pass or pass group on the given program.
+     * Executes this pass or pass group on the given program. If a profiler is
+     * specified, profiling records are added to it for this pass and all its
+     * sub-passes.
      */
     void compile(
         const ir::Ref &ir,
-        const utils::Str &pass_name_prefix = ""
+        const utils::Str &pass_name_prefix = "",
+        const profile::Ref &profiler = {}
     );
 
 };
@@ -0,0 +1,199 @@
+/** \file
+ * Contains the profiler that the pass management logic uses to measure the
+ * time and memory spent on each pass.
+ */
+
+#pragma once
+
+#include <iostream>
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/ptr.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/json.h"
+#include "ql/utils/profile.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace pmgr {
+namespace profile {
+
+/**
+ * The kind of pass tree traversal that a profiling record was made for.
+ */
+enum class RecordKind {
+
+    /**
+     * Complete execution of a pass or group of passes via compile(), including
+     * any debugging output.
+     */
+    PASS,
+
+    /**
+     * Execution of the main (condition) function of a conditional pass group.
+     * For looping groups there is one such record per loop iteration.
+     */
+    CONDITION,
+
+    /**
+     * A single iteration of the sub-passes of a GROUP_WHILE or
+     * GROUP_REPEAT_UNTIL_NOT pass group.
+     */
+    ITERATION
+
+};
+
+/**
+ * String conversion for RecordKind.
+ */
+std::ostream &operator<<(std::ostream &os, RecordKind kind);
+
+/**
+ * Profiling information for a single traversal of a node in the pass tree.
+ */
+struct Record {
+
+    /**
+     * The fully-qualified name of the pass, or an empty string for the root.
+     */
+    utils::Str name;
+
+    /**
+     * The type name of the pass, or an empty string for generic groups.
+     */
+    utils::Str type;
+
+    /**
+     * What kind of traversal this record describes.
+     */
+    RecordKind kind;
+
+    /**
+     * The loop iteration index for ITERATION and CONDITION records, starting
+     * from zero. Always zero for PASS records.
+     */
+    utils::UInt iteration;
+
+    /**
+     * Index of the enclosing record in the record list, or utils::UMAX for the
+     * outermost record.
+     */
+    utils::UInt parent;
+
+    /**
+     * Nesting depth of this record; zero for the outermost record.
+     */
+    utils::UInt depth;
+
+    /**
+     * Resource usage counters at the start of this record.
+     */
+    utils::ResourceUsage start;
+
+    /**
+     * Resources used from start to end of this record.
+     */
+    utils::ResourceUsage usage;
+
+    /**
+     * Number of statements in the program before the traversal.
+     */
+    utils::UInt statements_in;
+
+    /**
+     * Number of statements in the program after the traversal.
+     */
+    utils::UInt statements_out;
+
+    /**
+     * Number of old <-> new IR conversions performed during the traversal.
+     */
+    utils::UInt ir_conversions;
+
+};
+
+/**
+ * Collects profiling records for a single run of the pass manager.
+ */
+class Profiler {
+private:
+
+    /**
+     * The records collected thus far, in the order in which they were
+     * started.
+     */
+    utils::Vec<Record> records;
+
+    /**
+     * Stack of record indices that have been started but not yet ended.
+     */
+    utils::Vec<utils::UInt> stack;
+
+    /**
+     * Returns the total number of IR conversions performed thus far.
+     */
+    static utils::UInt get_num_ir_conversions();
+
+    /**
+     * Returns the number of statements in the given IR's program, or 0 if it
+     * has no program.
+     */
+    static utils::UInt get_num_statements(const ir::Ref &ir);
+
+public:
+
+    /**
+     * Starts a new record nested within the innermost record that has not yet
+     * been ended. Returns the index of the new record, to be passed to end().
+     */
+    utils::UInt begin(
+        const ir::Ref &ir,
+        const utils::Str &name,
+        const utils::Str &type,
+        RecordKind kind,
+        utils::UInt iteration = 0
+    );
+
+    /**
+     * Ends the record with the given index, which must be the innermost record
+     * that has not been ended yet.
+     */
+    void end(const ir::Ref &ir, utils::UInt index);
+
+    /**
+     * Returns the records collected thus far.
+     */
+    const utils::Vec<Record> &get_records() const;
+
+    /**
+     * Returns the collected records as a JSON object, for machine-readable
+     * processing.
+     */
+    utils::Json to_json() const;
+
+    /**
+     * Returns the collected records as a JSON object in the Chrome trace-event
+     * format, which can be loaded in chrome://tracing, Perfetto, or
+     * speedscope.
+     */
+    utils::Json to_trace_json() const;
+
+    /**
+     * Dumps a human-readable summary of the collected records to the given
+     * stream.
+     */
+    void dump_summary(
+        std::ostream &os = std::cout,
+        const utils::Str &line_prefix = ""
+    ) const;
+
+};
+
+/**
+ * Shared reference to a profiler.
+ */
+using Ref = utils::Ptr<Profiler>;
+
+} // namespace profile
+} // namespace pmgr
+} // namespace ql
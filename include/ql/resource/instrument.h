@@ -6,6 +6,7 @@
 #pragma once
 
 #include "ql/utils/set.h"
+#include "ql/utils/pair.h"
 #include "ql/utils/rangemap.h"
 #include "ql/rmgr/resource_types/base.h"
 
@@ -34,6 +35,21 @@ private:
      */
     utils::Vec<State> state;
 
+    /**
+     * Log of the reservation state of each instrument before it was modified
+     * since the oldest active checkpoint, used to roll back. When there is a
+     * defined scheduling direction, reservations before (or after) the most
+     * recent one are discarded, so these states remain small. Nothing is
+     * logged if there are no active checkpoints.
+     */
+    utils::Vec<utils::Pair<utils::UInt, State>> undo_log;
+
+    /**
+     * The size of the undo log at each active checkpoint, from oldest to
+     * newest.
+     */
+    utils::Vec<utils::UInt> checkpoints;
+
     /**
      * Shared pointer to the configuration structure.
      */
@@ -55,6 +71,21 @@ protected:
         utils::Bool commit
     ) override;
 
+    /**
+     * Starts a checkpoint for the reservation state.
+     */
+    utils::Bool on_checkpoint() override;
+
+    /**
+     * Rolls back to the most recent checkpoint.
+     */
+    void on_rollback() override;
+
+    /**
+     * Removes the most recent checkpoint, keeping the reservations.
+     */
+    void on_commit() override;
+
     /**
      * Dumps documentation for this resource.
      */
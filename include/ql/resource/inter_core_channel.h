@@ -5,18 +5,13 @@
 
 #pragma once
 
-#include "ql/utils/rangemap.h"
+#include "ql/resource/reservations.h"
 #include "ql/rmgr/resource_types/base.h"
 
 namespace ql {
 namespace resource {
 namespace inter_core_channel {
 
-/**
- * State per qubit.
- */
-using State = utils::RangeSet<utils::Int>;
-
 /**
  * Forward-declaration for the configuration structure, defined in the CC file.
  */
@@ -30,9 +25,22 @@ class InterCoreChannelResource : public rmgr::resource_types::Base {
 private:
 
     /**
-     * The reservations for each [core][channel].
+     * The reservations for each channel, indexed by core * num_channels +
+     * channel. When there is a defined scheduling direction, it's sufficient
+     * to only track the latest reservation for each channel, so the table is
+     * dense.
+     */
+    ReservationTable state;
+
+    /**
+     * Returns the first channel of the given core that is free for the given
+     * cycle range, or num_channels if there is none.
      */
-    utils::Vec<utils::Vec<State>> state;
+    utils::UInt find_free_channel(
+        utils::UInt core,
+        utils::Int start,
+        utils::Int end
+    ) const;
 
     /**
      * Shared pointer to the configuration structure.
@@ -55,6 +63,21 @@ protected:
         utils::Bool commit
     ) override;
 
+    /**
+     * Starts a checkpoint for the reservation state.
+     */
+    utils::Bool on_checkpoint() override;
+
+    /**
+     * Rolls back to the most recent checkpoint.
+     */
+    void on_rollback() override;
+
+    /**
+     * Removes the most recent checkpoint, keeping the reservations.
+     */
+    void on_commit() override;
+
     /**
      * Dumps documentation for this resource.
      */
@@ -5,18 +5,13 @@
 
 #pragma once
 
-#include "ql/utils/rangemap.h"
+#include "ql/resource/reservations.h"
 #include "ql/rmgr/resource_types/base.h"
 
 namespace ql {
 namespace resource {
 namespace qubit {
 
-/**
- * State per qubit.
- */
-using State = utils::RangeSet<utils::Int>;
-
 /**
  * Qubit resource. This resource prevents a qubit from being used more than once
  * in each cycle.
@@ -25,15 +20,11 @@ class QubitResource : public rmgr::resource_types::Base {
 private:
 
     /**
-     * The reservations for each qubit.
-     */
-    utils::Vec<State> state;
-
-    /**
-     * When set, there is a defined scheduling direction, which means it's
-     * sufficient to only track the latest reservation for each qubit.
+     * The reservations for each qubit. When there is a defined scheduling
+     * direction, it's sufficient to only track the latest reservation for
+     * each qubit, so the table is dense.
      */
-    utils::Bool optimize;
+    ReservationTable state;
 
 protected:
 
@@ -51,6 +42,30 @@ protected:
         utils::Bool commit
     ) override;
 
+    /**
+     * Checks availability of a batch of gates.
+     */
+    void on_gate_batch(
+        utils::Int cycle,
+        const utils::Vec<rmgr::resource_types::GateData> &gates,
+        utils::Vec<utils::Bool> &mask
+    ) override;
+
+    /**
+     * Starts a checkpoint for the reservation state.
+     */
+    utils::Bool on_checkpoint() override;
+
+    /**
+     * Rolls back to the most recent checkpoint.
+     */
+    void on_rollback() override;
+
+    /**
+     * Removes the most recent checkpoint, keeping the reservations.
+     */
+    void on_commit() override;
+
     /**
      * Dumps documentation for this resource.
      */
@@ -0,0 +1,174 @@
+/** \file
+ * Defines a table of cycle reservations for a number of exclusive resource
+ * slots (qubits, communication channels, etc.), used by the resources that
+ * only need to know whether a slot is in use.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/vec.h"
+
+namespace ql {
+namespace resource {
+
+/**
+ * Table of cycle reservations for a number of exclusive resource slots. A slot
+ * is available for a cycle range if none of its reservations overlap with it,
+ * with the same overlap semantics as utils::RangeSet::find().
+ *
+ * When the scheduling direction is defined, a resource only ever needs to
+ * track the latest reservation of each slot. In this dense mode the table is
+ * just a pair of arrays holding the start and end cycle of the latest
+ * reservation, so availability checks and reservations are a couple of array
+ * operations. Otherwise, each slot keeps a sorted vector of disjoint ranges,
+ * searched by bisection.
+ */
+class ReservationTable {
+public:
+
+    /**
+     * A reserved cycle range, from first (inclusive) to second (exclusive).
+     */
+    using Range = utils::Pair<utils::Int, utils::Int>;
+
+private:
+
+    /**
+     * Whether only the latest reservation is tracked for each slot.
+     */
+    utils::Bool dense = true;
+
+    /**
+     * The start cycle of the latest reservation for each slot in dense mode.
+     */
+    utils::Vec<utils::Int> first;
+
+    /**
+     * The end cycle of the latest reservation for each slot in dense mode.
+     */
+    utils::Vec<utils::Int> second;
+
+    /**
+     * The reservations for each slot in sparse mode, sorted by start cycle
+     * and then by descending end cycle, like utils::RangeSet.
+     */
+    utils::Vec<utils::Vec<Range>> ranges;
+
+    /**
+     * Entry in the undo log. In dense mode, this is the reservation of the
+     * slot before it was replaced; in sparse mode, this is the reservation
+     * that was added to the slot.
+     */
+    struct UndoEntry {
+        utils::UInt slot;
+        Range range;
+    };
+
+    /**
+     * Log of the reservations made since the oldest active checkpoint, used
+     * to roll them back. Nothing is logged if there are no active
+     * checkpoints.
+     */
+    utils::Vec<UndoEntry> undo_log;
+
+    /**
+     * The size of the undo log at each active checkpoint, from oldest to
+     * newest.
+     */
+    utils::Vec<utils::UInt> checkpoints;
+
+public:
+
+    /**
+     * Resets the table to the given number of slots without reservations. If
+     * dense is set, only the latest reservation is tracked for each slot.
+     */
+    void initialize(utils::UInt num_slots, utils::Bool dense);
+
+    /**
+     * Returns the number of slots in the table.
+     */
+    utils::UInt size() const;
+
+    /**
+     * Returns whether the given slot is free for the cycle range from start
+     * (inclusive) to end (exclusive).
+     */
+    inline utils::Bool is_free(utils::UInt slot, utils::Int start, utils::Int end) const {
+        if (dense) {
+
+            // Same as is_free_sparse() for a single reservation: if the
+            // reservation sorts before the range it must end before the
+            // range starts, otherwise the range must end before the
+            // reservation starts.
+            auto before = first[slot] < start || (first[slot] == start && second[slot] > end);
+            return before ? second[slot] <= start : end <= first[slot];
+
+        }
+        return is_free_sparse(slot, start, end);
+    }
+
+    /**
+     * Reserves the given slot for the cycle range from start (inclusive) to
+     * end (exclusive). The slot must be free for this range. In dense mode,
+     * this replaces the previous reservation.
+     */
+    inline void reserve(utils::UInt slot, utils::Int start, utils::Int end) {
+        if (dense) {
+            if (!checkpoints.empty()) {
+                undo_log.push_back({slot, {first[slot], second[slot]}});
+            }
+            first[slot] = start;
+            second[slot] = end;
+            return;
+        }
+        reserve_sparse(slot, start, end);
+    }
+
+    /**
+     * Starts logging the reservations that are made from now on, such that
+     * they can be rolled back with rollback(). Checkpoints can be nested;
+     * each checkpoint() must be matched by a rollback() or commit().
+     */
+    void checkpoint();
+
+    /**
+     * Undoes all reservations made since the most recent checkpoint, and
+     * removes that checkpoint.
+     */
+    void rollback();
+
+    /**
+     * Removes the most recent checkpoint, keeping the reservations made since.
+     * They can still be rolled back by rolling back an enclosing checkpoint.
+     */
+    void commit();
+
+    /**
+     * Dumps the reservations for the given slot.
+     */
+    void dump_state(
+        utils::UInt slot,
+        std::ostream &os,
+        const utils::Str &line_prefix
+    ) const;
+
+private:
+
+    /**
+     * Implementation of is_free() for sparse mode.
+     */
+    utils::Bool is_free_sparse(utils::UInt slot, utils::Int start, utils::Int end) const;
+
+    /**
+     * Implementation of reserve() for sparse mode.
+     */
+    void reserve_sparse(utils::UInt slot, utils::Int start, utils::Int end);
+
+};
+
+} // namespace resource
+} // namespace ql
@@ -6,6 +6,7 @@
 
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
+#include "ql/utils/vec.h"
 #include "ql/ir/compat/compat.h"
 #include "ql/ir/ir.h"
 #include "ql/rmgr/types.h"
@@ -94,6 +95,12 @@ private:
      */
     utils::Int prev_cycle;
 
+    /**
+     * The value of prev_cycle at each active checkpoint handled by the
+     * resource itself, from oldest to newest.
+     */
+    utils::Vec<utils::Int> checkpoint_prev_cycles;
+
 protected:
 
     /**
@@ -119,6 +126,44 @@ protected:
         utils::Bool commit
     ) = 0;
 
+    /**
+     * Abstract implementation for gate_batch(). mask has one entry for each
+     * gate; only the gates for which the entry is set need to be checked, and
+     * the entry must be cleared for those that are not available. The state
+     * must not be updated. The default implementation calls on_gate() for
+     * each gate; resources that can check availability in a tighter loop over
+     * their internal state should override this.
+     */
+    virtual void on_gate_batch(
+        utils::Int cycle,
+        const utils::Vec<GateData> &gates,
+        utils::Vec<utils::Bool> &mask
+    );
+
+    /**
+     * Abstract implementation for checkpoint(). Resources that can roll back
+     * their state changes more efficiently than by cloning the whole state
+     * (typically by keeping an undo log of the changes made since the
+     * checkpoint) should override this to start such a checkpoint and return
+     * true, and should override on_rollback() and on_commit() as well.
+     * Checkpoints may be nested. The default implementation returns false.
+     */
+    virtual utils::Bool on_checkpoint();
+
+    /**
+     * Abstract implementation for rollback(). Only called for checkpoints for
+     * which on_checkpoint() returned true. The default implementation throws
+     * an exception.
+     */
+    virtual void on_rollback();
+
+    /**
+     * Abstract implementation for commit(). Only called for checkpoints for
+     * which on_checkpoint() returned true. The default implementation throws
+     * an exception.
+     */
+    virtual void on_commit();
+
     /**
      * Abstract implementation for dump_docs().
      */
@@ -228,6 +273,48 @@ public:
         utils::Bool commit
     );
 
+    /**
+     * Builds the gate data structure for the given new-IR statement, as passed
+     * to gate(). This only depends on the statement and the context of the
+     * resource, so the result can be reused for every resource constructed
+     * for the same platform, for any cycle.
+     */
+    GateData get_gate_data(const ir::StatementRef &statement) const;
+
+    /**
+     * Checks the availability of a batch of gates for the given (start) cycle
+     * without updating the state. mask has one entry for each gate; the
+     * entries for gates that are not available are cleared, while the entries
+     * that are already cleared are left alone. Note that the cycle number may
+     * be negative.
+     */
+    void gate_batch(
+        utils::Int cycle,
+        const utils::Vec<GateData> &gates,
+        utils::Vec<utils::Bool> &mask
+    );
+
+    /**
+     * Starts a checkpoint, such that all state changes made from now on can be
+     * undone by rollback() or kept by commit(). Returns false if the resource
+     * doesn't support this, in which case the caller must save a clone of the
+     * resource instead, and must not call rollback() or commit() for this
+     * checkpoint.
+     */
+    utils::Bool checkpoint();
+
+    /**
+     * Undoes all state changes made since the most recent checkpoint for
+     * which checkpoint() returned true, and removes that checkpoint.
+     */
+    void rollback();
+
+    /**
+     * Removes the most recent checkpoint for which checkpoint() returned true,
+     * keeping the state changes made since.
+     */
+    void commit();
+
     /**
      * Dumps a debug representation of the current resource state.
      */
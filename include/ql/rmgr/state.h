@@ -37,6 +37,38 @@ private:
      */
     utils::Bool is_broken;
 
+    /**
+     * Information saved for an active checkpoint.
+     */
+    struct Checkpoint {
+
+        /**
+         * For each resource, a clone of its state at the time of the
+         * checkpoint if the resource does not support checkpoints itself, or
+         * an empty reference if it does.
+         */
+        utils::Vec<ResourceRef> clones;
+
+        /**
+         * The value of is_broken at the time of the checkpoint.
+         */
+        utils::Bool is_broken;
+
+    };
+
+    /**
+     * The active checkpoints, from oldest to newest.
+     */
+    utils::Vec<Checkpoint> checkpoints;
+
+    /**
+     * Clones the given checkpoints, including the resource states saved in
+     * them.
+     */
+    static utils::Vec<Checkpoint> clone_checkpoints(
+        const utils::Vec<Checkpoint> &src
+    );
+
     /**
      * Constructor for the initial state, called from Manager::build().
      */
@@ -45,7 +77,8 @@ private:
 public:
 
     /**
-     * Copy constructor that clones the resource states.
+     * Copy constructor that clones the resource states, including any
+     * checkpoints.
      */
     State(const State &src);
 
@@ -55,7 +88,8 @@ public:
     State(State &&src) = default;
 
     /**
-     * Copy assignment operator that clones the resource states.
+     * Copy assignment operator that clones the resource states, including any
+     * checkpoints.
      */
     State &operator=(const State &src);
 
@@ -82,6 +116,20 @@ public:
         const ir::StatementRef &statement
     ) const;
 
+    /**
+     * Checks which of the given new-IR statements can be scheduled at the
+     * given (start) cycle. The returned mask has an entry for each statement
+     * that is set if and only if available() would return true for it. This
+     * is faster than calling available() for each statement, because the
+     * statements are only converted to the form used by the resources once,
+     * and each resource checks the whole batch at once. Note that the cycle
+     * number may be negative.
+     */
+    utils::Vec<utils::Bool> available_batch(
+        utils::Int cycle,
+        const utils::Vec<ir::StatementRef> &statements
+    ) const;
+
     /**
      * Schedules the given old-IR gate at the given (start) cycle. Throws an
      * exception if this is not possible. When an exception is thrown, the
@@ -103,6 +151,36 @@ public:
         const ir::StatementRef &statement
     );
 
+    /**
+     * Starts a checkpoint, such that all reservations made from now on can be
+     * undone by rollback() or kept by commit(). This allows reservations to
+     * be made speculatively without copying the state: resources that support
+     * it keep an undo log of the changes made since the checkpoint, so the
+     * cost is proportional to the number of changes rather than to the size
+     * of the state. The state of any other resources is cloned. Checkpoints
+     * can be nested; each checkpoint() must be matched by a rollback() or
+     * commit(). Copies of the state include its active checkpoints.
+     */
+    void checkpoint();
+
+    /**
+     * Undoes all reservations made since the most recent checkpoint, and
+     * removes that checkpoint. This also recovers from a failed reserve() made
+     * since the checkpoint.
+     */
+    void rollback();
+
+    /**
+     * Removes the most recent checkpoint, keeping the reservations made since.
+     * They can still be undone by rolling back an enclosing checkpoint.
+     */
+    void commit();
+
+    /**
+     * Returns the number of active checkpoints.
+     */
+    utils::UInt get_num_checkpoints() const;
+
     /**
      * Dumps a debug representation of the current resource state.
      */
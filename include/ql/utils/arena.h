@@ -0,0 +1,361 @@
+/** \file
+ * Provides a pooled arena allocator that tree nodes can optionally be
+ * allocated from, to avoid the overhead of millions of small heap allocations
+ * for large programs.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "ql/utils/num.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/map.h"
+
+namespace ql {
+namespace utils {
+
+class Arena;
+
+/**
+ * Shared reference to an arena. The reference is only used to manage the
+ * lifetime of the arena itself; objects allocated from the arena only refer
+ * to it with a raw pointer.
+ */
+using ArenaRef = std::shared_ptr<Arena>;
+
+/**
+ * Pooled arena for small objects. Each thread that allocates from the arena
+ * gets its own pool, which requests memory from the system in large chunks
+ * and hands it out by bumping a pointer. Deallocated blocks are kept in
+ * per-size-class free lists of the pool of the deallocating thread, to be
+ * reused by later allocations of the same size class by that thread.
+ * Allocations that are too large or need stricter alignment than the granule
+ * size are forwarded to the global allocator.
+ *
+ * Allocation and deallocation only touch the pool of the calling thread, so
+ * they don't need locks or atomic read-modify-write operations. Only the
+ * first allocation or deallocation by a thread takes a lock, to create the
+ * pool for that thread.
+ *
+ * Arenas are created with create() and released when the last ArenaRef to
+ * them goes away. Objects allocated from the arena do not keep it alive, so
+ * the owner of the ArenaRef must keep it until all these objects are gone:
+ * the pass manager attaches the arena it creates for the ir_node_arena option
+ * to the IR root, so it is released along with the program. At that point,
+ * all chunks are returned to the system in bulk. If objects allocated from the
+ * arena are still alive when it is released, the arena and its chunks are
+ * intentionally leaked instead (with a warning), so these objects remain
+ * valid. The arena must not be used by other threads while it is released.
+ */
+class Arena {
+public:
+
+    /**
+     * Size and alignment granularity of pooled allocations.
+     */
+    static const UInt GRANULE = 16;
+
+    /**
+     * Largest allocation that is pooled. Larger allocations go to the global
+     * allocator.
+     */
+    static const UInt MAX_POOLED_SIZE = 512;
+
+    /**
+     * Size of the chunks requested from the global allocator.
+     */
+    static const UInt CHUNK_SIZE = 256 * 1024;
+
+private:
+
+    /**
+     * Number of size classes, i.e. free lists.
+     */
+    static const UInt NUM_SIZE_CLASSES = MAX_POOLED_SIZE / GRANULE;
+
+    /**
+     * Node type of the intrusive free lists.
+     */
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    /**
+     * Counter that is only ever modified by a single thread, but may be read
+     * by any thread. This avoids atomic read-modify-write operations, while
+     * still making it safe to read statistics while other threads are using
+     * the arena.
+     */
+    class Counter {
+    private:
+        std::atomic<Int> value{0};
+    public:
+        void add(Int delta) {
+            value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+        Int get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * The state of the arena for a single thread.
+     */
+    struct Pool {
+
+        /**
+         * The chunks that were allocated thus far.
+         */
+        Vec<void*> chunks;
+
+        /**
+         * Pointer to the first unused byte of the current chunk.
+         */
+        char *cursor = nullptr;
+
+        /**
+         * Number of unused bytes remaining in the current chunk.
+         */
+        UInt remaining = 0;
+
+        /**
+         * Free list for each size class.
+         */
+        FreeBlock *free_lists[NUM_SIZE_CLASSES] = {};
+
+        /**
+         * Total number of allocations served by this pool, including reused
+         * blocks but excluding forwarded ones.
+         */
+        Counter num_allocations;
+
+        /**
+         * Number of allocations that were served from a free list.
+         */
+        Counter num_reuses;
+
+        /**
+         * Number of allocations that were forwarded to the global allocator.
+         */
+        Counter num_forwarded;
+
+        /**
+         * Number of allocations minus the number of deallocations done by
+         * this thread, including forwarded ones. This can be negative for an
+         * individual pool when objects are deallocated by a different thread
+         * than the one that allocated them.
+         */
+        Counter num_live;
+
+        /**
+         * Number of bytes of chunk memory requested from the system.
+         */
+        Counter num_chunk_bytes;
+
+    };
+
+    /**
+     * Unique identifier for this arena, used to validate the per-thread pool
+     * cache.
+     */
+    const UInt id;
+
+    /**
+     * Mutex protecting the pool map.
+     */
+    std::mutex mutex;
+
+    /**
+     * The pool for each thread that used the arena thus far.
+     */
+    Map<std::thread::id, std::unique_ptr<Pool>> pools;
+
+    /**
+     * Constructs an empty arena. No memory is allocated until the first
+     * allocation.
+     */
+    Arena();
+
+    /**
+     * Returns all chunks to the system.
+     */
+    ~Arena();
+
+    /**
+     * Deleter for the ArenaRef returned by create(). Destroys the arena if no
+     * objects allocated from it are alive anymore, or leaks it otherwise.
+     */
+    static void release(Arena *arena);
+
+    /**
+     * Returns the pool for the calling thread, creating it if needed.
+     */
+    Pool &get_pool();
+
+    /**
+     * Returns the sum of the given counter over all pools.
+     */
+    Int sum(Counter Pool::*counter);
+
+public:
+
+    /**
+     * Creates a new arena.
+     */
+    static ArenaRef create();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * Allocates a block of the given size and alignment.
+     */
+    void *allocate(UInt size, UInt alignment);
+
+    /**
+     * Deallocates a block previously returned by allocate() with the same
+     * size and alignment. This may be called from a different thread than
+     * the one that allocated the block.
+     */
+    void deallocate(void *ptr, UInt size, UInt alignment);
+
+    /**
+     * Returns the total number of allocations served by the arena itself.
+     */
+    UInt get_num_allocations();
+
+    /**
+     * Returns the number of allocations that reused a previously deallocated
+     * block.
+     */
+    UInt get_num_reuses();
+
+    /**
+     * Returns the number of allocations that were forwarded to the global
+     * allocator because they were too large or too strictly aligned.
+     */
+    UInt get_num_forwarded();
+
+    /**
+     * Returns the number of allocations that have not been deallocated yet.
+     */
+    UInt get_num_live();
+
+    /**
+     * Returns the number of bytes of chunk memory requested from the system.
+     */
+    UInt get_num_chunk_bytes();
+
+};
+
+/**
+ * Standard-library-compatible allocator that allocates from an Arena. The
+ * allocator only holds a raw pointer to the arena, so it adds no reference
+ * counting to the objects allocated with it; see Arena for the lifetime
+ * rules.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    /**
+     * The arena to allocate from.
+     */
+    Arena *arena;
+
+    /**
+     * Constructs an allocator for the given arena.
+     */
+    explicit ArenaAllocator(Arena *arena) : arena(arena) {
+    }
+
+    /**
+     * Rebinding constructor.
+     */
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {
+    }
+
+    /**
+     * Allocates memory for n objects of type T.
+     */
+    T *allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Deallocates memory for n objects of type T.
+     */
+    void deallocate(T *ptr, std::size_t n) {
+        arena->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.arena == b.arena;
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.arena != b.arena;
+}
+
+/**
+ * RAII object that makes the given arena the active arena for the current
+ * thread for as long as it exists. While an arena is active, tree nodes
+ * constructed via utils::make() are allocated from it. Scopes may be nested;
+ * the previously active arena (if any) is restored on destruction.
+ */
+class ArenaScope {
+private:
+
+    /**
+     * The arena that was active before this scope was entered.
+     */
+    ArenaRef previous;
+
+public:
+
+    /**
+     * Makes the given arena active. An empty reference disables arena
+     * allocation within the scope.
+     */
+    explicit ArenaScope(const ArenaRef &arena);
+
+    /**
+     * Restores the previously active arena.
+     */
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    /**
+     * Returns the arena that is active for the current thread, or nullptr if
+     * none is.
+     */
+    static const ArenaRef &get_active();
+
+};
+
+/**
+ * Allocates an object of type T using the active arena if there is one, or
+ * the global allocator otherwise, analogous to std::make_shared().
+ */
+template <class T, typename... Args>
+std::shared_ptr<T> make_shared_in_active_arena(Args&&... args) {
+    if (auto arena = ArenaScope::get_active().get()) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+    } else {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+}
+
+} // namespace utils
+} // namespace ql
@@ -0,0 +1,36 @@
+/** \file
+ * Provides a minimal facility for running independent pieces of work on
+ * multiple threads.
+ */
+
+#pragma once
+
+#include <functional>
+#include "ql/utils/num.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Returns the number of worker threads to use for the given requested number
+ * of threads. Zero means that the hardware concurrency should be used.
+ */
+UInt get_num_threads(UInt requested = 0);
+
+/**
+ * Calls fn(i) for each i in [0, count), distributing the calls dynamically
+ * over at most num_threads threads (the calling thread included). Zero means
+ * that the hardware concurrency is used. The arena that is active for the
+ * calling thread (if any) is also made active in the worker threads, so tree
+ * nodes constructed by fn are allocated from the same arena.
+ *
+ * If any of the calls throws an exception, no further calls are started, and
+ * the first exception is rethrown in the calling thread after all workers have
+ * stopped.
+ *
+ * fn must of course be safe to call concurrently for different indices.
+ */
+void parallel_for(UInt count, const std::function<void(UInt)> &fn, UInt num_threads = 0);
+
+} // namespace utils
+} // namespace ql
@@ -0,0 +1,194 @@
+/** \file
+ * Provides platform-agnostic primitives for measuring the time and memory used
+ * by (parts of) the compiler, for profiling and benchmarking purposes.
+ */
+
+#pragma once
+
+#include <chrono>
+#include "ql/utils/num.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Returns the number of seconds of wall-clock time elapsed since some
+ * arbitrary but fixed point in time (namely the first call to this function).
+ * Uses a monotonic clock, so differences between values are always
+ * non-negative.
+ */
+Real get_wall_time();
+
+/**
+ * Returns the number of seconds of CPU time (user + system) consumed by this
+ * process thus far, summed over all threads. Returns 0 if this cannot be
+ * determined on the current platform.
+ */
+Real get_cpu_time();
+
+/**
+ * Returns the peak resident set size of this process thus far in bytes, or 0
+ * if this cannot be determined on the current platform.
+ */
+UInt get_peak_rss();
+
+/**
+ * Snapshot of the resource usage counters of this process at a particular
+ * point in time. Differences between two snapshots are used to determine how
+ * much time and memory was spent on something.
+ */
+class ResourceUsage {
+public:
+
+    /**
+     * Wall-clock time in seconds, as returned by get_wall_time().
+     */
+    Real wall_time;
+
+    /**
+     * CPU time in seconds, as returned by get_cpu_time().
+     */
+    Real cpu_time;
+
+    /**
+     * Peak resident set size in bytes, as returned by get_peak_rss().
+     */
+    UInt peak_rss;
+
+    /**
+     * Constructs a snapshot with all counters set to zero.
+     */
+    ResourceUsage();
+
+    /**
+     * Takes a snapshot of the current resource usage counters.
+     */
+    static ResourceUsage now();
+
+    /**
+     * Returns the resource usage from the given earlier snapshot up to this
+     * snapshot. The peak RSS of the result is the amount by which the peak
+     * resident set size grew in between the snapshots, which is zero if the
+     * previous peak was not exceeded.
+     */
+    ResourceUsage since(const ResourceUsage &start) const;
+
+};
+
+/**
+ * Simple stopwatch for timing parts of algorithms. The stopwatch accumulates
+ * the wall-clock time spent between start() and stop() calls, such that the
+ * same stopwatch can be used to time a phase that is entered many times.
+ */
+class Stopwatch {
+private:
+
+    /**
+     * The clock source to use.
+     */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * The time at which start() was last called.
+     */
+    Clock::time_point started;
+
+    /**
+     * Total accumulated time in nanoseconds.
+     */
+    UInt total_ns;
+
+    /**
+     * Number of start()/stop() cycles.
+     */
+    UInt count;
+
+    /**
+     * Whether the stopwatch is currently running.
+     */
+    Bool running;
+
+public:
+
+    /**
+     * Constructs a stopped stopwatch with no accumulated time.
+     */
+    Stopwatch();
+
+    /**
+     * Starts the stopwatch. No-op if it is already running.
+     */
+    void start();
+
+    /**
+     * Stops the stopwatch, adding the time since start() to the accumulated
+     * time. No-op if it is not running.
+     */
+    void stop();
+
+    /**
+     * Resets the accumulated time and count, and stops the stopwatch.
+     */
+    void reset();
+
+    /**
+     * Returns the accumulated time in seconds, excluding the currently running
+     * period (if any).
+     */
+    Real get_seconds() const;
+
+    /**
+     * Returns the number of completed start()/stop() cycles.
+     */
+    UInt get_count() const;
+
+    /**
+     * Adds the accumulated time and count of the given stopwatch to this one.
+     */
+    void merge(const Stopwatch &other);
+
+    /**
+     * Returns whether the stopwatch is currently running.
+     */
+    Bool is_running() const;
+
+};
+
+/**
+ * RAII helper that runs a Stopwatch for as long as it is in scope. If the
+ * stopwatch is already running when the timer is constructed, the timer does
+ * nothing, such that a timed phase may safely (indirectly) recurse into
+ * itself without its time being counted twice or being cut short.
+ */
+class ScopedTimer {
+private:
+
+    /**
+     * The stopwatch that is being run.
+     */
+    Stopwatch &stopwatch;
+
+    /**
+     * Whether this timer started the stopwatch, and should thus stop it.
+     */
+    Bool owner;
+
+public:
+
+    /**
+     * Starts the given stopwatch.
+     */
+    explicit ScopedTimer(Stopwatch &stopwatch);
+
+    /**
+     * Stops the stopwatch, if this timer started it.
+     */
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+};
+
+} // namespace utils
+} // namespace ql
@@ -41,13 +41,31 @@ Platform::Platform(
     );
 }
 
+/**
+ * Internal constructor to implement get_shared().
+ */
+Platform::Platform(
+    const std::string &name,
+    const std::string &platform_config,
+    const ql::ir::compat::PlatformRef &platform
+) :
+    platform(platform),
+    name(name),
+    config_file(platform_config)
+{
+    if (!platform->platform_config_fname.empty()) {
+        config_file = platform->platform_config_fname;
+    }
+}
+
 /**
  * Constructs a platform. name is any name the user wants to give to the
  * platform; it is only used for report messages. platform_config must be
  * a recognized architecture (variant) name, or must point to a JSON file
- * that represents the platform directly. Optionally, compiler_config can be
- * specified to override the compiler configuration specified by the
- * platform (if any).
+ * that represents the platform directly or to a preprocessed configuration
+ * file written by save_preprocessed_config(). Optionally, compiler_config can
+ * be specified to override the compiler configuration specified by the
+ * platform (if any); this is not supported for preprocessed configurations.
  */
 Platform::Platform(
     const std::string &name,
@@ -63,6 +81,9 @@ Platform::Platform(
         platform_config,
         compiler_config
     );
+    if (!platform->platform_config_fname.empty()) {
+        config_file = platform->platform_config_fname;
+    }
 }
 
 /**
@@ -115,6 +136,50 @@ Platform Platform::from_json_string(
     return Platform(name, platform_config_json, compiler_config, false);
 }
 
+/**
+ * Returns a platform from the in-process platform registry, constructing it in
+ * the same way as the constructor with the same arguments if it is not
+ * registered yet. Platforms requested with the same arguments share the
+ * loaded platform data (including its conversion to the new IR), so this is
+ * much faster than constructing a new platform each time when many programs
+ * are compiled for the same platform. The configuration files are reread and
+ * the platform is rebuilt if they were modified.
+ */
+Platform Platform::get_shared(
+    const std::string &name,
+    const std::string &platform_config,
+    const std::string &compiler_config
+) {
+    ensure_initialized();
+    return Platform(
+        name,
+        platform_config,
+        ql::ir::compat::Platform::get_shared(name, platform_config, compiler_config)
+    );
+}
+
+/**
+ * Removes all platforms from the in-process platform registry, such that
+ * subsequent calls to get_shared() construct them again. Existing platforms
+ * remain valid.
+ */
+void Platform::clear_shared() {
+    ql::ir::compat::Platform::clear_shared();
+}
+
+/**
+ * Writes the preprocessed platform configuration to the given file, as a
+ * cache for loading the same platform again: passing its filename as
+ * platform_config to the constructor or to get_shared() skips JSON parsing,
+ * resolution of the compiler configuration, and architecture-specific
+ * preprocessing. Everything that is built from the configuration is still
+ * built as usual. The file can only be loaded by the version of OpenQL that
+ * wrote it.
+ */
+void Platform::save_preprocessed_config(const std::string &filename) const {
+    platform->save_preprocessed_config(filename);
+}
+
 /**
  * Returns the number of qubits in the platform.
  */
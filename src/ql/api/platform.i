@@ -39,8 +39,9 @@ Eight constructors are provided:
  - Platform(name, platform_config): builds a platform with the given name (only
    used for log messages) and platform configuration, the latter of which can
    be either a recognized platform name with or without variant suffix (for
-   example \"cc\" or \"cc_light.s7\"), or a path to a JSON configuration
-   filename.
+   example \"cc\" or \"cc_light.s7\"), a path to a JSON configuration
+   filename, or a path to a preprocessed configuration file written by
+   save_preprocessed_config().
  - Platform(name, platform_config, compiler_config): as above, but specifies a
    custom compiler configuration file in addition.
  - Platform.from_json(name, platform_config_json): instead of loading the
@@ -112,6 +113,69 @@ str
 """
 
 
+%feature("docstring") ql::api::Platform::get_shared
+"""
+Returns a platform from the in-process platform registry, constructing it in
+the same way as the constructor with the same arguments if it is not registered
+yet. Platforms requested with the same arguments share the loaded platform data
+(including its conversion to the new IR), so this is much faster than
+constructing a new platform each time when many programs are compiled for the
+same platform. The configuration files are reread and the platform is rebuilt
+if they were modified.
+
+Parameters
+----------
+name : str
+    The name for the platform.
+platform_config : str
+    The platform configuration. Same syntax as the platform constructor.
+compiler_config : str
+    Optional compiler configuration JSON filename.
+
+Returns
+-------
+Platform
+    The shared platform.
+"""
+
+
+%feature("docstring") ql::api::Platform::clear_shared
+"""
+Removes all platforms from the in-process platform registry, such that
+subsequent calls to get_shared() construct them again. Existing platforms
+remain valid.
+
+Parameters
+----------
+None
+
+Returns
+-------
+None
+"""
+
+
+%feature("docstring") ql::api::Platform::save_preprocessed_config
+"""
+Writes the preprocessed platform configuration to the given file, as a cache
+for loading the same platform again: passing its filename as platform_config to
+the constructor or to get_shared() skips JSON parsing, resolution of the
+compiler configuration, and architecture-specific preprocessing. Everything
+that is built from the configuration (instruction set, topology, resources, and
+the conversion to the new IR) is still built as usual. The file can only be
+loaded by the version of OpenQL that wrote it.
+
+Parameters
+----------
+filename : str
+    The file to write the preprocessed configuration to.
+
+Returns
+-------
+None
+"""
+
+
 %feature("docstring") ql::api::Platform::get_qubit_number
 """
 Returns the number of qubits in the platform.
@@ -0,0 +1,267 @@
+/** \file
+ * Sparse, weighted qubit interaction graph.
+ */
+
+#include "ql/com/ana/interaction_graph.h"
+
+#include <iomanip>
+#include "ql/ir/ops.h"
+
+namespace ql {
+namespace com {
+namespace ana {
+
+using namespace utils;
+
+/**
+ * Constructs an empty interaction graph for the given number of qubits.
+ */
+InteractionGraph::InteractionGraph(UInt num_qubits) : adjacency(num_qubits) {
+}
+
+/**
+ * Adds the given weight to the edge between qubits a and b. Interactions of a
+ * qubit with itself are ignored.
+ */
+void InteractionGraph::add_interaction(UInt a, UInt b, UInt weight) {
+    if (a == b || !weight) {
+        return;
+    }
+    auto required = max(a, b) + 1;
+    if (adjacency.size() < required) {
+        adjacency.resize(required);
+    }
+    auto &ab = adjacency[a][b];
+    if (!ab) {
+        num_edges++;
+    }
+    ab += weight;
+    adjacency[b][a] += weight;
+    total_weight += weight;
+}
+
+/**
+ * Adds an interaction between each pair of the given qubits, i.e. the
+ * interactions due to a single gate operating on these qubits.
+ */
+void InteractionGraph::add_gate(const Vec<UInt> &qubits, UInt weight) {
+    for (UInt i = 0; i < qubits.size(); i++) {
+        for (UInt j = i + 1; j < qubits.size(); j++) {
+            add_interaction(qubits[i], qubits[j], weight);
+        }
+    }
+}
+
+/**
+ * Adds all interactions of the given graph to this one.
+ */
+void InteractionGraph::merge(const InteractionGraph &other) {
+    if (adjacency.size() < other.adjacency.size()) {
+        adjacency.resize(other.adjacency.size());
+    }
+    for (UInt a = 0; a < other.adjacency.size(); a++) {
+        for (const auto &it : other.adjacency[a]) {
+            if (it.first > a) {
+                add_interaction(a, it.first, it.second);
+            }
+        }
+    }
+}
+
+/**
+ * Returns the number of qubits, i.e. one more than the highest qubit index that
+ * has been seen or the number of qubits passed to the constructor, whichever is
+ * larger.
+ */
+UInt InteractionGraph::get_num_qubits() const {
+    return adjacency.size();
+}
+
+/**
+ * Returns the weight of the edge between qubits a and b, or 0 if they don't
+ * interact.
+ */
+UInt InteractionGraph::get_weight(UInt a, UInt b) const {
+    if (a >= adjacency.size()) {
+        return 0;
+    }
+    auto it = adjacency[a].find(b);
+    if (it == adjacency[a].end()) {
+        return 0;
+    }
+    return it->second;
+}
+
+/**
+ * Returns the neighbors of the given qubit along with the edge weights.
+ */
+const InteractionGraph::Neighbors &InteractionGraph::get_neighbors(UInt qubit) const {
+    static const Neighbors NONE;
+    if (qubit >= adjacency.size()) {
+        return NONE;
+    }
+    return adjacency[qubit];
+}
+
+/**
+ * Returns the number of qubits that the given qubit interacts with.
+ */
+UInt InteractionGraph::get_degree(UInt qubit) const {
+    return get_neighbors(qubit).size();
+}
+
+/**
+ * Returns the sum of the weights of the edges of the given qubit.
+ */
+UInt InteractionGraph::get_weighted_degree(UInt qubit) const {
+    UInt degree = 0;
+    for (const auto &it : get_neighbors(qubit)) {
+        degree += it.second;
+    }
+    return degree;
+}
+
+/**
+ * Returns the number of distinct interacting qubit pairs.
+ */
+UInt InteractionGraph::get_num_edges() const {
+    return num_edges;
+}
+
+/**
+ * Returns the sum of all edge weights.
+ */
+UInt InteractionGraph::get_total_weight() const {
+    return total_weight;
+}
+
+/**
+ * Returns the interactions as a dense, symmetric matrix. Note that this
+ * requires memory quadratic in the number of qubits, so this should only be
+ * used when this is actually needed, for instance for writing the matrix to a
+ * file.
+ */
+InteractionGraph::Matrix InteractionGraph::get_dense_matrix() const {
+    auto size = adjacency.size();
+    Matrix matrix(size, Vec<UInt>(size, 0));
+    for (UInt a = 0; a < size; a++) {
+        for (const auto &it : adjacency[a]) {
+            matrix[a][it.first] = it.second;
+        }
+    }
+    return matrix;
+}
+
+/**
+ * Returns the dense matrix as a human-readable string. Same caveats as for
+ * get_dense_matrix() apply.
+ */
+Str InteractionGraph::get_string() const {
+    StrStrm ss;
+    auto size = adjacency.size();
+
+    // Use the following for properly aligned matrix print for visual inspection
+    // This can be problematic of width not set properly to be processed by gnuplot script
+#define ALIGNMENT (std::setw(4))
+
+    // Use the following to print tabs which will not be visually appealing but it will
+    // generate the columns properly for further processing by other tools
+    // #define ALIGNMENT ("    ")
+
+    ss << ALIGNMENT << " ";
+    for (UInt c = 0; c < size; c++) {
+        ss << ALIGNMENT << "q" + to_string(c);
+    }
+    ss << std::endl;
+
+    // Rows are generated from the sparse representation directly, so the
+    // dense matrix is never materialized.
+    for (UInt p = 0; p < size; p++) {
+        ss << ALIGNMENT << "q" + to_string(p);
+        auto it = adjacency[p].begin();
+        for (UInt c = 0; c < size; c++) {
+            UInt weight = 0;
+            if (it != adjacency[p].end() && it->first == c) {
+                weight = it->second;
+                ++it;
+            }
+            ss << ALIGNMENT << weight;
+        }
+        ss << std::endl;
+    }
+#undef ALIGNMENT
+
+    return ss.str();
+}
+
+/**
+ * Returns the indices of the qubits referred to by the operands of the given
+ * instruction, in operand order. Only references to the main qubit register
+ * with a literal index are considered.
+ */
+Vec<UInt> get_qubit_operands(
+    const ir::Ref &ir,
+    const ir::InstructionRef &instruction
+) {
+    Vec<UInt> qubits;
+    if (!instruction->as_custom_instruction()) {
+        return qubits;
+    }
+    for (auto &op : ir::get_operands(instruction)) {
+        if (auto ref = op->as_reference()) {
+            if (
+                ref->target == ir->platform->qubits &&
+                ref->data_type == ir->platform->qubits->data_type &&
+                ref->indices.size() == 1 &&
+                ref->indices[0]->as_int_literal()
+            ) {
+                qubits.push_back(ref->indices[0]->as_int_literal()->value);
+            }
+        }
+    }
+    return qubits;
+}
+
+/**
+ * Two-qubit interaction graph metric.
+ */
+void TwoQubitInteractions::process_instruction(
+    const ir::Ref &ir,
+    const ir::InstructionRef &instruction
+) {
+    auto qubits = get_qubit_operands(ir, instruction);
+    if (qubits.size() == 2) {
+        value.add_interaction(qubits[0], qubits[1], weight);
+    }
+}
+
+/**
+ * Two-qubit interaction graph metric.
+ */
+void TwoQubitInteractions::merge(const MetricBase &other) {
+    value.merge(dynamic_cast<const TwoQubitInteractions&>(other).value);
+}
+
+/**
+ * Multi-qubit interaction graph metric.
+ */
+void MultiQubitInteractions::process_instruction(
+    const ir::Ref &ir,
+    const ir::InstructionRef &instruction
+) {
+    auto qubits = get_qubit_operands(ir, instruction);
+    if (qubits.size() >= 2) {
+        value.add_gate(qubits, weight);
+    }
+}
+
+/**
+ * Multi-qubit interaction graph metric.
+ */
+void MultiQubitInteractions::merge(const MetricBase &other) {
+    value.merge(dynamic_cast<const MultiQubitInteractions&>(other).value);
+}
+
+} // namespace ana
+} // namespace com
+} // namespace ql
@@ -4,7 +4,6 @@
 
 #include "ql/com/ana/interaction_matrix.h"
 
-#include <iomanip>
 #include "ql/utils/filesystem.h"
 #include "ql/com/options.h"
 
@@ -14,62 +13,40 @@ namespace ana {
 
 using namespace utils;
 
+/**
+ * Computes the interaction matrix for the given kernel. All gates with exactly
+ * two qubit operands are counted, save for wait instructions.
+ */
 InteractionMatrix::InteractionMatrix(
     const ir::compat::KernelRef &kernel
-) : size(kernel->qubit_count) {
-    matrix.resize(size, Vec<UInt>(size, 0));
-    for (auto ins : kernel->gates) {
-        Str insName = ins->qasm();
-        if (insName.find("cnot") != Str::npos) {
-            // for now the interaction matrix only for cnot
-            auto operands = ins->operands;
-            if (operands.size() == 2) {
-                UInt operand0 = operands[0];
-                UInt operand1 = operands[1];
-                matrix[operand0][operand1] += 1;
-                matrix[operand1][operand0] += 1;
-            }
+) : graph(kernel->qubit_count) {
+    for (const auto &gate : kernel->gates) {
+        if (gate->operands.size() == 2 && gate->type() != ir::compat::GateType::WAIT) {
+            graph.add_interaction(gate->operands[0], gate->operands[1]);
         }
     }
 }
 
 /**
- * Returns the embedded matrix.
+ * Returns the interaction graph.
  */
-const InteractionMatrix::Matrix &InteractionMatrix::get_matrix() const {
-    return matrix;
+const InteractionGraph &InteractionMatrix::get_graph() const {
+    return graph;
+}
+
+/**
+ * Returns the interactions as a dense matrix. This is constructed on request,
+ * as it requires memory quadratic in the number of qubits.
+ */
+InteractionMatrix::Matrix InteractionMatrix::get_matrix() const {
+    return graph.get_dense_matrix();
 }
 
 /**
  * Returns the matrix as a string.
  */
 Str InteractionMatrix::get_string() const {
-    StrStrm ss;
-
-    // Use the following for properly aligned matrix print for visual inspection
-    // This can be problematic of width not set properly to be processed by gnuplot script
-#define ALIGNMENT (std::setw(4))
-
-    // Use the following to print tabs which will not be visually appealing but it will
-    // generate the columns properly for further processing by other tools
-    // #define ALIGNMENT ("    ")
-
-    ss << ALIGNMENT << " ";
-    for (UInt c = 0; c < size; c++) {
-        ss << ALIGNMENT << "q" + to_string(c);
-    }
-    ss << std::endl;
-
-    for (UInt p = 0; p < size; p++) {
-        ss << ALIGNMENT << "q" + to_string(p);
-        for (UInt c = 0; c < size; c++) {
-            ss << ALIGNMENT << matrix[p][c];
-        }
-        ss << std::endl;
-    }
-#undef ALIGNMENT
-
-    return ss.str();
+    return graph.get_string();
 }
 
 /**
@@ -0,0 +1,108 @@
+/** \file
+ * Engine for computing a set of metrics in a single traversal.
+ */
+
+#include "ql/com/ana/metric_set.h"
+
+#include "ql/utils/exception.h"
+#include "ql/utils/parallel.h"
+
+namespace ql {
+namespace com {
+namespace ana {
+
+/**
+ * Constructs a fresh instance of each metric in the set.
+ */
+utils::Vec<utils::Ptr<MetricBase>> MetricSet::make_metrics() const {
+    utils::Vec<utils::Ptr<MetricBase>> metrics;
+    for (const auto &factory : factories) {
+        metrics.push_back(factory());
+    }
+    return metrics;
+}
+
+/**
+ * Returns the metric instance for the given handle and block, throwing an
+ * exception if it has not been computed.
+ */
+MetricBase &MetricSet::get_block_metric(utils::UInt index, utils::UInt block) const {
+    if (block >= block_metrics.size()) {
+        throw utils::Exception("no metric results available for block " + utils::to_string(block));
+    }
+    return *block_metrics[block].at(index);
+}
+
+/**
+ * Returns the merged metric instance for the given handle, throwing an
+ * exception if it has not been computed.
+ */
+MetricBase &MetricSet::get_program_metric(utils::UInt index) const {
+    if (program_metrics.empty()) {
+        throw utils::Exception("no program-wide metric results available");
+    }
+    return *program_metrics.at(index);
+}
+
+/**
+ * Computes all metrics for the given block. The results are available as block
+ * 0.
+ */
+void MetricSet::compute_block(const ir::Ref &ir, const ir::BlockBaseRef &block) {
+    block_metrics.clear();
+    program_metrics.clear();
+    block_metrics.push_back(make_metrics());
+    utils::Vec<MetricBase*> metrics;
+    for (const auto &metric : block_metrics.back()) {
+        metrics.push_back(&*metric);
+    }
+    MetricBase::process_block(metrics, ir, block);
+}
+
+/**
+ * Computes all metrics for each top-level block of the program in parallel,
+ * using at most num_threads threads (0 means the hardware concurrency), and
+ * merges the results into program-wide results.
+ */
+void MetricSet::compute_program(const ir::Ref &ir, utils::UInt num_threads) {
+    block_metrics.clear();
+    program_metrics = make_metrics();
+    if (ir->program.empty()) {
+        return;
+    }
+    const auto &blocks = ir->program->blocks;
+
+    // Construct the metric instances for each block up front, so the workers
+    // only need to touch their own block's instances.
+    for (utils::UInt i = 0; i < blocks.size(); i++) {
+        block_metrics.push_back(make_metrics());
+    }
+
+    // Process the blocks.
+    utils::parallel_for(blocks.size(), [this, &ir, &blocks](utils::UInt i) {
+        utils::Vec<MetricBase*> metrics;
+        for (const auto &metric : block_metrics[i]) {
+            metrics.push_back(&*metric);
+        }
+        MetricBase::process_block(metrics, ir, blocks[i]);
+    }, num_threads);
+
+    // Merge the results in program order.
+    for (const auto &metrics : block_metrics) {
+        for (utils::UInt j = 0; j < metrics.size(); j++) {
+            program_metrics[j]->merge(*metrics[j]);
+        }
+    }
+
+}
+
+/**
+ * Returns the number of blocks for which results are available.
+ */
+utils::UInt MetricSet::get_num_blocks() const {
+    return block_metrics.size();
+}
+
+} // namespace ana
+} // namespace com
+} // namespace ql
@@ -11,6 +11,181 @@ namespace ql {
 namespace com {
 namespace ana {
 
+/**
+ * Called for each block before its statements are processed. Default
+ * implementation is no-op.
+ */
+void MetricBase::enter_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block
+) {
+}
+
+/**
+ * Called for each statement before the statements in its sub-blocks (if any)
+ * are processed. Default implementation calls process_instruction() for
+ * instructions, including the initialize and update instructions of for
+ * loops.
+ */
+void MetricBase::enter_statement(
+    const ir::Ref &ir,
+    const ir::StatementRef &statement
+) {
+    if (statement->as_instruction()) {
+        process_instruction(ir, statement.as<ir::Instruction>());
+    } else if (auto for_loop = statement->as_for_loop()) {
+        if (!for_loop->initialize.empty()) {
+            process_instruction(ir, for_loop->initialize);
+        }
+        if (!for_loop->update.empty()) {
+            process_instruction(ir, for_loop->update);
+        }
+    }
+}
+
+/**
+ * Updates the metric using the given instruction. Default implementation
+ * throws an unimplemented exception.
+ */
+void MetricBase::process_instruction(
+    const ir::Ref &ir,
+    const ir::InstructionRef &instruction
+) {
+    throw utils::Exception("metric is not implemented for instructions");
+}
+
+/**
+ * Sets whether the statements in the body of static loops should be weighted
+ * by the trip count of the loop, so the metric reflects the work actually
+ * executed rather than the size of the code. Disabled by default.
+ */
+void MetricBase::set_multiply_static_loops(utils::Bool enable) {
+    multiply_static_loops = enable;
+}
+
+/**
+ * Updates the metric using the given statement, recursing into sub-blocks.
+ */
+void MetricBase::process_statement(
+    const ir::Ref &ir,
+    const ir::StatementRef &statement
+) {
+    process_statement(utils::Vec<MetricBase*>{this}, ir, statement);
+}
+
+/**
+ * Updates the metric using the given block, recursing into sub-blocks.
+ */
+void MetricBase::process_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block
+) {
+    process_block(utils::Vec<MetricBase*>{this}, ir, block);
+}
+
+/**
+ * Updates the metric using all blocks of the given program.
+ */
+void MetricBase::process_program(
+    const ir::Ref &ir,
+    const ir::ProgramRef &program
+) {
+    utils::Vec<MetricBase*> metrics{this};
+    for (const auto &block : program->blocks) {
+        process_block(metrics, ir, block);
+    }
+}
+
+/**
+ * Merges the result of the given metric, which must be of the same type and
+ * computed for a different block of the same program, into this one, such
+ * that the result is as if both blocks were processed by this metric. Default
+ * implementation throws an unimplemented exception. Metrics must override
+ * this according to how their results combine; SimpleValueMetric adds them.
+ */
+void MetricBase::merge(const MetricBase &other) {
+    throw utils::Exception("metric does not support merging");
+}
+
+/**
+ * Returns the number of iterations of the given static loop.
+ */
+static utils::UInt get_trip_count(const ir::StaticLoop &loop) {
+    return utils::abs<utils::Int>(loop.to->value - loop.frm->value) + 1;
+}
+
+/**
+ * Processes the given statement for all the given metrics in a single
+ * traversal.
+ */
+void MetricBase::process_statement(
+    const utils::Vec<MetricBase*> &metrics,
+    const ir::Ref &ir,
+    const ir::StatementRef &statement
+) {
+    for (auto metric : metrics) {
+        metric->enter_statement(ir, statement);
+    }
+    if (auto if_else = statement->as_if_else()) {
+        for (const auto &branch : if_else->branches) {
+            process_block(metrics, ir, branch->body);
+        }
+        if (!if_else->otherwise.empty()) {
+            process_block(metrics, ir, if_else->otherwise);
+        }
+    } else if (auto static_loop = statement->as_static_loop()) {
+        auto trip_count = get_trip_count(*static_loop);
+        for (auto metric : metrics) {
+            if (metric->multiply_static_loops) {
+                metric->weight *= trip_count;
+            }
+        }
+        process_block(metrics, ir, static_loop->body);
+        for (auto metric : metrics) {
+            if (metric->multiply_static_loops) {
+                metric->weight /= trip_count;
+            }
+        }
+    } else if (auto loop = statement->as_loop()) {
+        process_block(metrics, ir, loop->body);
+    } else if (
+        !statement->as_instruction() &&
+        !statement->as_loop_control_statement()
+    ) {
+        QL_ASSERT(false);
+    }
+}
+
+/**
+ * Processes the given block for all the given metrics in a single traversal.
+ */
+void MetricBase::process_block(
+    const utils::Vec<MetricBase*> &metrics,
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block
+) {
+    for (auto metric : metrics) {
+        metric->enter_block(ir, block);
+        metric->depth++;
+    }
+    for (const auto &statement : block->statements) {
+        process_statement(metrics, ir, statement);
+    }
+    for (auto metric : metrics) {
+        metric->depth--;
+    }
+}
+
+/**
+ * Statement counting metric.
+ */
+void StatementCount::enter_statement(
+    const ir::Ref &ir,
+    const ir::StatementRef &statement
+) {
+    value += weight;
+}
+
 /**
  * Classical operation counting metric.
  */
@@ -19,7 +194,7 @@ void ClassicalOperationCount::process_instruction(
     const ir::InstructionRef &instruction
 ) {
     if (instruction->as_set_instruction() || instruction->as_goto_instruction()) {
-        value++;
+        value += weight;
     }
 }
 
@@ -31,7 +206,7 @@ void QuantumGateCount::process_instruction(
     const ir::InstructionRef &instruction
 ) {
     if (ir::get_number_of_qubits_involved(instruction)) {
-        value++;
+        value += weight;
     }
 }
 
@@ -43,7 +218,7 @@ void MultiQubitGateCount::process_instruction(
     const ir::InstructionRef &instruction
 ) {
     if (ir::get_number_of_qubits_involved(instruction) > 1) {
-        value++;
+        value += weight;
     }
 }
 
@@ -63,7 +238,7 @@ void QubitUsageCount::process_instruction(
                 ref->indices[0]->as_int_literal()
             ) {
                 QL_ASSERT(ref->indices.size() == 1);
-                value[ref->indices[0]->as_int_literal()->value]++;
+                value[ref->indices[0]->as_int_literal()->value] += weight;
             }
         }
     }
@@ -86,17 +261,53 @@ void QubitUsedCycleCount::process_instruction(
             ) {
                 QL_ASSERT(ref->indices.size() == 1);
                 value[ref->indices[0]->as_int_literal()->value] +=
-                    get_duration_of_instruction(instruction);
+                    get_duration_of_instruction(instruction) * weight;
             }
         }
     }
 }
 
 /**
- * Returns the duration of a scheduled block in cycles.
+ * Qubit usage counting metric.
+ */
+void QubitUsageCount::merge(const MetricBase &other) {
+    for (const auto &it : dynamic_cast<const QubitUsageCount&>(other).value) {
+        value[it.first] += it.second;
+    }
+}
+
+/**
+ * Qubit cycle usage counting metric.
  */
-void Latency::process_block(const ir::Ref &ir, const ir::BlockBaseRef &block) {
-    value = ir::get_duration_of_block(block);
+void QubitUsedCycleCount::merge(const MetricBase &other) {
+    for (const auto &it : dynamic_cast<const QubitUsedCycleCount&>(other).value) {
+        value[it.first] += it.second;
+    }
+}
+
+/**
+ * Adds the duration of the top-level block(s) in cycles.
+ */
+void Latency::enter_block(const ir::Ref &ir, const ir::BlockBaseRef &block) {
+    if (!depth) {
+        value += ir::get_duration_of_block(block);
+    }
+}
+
+/**
+ * Adds the duration of all iterations of static loops, if static loops are
+ * multiplied. The loop statement itself counts as zero cycles in the duration
+ * of the enclosing block, and so do loops nested in the body, so the body is
+ * added once for every iteration.
+ */
+void Latency::enter_statement(const ir::Ref &ir, const ir::StatementRef &statement) {
+    if (!multiply_static_loops) {
+        return;
+    }
+    if (auto static_loop = statement->as_static_loop()) {
+        value += ir::get_duration_of_block(static_loop->body)
+               * get_trip_count(*static_loop) * weight;
+    }
 }
 
 } // namespace ana
@@ -0,0 +1,120 @@
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/ops.h"
+#include "ql/com/ana/metrics.h"
+#include "ql/com/ana/metric_set.h"
+
+using namespace ql;
+
+/**
+ * Makes a static loop with the given number of iterations and body.
+ */
+static utils::One<ir::StaticLoop> make_static_loop(
+    const ir::Ref &ir,
+    utils::Int num_iterations,
+    const utils::Any<ir::Statement> &body,
+    utils::Int cycle
+) {
+    auto loop = utils::make<ir::StaticLoop>();
+    loop->body = utils::make<ir::SubBlock>();
+    loop->body->statements = body;
+    loop->lhs = ir::make_reference(ir, ir::make_temporary(ir, ir->platform->default_int_type));
+    loop->frm = ir::make_int_lit(ir, 0);
+    loop->to = ir::make_int_lit(ir, num_iterations - 1);
+    loop->cycle = cycle;
+    return loop;
+}
+
+/**
+ * Returns a copy of the given statement at the given cycle.
+ */
+static ir::StatementRef copy_at(const ir::StatementRef &statement, utils::Int cycle) {
+    auto copy = statement->copy().as<ir::Statement>();
+    copy->cycle = cycle;
+    return copy;
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    auto kernel = utils::make<ir::compat::Kernel>("loop_kernel", plat, 7, 32, 10);
+    kernel->x(0);
+    program->add(kernel);
+    kernel = utils::make<ir::compat::Kernel>("flat_kernel", plat, 7, 32, 10);
+    kernel->x(0);
+    kernel->x(1);
+    program->add(kernel);
+    auto ir = ir::convert_old_to_new(program);
+
+    // Build the following structure in the first block, where each x takes D
+    // cycles:
+    //
+    //   cycle 0: x
+    //   cycle D: for 3 iterations {
+    //       cycle 0: x
+    //       cycle D: for 2 iterations {
+    //           cycle 0: x
+    //       }
+    //   }
+    const auto &block = ir->program->blocks[0];
+    auto x = block->statements[0];
+    auto d = ir::get_duration_of_statement(x);
+    QL_ASSERT(d > 0);
+    x->cycle = 0;
+    utils::Any<ir::Statement> inner_body;
+    inner_body.add(copy_at(x, 0));
+    utils::Any<ir::Statement> outer_body;
+    outer_body.add(copy_at(x, 0));
+    outer_body.add(make_static_loop(ir, 2, inner_body, d));
+    block->statements.add(make_static_loop(ir, 3, outer_body, d));
+
+    // The second block consists of two parallel x gates.
+    const auto &flat_block = ir->program->blocks[1];
+    for (const auto &statement : flat_block->statements) {
+        statement->cycle = 0;
+    }
+
+    // Without multiplication, structured statements count as zero cycles, and
+    // each statement is counted once.
+    QL_ASSERT_EQ(com::ana::compute_block<com::ana::Latency>(ir, block), d);
+    QL_ASSERT_EQ(com::ana::compute_block<com::ana::QuantumGateCount>(ir, block), 3);
+    QL_ASSERT_EQ(com::ana::compute_block<com::ana::StatementCount>(ir, block), 5);
+
+    // With multiplication, the body of the outer loop is executed 3 times and
+    // that of the inner loop 6 times, so the block takes D + 3D + 6D cycles.
+    com::ana::Latency latency;
+    latency.set_multiply_static_loops(true);
+    latency.process_block(ir, block);
+    QL_ASSERT_EQ(latency.get_result(), 10 * d);
+    com::ana::QuantumGateCount gates;
+    gates.set_multiply_static_loops(true);
+    gates.process_block(ir, block);
+    QL_ASSERT_EQ(gates.get_result(), 10);
+    com::ana::QubitUsedCycleCount used_cycles;
+    used_cycles.set_multiply_static_loops(true);
+    used_cycles.process_block(ir, block);
+    QL_ASSERT_EQ(used_cycles.get_result()[0], 10 * d);
+
+    // A metric set computes the same results in a single traversal, both per
+    // block and merged over the program, regardless of the number of threads.
+    for (utils::UInt num_threads = 1; num_threads <= 2; num_threads++) {
+        com::ana::MetricSet metrics;
+        auto set_latency = metrics.add<com::ana::Latency>();
+        auto set_latency_mul = metrics.add<com::ana::Latency>(true);
+        auto set_gates_mul = metrics.add<com::ana::QuantumGateCount>(true);
+        auto set_usage = metrics.add<com::ana::QubitUsageCount>();
+        metrics.compute_program(ir, num_threads);
+        QL_ASSERT_EQ(metrics.get_num_blocks(), 2);
+        QL_ASSERT_EQ(metrics.get_block_result(set_latency, 0), d);
+        QL_ASSERT_EQ(metrics.get_block_result(set_latency_mul, 0), 10 * d);
+        QL_ASSERT_EQ(metrics.get_block_result(set_latency, 1), d);
+        QL_ASSERT_EQ(metrics.get_program_result(set_latency), 2 * d);
+        QL_ASSERT_EQ(metrics.get_program_result(set_latency_mul), 11 * d);
+        QL_ASSERT_EQ(metrics.get_program_result(set_gates_mul), 12);
+        auto usage = metrics.get_program_result(set_usage);
+        QL_ASSERT_EQ(usage[0], 4);
+        QL_ASSERT_EQ(usage[1], 1);
+    }
+
+    return 0;
+}
@@ -483,7 +483,11 @@ public:
         // Graph annotation.
         source.emplace();
         sink.emplace();
-        block->set_annotation<Graph>({source, sink, 1});
+        block->set_annotation<Graph>({
+            source, sink, 1,
+            !gatherer.disable_multi_qubit_commutation,
+            !gatherer.disable_single_qubit_commutation
+        });
 
         // Process the statements.
         process_statement(source);
@@ -2,11 +2,91 @@
 #include "ql/ir/old_to_new.h"
 #include "ql/com/ddg/build.h"
 #include "ql/com/ddg/ops.h"
+#include "ql/com/ddg/update.h"
 #include "ql/com/ddg/consistency.h"
 #include "ql/com/ddg/dot.h"
 
 using namespace ql;
 
+/**
+ * Returns whether the DDG node of statement to can be reached from that of
+ * statement from.
+ */
+static utils::Bool reaches(const ir::StatementRef &from, const ir::StatementRef &to) {
+    utils::Set<ir::StatementRef> visited;
+    utils::List<ir::StatementRef> stack;
+    stack.push_back(from);
+    while (!stack.empty()) {
+        auto statement = stack.back();
+        stack.pop_back();
+        if (statement == to) {
+            return true;
+        }
+        if (!visited.insert(statement).second) {
+            continue;
+        }
+        for (const auto &successor : com::ddg::get_node(statement)->successors) {
+            stack.push_back(successor.first);
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns whether any object access of statement a does not commute with an
+ * object access of statement b.
+ */
+static utils::Bool conflicts(
+    const ir::Ref &ir,
+    const com::ddg::Graph &graph,
+    const ir::StatementRef &a,
+    const ir::StatementRef &b
+) {
+    com::ddg::EventGatherer gatherer(ir);
+    gatherer.disable_multi_qubit_commutation = !graph.commute_multi_qubit;
+    gatherer.disable_single_qubit_commutation = !graph.commute_single_qubit;
+    gatherer.add_statement(a);
+    auto a_events = gatherer.get();
+    gatherer.reset();
+    gatherer.add_statement(b);
+    for (const auto &a_event : a_events) {
+        for (const auto &b_event : gatherer.get()) {
+            if (!com::ddg::Event(a_event).commutes_with(com::ddg::Event(b_event))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Checks the incrementally updated DDG of the given block against a DDG built
+ * from scratch for a copy of the block. Every pair of statements that is
+ * ordered in the latter, which includes every pair of conflicting statements,
+ * must also be ordered in the former, and all statements must still be
+ * connected to the source and sink.
+ */
+static void check_against_build(const ir::Ref &ir, const ir::BlockBaseRef &block) {
+    com::ddg::check_consistency(block);
+    const auto &graph = block->get_annotation<com::ddg::Graph>();
+    auto fresh = block.clone();
+    com::ddg::build(ir, fresh, graph.commute_multi_qubit, graph.commute_single_qubit);
+    const auto &statements = block->statements;
+    for (utils::UInt i = 0; i < statements.size(); i++) {
+        QL_ASSERT(reaches(graph.source, statements[i]));
+        QL_ASSERT(reaches(statements[i], graph.sink));
+        for (utils::UInt j = i + 1; j < statements.size(); j++) {
+            auto ordered = reaches(fresh->statements[i], fresh->statements[j]);
+            if (conflicts(ir, graph, statements[i], statements[j])) {
+                QL_ASSERT(ordered);
+            }
+            if (ordered) {
+                QL_ASSERT(reaches(statements[i], statements[j]));
+            }
+        }
+    }
+}
+
 int main() {
     auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
     auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
@@ -26,11 +106,75 @@ int main() {
     kernel->z(0);
     program->add(kernel);
 
+    kernel = utils::make<ir::compat::Kernel>("link_kernel", plat, 7, 32, 10);
+    kernel->x(0);
+    kernel->cz(0, 1);
+    kernel->x(1);
+    program->add(kernel);
+
+    kernel = utils::make<ir::compat::Kernel>("commute_kernel", plat, 7, 32, 10);
+    kernel->x(0);
+    kernel->cz(0, 1);
+    kernel->z(1);
+    kernel->cnot(1, 2);
+    kernel->x(2);
+    kernel->cz(1, 2);
+    kernel->measure(1);
+    kernel->z(0);
+    kernel->cnot(0, 1);
+    kernel->x(1);
+    program->add(kernel);
+
     auto ir = ir::convert_old_to_new(program);
 
     com::ddg::build(ir, ir->program->blocks[0]);
     com::ddg::check_consistency(ir->program->blocks[0]);
     com::ddg::dump_dot(ir->program->blocks[0]);
+
+    // Update the graph incrementally and make sure it stays consistent.
+    const auto &block = ir->program->blocks[0];
+    ir::StatementRef statement = block->statements[2];
+    com::ddg::remove_statement(block, 2);
+    check_against_build(ir, block);
+    com::ddg::insert_statement(ir, block, 0, statement);
+    check_against_build(ir, block);
+    com::ddg::replace_statement(ir, block, 5, block->statements[8]->copy().as<ir::Statement>());
+    check_against_build(ir, block);
+    for (utils::UInt i = 0; i < block->statements.size(); i++) {
+        QL_ASSERT_EQ(com::ddg::get_node(block->statements[i])->order, (utils::Int)i + 1);
+    }
+    com::ddg::dump_dot(block);
+
+    // Remove a two-qubit gate that is the only link between the single-qubit
+    // gates before and after it and the sink and source respectively.
+    const auto &link_block = ir->program->blocks[1];
+    com::ddg::build(ir, link_block);
+    com::ddg::remove_statement(link_block, 1);
+    check_against_build(ir, link_block);
+    QL_ASSERT(com::ddg::get_edge(link_block->statements[0], com::ddg::get_sink(link_block)).has_value());
+    QL_ASSERT(com::ddg::get_edge(com::ddg::get_source(link_block), link_block->statements[1]).has_value());
+
+    // Update a block with commuting gates on multiple qubits with commutation
+    // enabled, such that pending accesses are retired by accesses that don't
+    // commute with them rather than only by writes.
+    const auto &commute_block = ir->program->blocks[2];
+    com::ddg::build(ir, commute_block, true, true);
+    check_against_build(ir, commute_block);
+    for (utils::UInt i = 0; i < commute_block->statements.size(); i++) {
+        ir::StatementRef removed = commute_block->statements[i];
+        com::ddg::remove_statement(commute_block, i);
+        check_against_build(ir, commute_block);
+        auto index = (i * 3) % (commute_block->statements.size() + 1);
+        com::ddg::insert_statement(ir, commute_block, index, removed);
+        check_against_build(ir, commute_block);
+        auto other = (i * 5 + 1) % commute_block->statements.size();
+        com::ddg::replace_statement(
+            ir, commute_block, other,
+            commute_block->statements[(other + 2) % commute_block->statements.size()]->copy().as<ir::Statement>()
+        );
+        check_against_build(ir, commute_block);
+    }
+
     com::ddg::reverse(ir->program->blocks[0]);
     com::ddg::check_consistency(ir->program->blocks[0]);
     com::ddg::dump_dot(ir->program->blocks[0]);
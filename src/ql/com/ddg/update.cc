@@ -0,0 +1,339 @@
+/** \file
+ * Defines functions for incrementally updating the data dependency graph of a
+ * block when statements are inserted, removed, or replaced.
+ */
+
+#include "ql/com/ddg/update.h"
+
+#include "ql/ir/ops.h"
+#include "ql/ir/describe.h"
+#include "ql/com/ddg/build.h"
+
+namespace ql {
+namespace com {
+namespace ddg {
+
+/**
+ * Returns the Graph annotation of the given block, after checking that it can
+ * be updated incrementally.
+ */
+static const Graph &get_updatable_graph(const ir::BlockBaseRef &block) {
+    auto graph = block->get_annotation_ptr<Graph>();
+    if (!graph) {
+        throw utils::Exception(
+            "cannot update data dependency graph: block does not have one"
+        );
+    }
+    if (graph->direction != 1) {
+        throw utils::Exception(
+            "cannot update data dependency graph: reversed graphs cannot be "
+            "updated incrementally"
+        );
+    }
+    return *graph;
+}
+
+/**
+ * Adds a data dependency edge between the given two statements with the given
+ * cause, or adds the cause to the existing edge if there already was one. The
+ * duration of the "from" statement is used as weight.
+ */
+static void add_edge(
+    const ir::StatementRef &from,
+    const ir::StatementRef &to,
+    const Cause &cause
+) {
+    auto from_node = from->get_annotation<NodeRef>();
+    auto to_node = to->get_annotation<NodeRef>();
+
+    // Create an edge, or fetch the existing edge if there already was one.
+    auto result = from_node->successors.insert({to, {}});
+    auto &edge_ref = result.first->second;
+    if (result.second) {
+        QL_DOUT(
+            "    add edge from " << ir::describe(from) <<
+            " to " << ir::describe(to)
+        );
+        edge_ref.emplace();
+        edge_ref->predecessor = from;
+        edge_ref->successor = to;
+        edge_ref->weight = 0;
+        QL_ASSERT(to_node->predecessors.insert({from, edge_ref}).second);
+    }
+
+    // Ensure that the edge weight is high enough.
+    edge_ref->weight = utils::max<utils::Int>(
+        edge_ref->weight,
+        (utils::Int)ir::get_duration_of_statement(from)
+    );
+
+    // Add the cause to the edge.
+    edge_ref->causes.push_back(cause);
+
+}
+
+/**
+ * Returns the object access events for the given statement.
+ */
+static utils::List<Event> get_events(
+    EventGatherer &gatherer,
+    const ir::StatementRef &statement
+) {
+    gatherer.reset();
+    gatherer.add_statement(statement);
+    utils::List<Event> events;
+    for (const auto &event : gatherer.get()) {
+        events.emplace_back(event);
+    }
+    return events;
+}
+
+/**
+ * Adds the edges from the statements before the statement at the given index
+ * to it (if after is false), or from it to the statements after it (if after
+ * is true), for the given events of the statement.
+ *
+ * The neighboring statements are visited from the nearest to the farthest,
+ * ending with the source or sink. If a visited statement has an event that
+ * does not commute with an event of a statement that was already connected,
+ * the existing graph must already order the two, so no edge is needed.
+ * Otherwise, its events that don't commute with a pending event of the
+ * statement get an edge. A pending event is retired as soon as it is shadowed
+ * by an event of a connected statement, i.e. when that event does not commute
+ * with it and accesses a superset of the accessed object, because then all
+ * further accesses to that object are ordered with respect to that event. This
+ * is the same criterion that build() uses.
+ */
+static void connect_statement(
+    EventGatherer &gatherer,
+    const Graph &graph,
+    const ir::BlockBaseRef &block,
+    utils::UInt index,
+    utils::List<Event> pending,
+    utils::Bool after
+) {
+    const auto &statement = block->statements[index];
+    utils::UInt num_neighbors = after ? block->statements.size() - index - 1 : index;
+    utils::List<Event> connected;
+    for (utils::UInt i = 0; i <= num_neighbors && !pending.empty(); i++) {
+        ir::StatementRef neighbor;
+        if (i == num_neighbors) {
+            if (after) {
+                neighbor = graph.sink;
+            } else {
+                neighbor = graph.source;
+            }
+        } else if (after) {
+            neighbor = block->statements[index + 1 + i];
+        } else {
+            neighbor = block->statements[index - 1 - i];
+        }
+        QL_DOUT("  visit " << ir::describe(neighbor));
+
+        // If any event of the neighbor does not commute with an event of a
+        // connected statement, the neighbor is already ordered with respect
+        // to the statement. Otherwise, add edges for the events that don't
+        // commute with a pending event.
+        auto neighbor_events = get_events(gatherer, neighbor);
+        utils::Bool ordered = false;
+        for (const auto &neighbor_event : neighbor_events) {
+            for (const auto &event : connected) {
+                if (!event.commutes_with(neighbor_event)) {
+                    ordered = true;
+                    break;
+                }
+            }
+            if (ordered) break;
+        }
+        if (!ordered) {
+            for (const auto &neighbor_event : neighbor_events) {
+                for (const auto &event : pending) {
+                    if (event.commutes_with(neighbor_event)) continue;
+                    Reference reference = event.reference.intersect_with(neighbor_event.reference);
+                    if (after) {
+                        add_edge(statement, neighbor, {reference, {event.mode, neighbor_event.mode}});
+                    } else {
+                        add_edge(neighbor, statement, {reference, {neighbor_event.mode, event.mode}});
+                    }
+                    ordered = true;
+                }
+            }
+        }
+        if (!ordered) continue;
+
+        // The neighbor is now ordered with respect to the statement. Retire
+        // the pending events that are fully shadowed by one of its events.
+        for (const auto &neighbor_event : neighbor_events) {
+            auto it = pending.begin();
+            while (it != pending.end()) {
+                if (it->is_shadowed_by(neighbor_event)) {
+                    it = pending.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            connected.push_back(neighbor_event);
+        }
+
+    }
+}
+
+/**
+ * Renumbers the order of the nodes of the statements from the given index
+ * onward, as well as that of the sink, such that they match the position of
+ * the statements in the block again.
+ */
+static void renumber(
+    const Graph &graph,
+    const ir::BlockBaseRef &block,
+    utils::UInt index
+) {
+    for (utils::UInt i = index; i < block->statements.size(); i++) {
+        block->statements[i]->get_annotation<NodeRef>()->order = (utils::Int)i + 1;
+    }
+    graph.sink->get_annotation<NodeRef>()->order = (utils::Int)block->statements.size() + 1;
+}
+
+/**
+ * Inserts the given statement into the given block at the given index, and
+ * adds it to the block's data dependency graph. Only the statements around
+ * the insertion point that access the objects accessed by the new statement
+ * are considered: the block is scanned backward and forward from the index
+ * until each object access of the new statement is ordered by an edge with a
+ * statement whose access to a superset of the object does not commute with
+ * it, or until the source or sink is reached.
+ *
+ * The graph must have been constructed using build() and must not be reversed.
+ * The resulting graph respects all data dependencies, but it may contain more
+ * edges than a graph built from scratch, as edges made redundant by the new
+ * statement are not removed.
+ */
+void insert_statement(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    utils::UInt index,
+    const ir::StatementRef &statement
+) {
+    const auto &graph = get_updatable_graph(block);
+    if (index > block->statements.size()) {
+        throw utils::Exception(
+            "cannot insert statement at index " + utils::to_string(index) +
+            " of block with " + utils::to_string(block->statements.size()) +
+            " statements"
+        );
+    }
+    QL_DOUT("insert statement: " << ir::describe(statement));
+
+    // Add the statement and its node.
+    block->statements.add(statement, (utils::Int)index);
+    NodeRef node;
+    node.emplace();
+    statement->set_annotation<NodeRef>(node);
+    renumber(graph, block, index);
+
+    // Connect it to the statements around it.
+    EventGatherer gatherer(ir);
+    gatherer.disable_multi_qubit_commutation = !graph.commute_multi_qubit;
+    gatherer.disable_single_qubit_commutation = !graph.commute_single_qubit;
+    auto events = get_events(gatherer, statement);
+    connect_statement(gatherer, graph, block, index, events, false);
+    connect_statement(gatherer, graph, block, index, events, true);
+
+}
+
+/**
+ * Removes the statement at the given index from the given block and from the
+ * block's data dependency graph. The dependencies that ran through the removed
+ * statement are preserved by connecting its predecessors to its successors
+ * where the causes of the respective edges refer to overlapping objects.
+ *
+ * The graph must have been constructed using build() and must not be reversed.
+ * The resulting graph respects all data dependencies, but it may be more
+ * conservative than a graph built from scratch.
+ */
+void remove_statement(
+    const ir::BlockBaseRef &block,
+    utils::UInt index
+) {
+    const auto &graph = get_updatable_graph(block);
+    if (index >= block->statements.size()) {
+        throw utils::Exception(
+            "cannot remove statement at index " + utils::to_string(index) +
+            " of block with " + utils::to_string(block->statements.size()) +
+            " statements"
+        );
+    }
+    ir::StatementRef statement = block->statements[index];
+    QL_DOUT("remove statement: " << ir::describe(statement));
+
+    // Detach the node from its neighbors.
+    auto node = statement->get_annotation<NodeRef>();
+    for (const auto &predecessor : node->predecessors) {
+        predecessor.first->get_annotation<NodeRef>()->successors.erase(statement);
+    }
+    for (const auto &successor : node->successors) {
+        successor.first->get_annotation<NodeRef>()->predecessors.erase(statement);
+    }
+
+    // Bridge the dependencies that ran through the removed statement. The
+    // access modes of the predecessor and successor may commute, but the
+    // edge is still needed to keep whatever the predecessor depends on
+    // ordered with respect to the successor.
+    for (const auto &predecessor : node->predecessors) {
+        for (const auto &successor : node->successors) {
+            for (const auto &in_cause : predecessor.second->causes) {
+                for (const auto &out_cause : successor.second->causes) {
+                    if (in_cause.reference.is_provably_distinct_from(out_cause.reference)) {
+                        continue;
+                    }
+                    add_edge(predecessor.first, successor.first, {
+                        in_cause.reference.intersect_with(out_cause.reference),
+                        {
+                            in_cause.dependency_type.first_mode,
+                            out_cause.dependency_type.second_mode
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    // Statements that were only ordered with respect to distinct parts of
+    // the objects accessed by the removed statement may have lost their last
+    // predecessor or successor. Connect those to the source or sink.
+    for (const auto &predecessor : node->predecessors) {
+        if (predecessor.first->get_annotation<NodeRef>()->successors.empty()) {
+            add_edge(predecessor.first, graph.sink, {{}, {AccessMode::write(), AccessMode::write()}});
+        }
+    }
+    for (const auto &successor : node->successors) {
+        if (successor.first->get_annotation<NodeRef>()->predecessors.empty()) {
+            add_edge(graph.source, successor.first, {{}, {AccessMode::write(), AccessMode::write()}});
+        }
+    }
+
+    // Remove the statement and its node.
+    statement->erase_annotation<NodeRef>();
+    block->statements.remove((utils::Int)index);
+    renumber(graph, block, index);
+
+}
+
+/**
+ * Replaces the statement at the given index of the given block with the given
+ * statement, updating the block's data dependency graph accordingly. This is
+ * equivalent to remove_statement() followed by insert_statement().
+ */
+void replace_statement(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    utils::UInt index,
+    const ir::StatementRef &statement
+) {
+    remove_statement(block, index);
+    insert_statement(ir, block, index, statement);
+}
+
+} // namespace ddg
+} // namespace com
+} // namespace ql
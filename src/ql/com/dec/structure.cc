@@ -65,6 +65,15 @@ private:
      */
     utils::Set<utils::Str> used_names;
 
+    /**
+     * The blocks in the blocks list that received instructions that were
+     * generated during structure expansion or whose cycle numbers changed.
+     * Only these blocks can be inconsistent if the incoming program was
+     * consistent; all other blocks contain a contiguous range of statements of
+     * an incoming toplevel block, with unchanged cycle numbers.
+     */
+    utils::Set<ir::BlockRef> modified;
+
     /**
      * Name stack for the original program as we're traversing it. The names of
      * new blocks are generated based on the name at the back of this list.
@@ -165,9 +174,13 @@ private:
 
     /**
      * Processes the program for the given IR node. This must only be called
-     * once!
+     * once! The blocks of the returned program that may have become
+     * inconsistent are appended to modified_blocks.
      */
-    ir::ProgramRef process_program(const ir::Ref &incoming_ir);
+    ir::ProgramRef process_program(
+        const ir::Ref &incoming_ir,
+        utils::Vec<ir::BlockRef> &modified_blocks
+    );
 
     /**
      * Default constructor.
@@ -177,9 +190,13 @@ private:
 public:
 
     /**
-     * Runs structure decomposition.
+     * Runs structure decomposition. The blocks of the returned program that
+     * may have become inconsistent are appended to modified_blocks.
      */
-    static ir::ProgramRef run(const ir::Ref &ir);
+    static ir::ProgramRef run(
+        const ir::Ref &ir,
+        utils::Vec<ir::BlockRef> &modified_blocks
+    );
 
 };
 
@@ -309,6 +326,9 @@ void StructureDecomposer::process_instruction(const ir::InstructionRef &insn) {
     // Add the instruction to the last block.
     insn->cycle += cycle_offset;
     blocks.back()->statements.add(insn);
+    if (cycle_offset) {
+        modified.insert(blocks.back());
+    }
 
 }
 
@@ -320,6 +340,7 @@ void StructureDecomposer::process_new_instruction(const ir::InstructionRef &insn
     cycle_offset = (utils::Int)ir::get_duration_of_block(blocks.back());
     insn->cycle = 0;
     process_statement(insn);
+    modified.insert(blocks.back());
 }
 
 /**
@@ -627,9 +648,13 @@ ir::BlockRef StructureDecomposer::update_block_reference(const ir::BlockRef &blo
 
 /**
  * Processes the program for the given IR node. This must only be called
- * once!
+ * once! The blocks of the returned program that may have become inconsistent
+ * are appended to modified_blocks.
  */
-ir::ProgramRef StructureDecomposer::process_program(const ir::Ref &incoming_ir) {
+ir::ProgramRef StructureDecomposer::process_program(
+    const ir::Ref &incoming_ir,
+    utils::Vec<ir::BlockRef> &modified_blocks
+) {
 
     // Save the IR node for further processing.
     QL_ASSERT(ir.empty());
@@ -663,16 +688,23 @@ ir::ProgramRef StructureDecomposer::process_program(const ir::Ref &incoming_ir)
     new_program->blocks.reset();
     for (const auto &block : blocks) {
         new_program->blocks.add(block);
+        if (modified.count(block)) {
+            modified_blocks.push_back(block);
+        }
     }
 
     return std::move(new_program);
 }
 
 /**
- * Runs structure decomposition.
+ * Runs structure decomposition. The blocks of the returned program that may
+ * have become inconsistent are appended to modified_blocks.
  */
-ir::ProgramRef StructureDecomposer::run(const ir::Ref &ir) {
-    return StructureDecomposer().process_program(ir);
+ir::ProgramRef StructureDecomposer::run(
+    const ir::Ref &ir,
+    utils::Vec<ir::BlockRef> &modified_blocks
+) {
+    return StructureDecomposer().process_program(ir, modified_blocks);
 }
 
 /**
@@ -693,13 +725,16 @@ ir::ProgramRef StructureDecomposer::run(const ir::Ref &ir) {
  * the loglevel.
  */
 ir::ProgramRef decompose_structure(const ir::Ref &ir, utils::Bool check) {
-    auto program = StructureDecomposer::run(ir);
+    utils::Vec<ir::BlockRef> modified_blocks;
+    auto program = StructureDecomposer::run(ir, modified_blocks);
 
-    // If we're in debug mode, check postconditions.
+    // If we're in debug mode, check postconditions. Only the blocks that
+    // received generated instructions or renumbered statements need their
+    // contents checked.
     if (QL_IS_LOG_DEBUG || check) {
         auto new_ir = ir.copy();
         new_ir->program = program;
-        ir::check_consistency(new_ir);
+        ir::check_consistency(new_ir, modified_blocks);
         check_basic_block_form(program);
     };
 
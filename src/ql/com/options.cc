@@ -144,6 +144,63 @@ Options make_ql_options() {
         "pass option common to all passes instead."
     );
 
+    //========================================================================//
+    // Profiling                                                              //
+    //========================================================================//
+
+    options.add_bool(
+        "profile_passes",
+        "When set, the pass manager measures the wall-clock time, CPU time, "
+        "growth of the peak resident set size, number of statements before "
+        "and after, and number of old/new IR conversions for every pass, pass "
+        "group, and pass loop iteration. The results are written to "
+        "`<output_dir>/<program>_profile.json` as plain JSON and to "
+        "`<output_dir>/<program>_profile.trace.json` in the Chrome trace-event "
+        "format (loadable in chrome://tracing or Perfetto), and a summary is "
+        "logged at info level."
+    );
+
+    //========================================================================//
+    // Memory management                                                      //
+    //========================================================================//
+
+    options.add_bool(
+        "ir_node_arena",
+        "When set, the pass manager allocates the IR tree nodes created by "
+        "passes from a pooled arena rather than allocating each node "
+        "individually on the heap. This reduces allocation overhead for large "
+        "programs. The arena is attached to the program and released in bulk "
+        "when the program is destroyed. Allocation statistics are logged at "
+        "info level."
+    );
+
+    //========================================================================//
+    // Parallelism and internal checks                                        //
+    //========================================================================//
+
+    options.add_int(
+        "num_threads",
+        "Maximum number of threads used by the parts of the compiler that "
+        "have been parallelized. The default of 1 disables multithreading; "
+        "0 means the hardware concurrency is used.",
+        "1", 0, 1024
+    );
+
+    options.add_enum(
+        "consistency_checks",
+        "Controls how much internal consistency checking is done on the IR "
+        "after conversions between the old and new IR, after reading cQASM "
+        "files, and after structure decomposition. `off` disables the checks, "
+        "`cheap` only checks the constraints that don't require traversing "
+        "all statements and expressions (platform ordering and completeness, "
+        "block names, and the program entry point), and `full` checks "
+        "everything, using multiple threads for the blocks of the program. "
+        "Internal errors that would otherwise be caught by these checks may "
+        "result in undefined behavior when checks are disabled.",
+        "full",
+        {"off", "cheap", "full"}
+    );
+
     //========================================================================//
     // Default-inserted scheduler behavior                                    //
     //========================================================================//
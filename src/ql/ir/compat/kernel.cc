@@ -541,40 +541,20 @@ Bool Kernel::add_custom_gate_if_available(
         return false;   // return, so a default gate will be attempted
     }
 #endif
-    // construct canonical name
-    Str instr = "";
-    for (auto qubit : qubits) {
-        if (!instr.empty()) {
-            instr += ",";
-        }
-        instr += "q" + to_string(qubit);
-    }
-    instr = gname + " " + instr;
-
-    // first check if a specialized custom gate is available
-    // a specialized custom gate is of the form: "cz q0 q3"
-    auto it = platform->instruction_map.find(instr);
-    if (it == platform->instruction_map.end()) {
-        it = platform->instruction_map.find(gname);
-    }
-    if (it == platform->instruction_map.end()) {
+    // first check if a specialized custom gate is available, of the form
+    // "cz q0,q3", and otherwise whether a generic one is; the platform indexes
+    // these by name and qubits, so we don't need to construct the canonical
+    // instruction name
+    auto custom = platform->find_custom_gate(gname, qubits);
+    if (custom.empty()) {
         QL_DOUT("custom gate not added for " << gname);
         return false;
     }
 
-    auto g = GateRef::make<gate_types::Custom>(*(it->second));
-    g->operands.clear();
-    for (auto qubit : qubits) {
-        g->operands.push_back(qubit);
-    }
-    g->creg_operands.clear();
-    for (auto &cop : cregs) {
-        g->creg_operands.push_back(cop);
-    }
-    g->breg_operands.clear();
-    for (auto &bop : bregs) {
-        g->breg_operands.push_back(bop);
-    }
+    auto g = GateRef::make<gate_types::Custom>(*custom);
+    g->operands = qubits;
+    g->creg_operands = cregs;
+    g->breg_operands = bregs;
     if (duration > 0) {
         g->duration = duration;
     }
@@ -0,0 +1,177 @@
+/** \file
+ * Hand-written tokenizer for the instruction names and decomposition keys used
+ * in platform configuration files, and for other names coming from the old IR.
+ */
+
+#include "ql/ir/compat/names.h"
+
+#include <cctype>
+
+namespace ql {
+namespace ir {
+namespace compat {
+
+using namespace utils;
+
+/**
+ * Returns whether the given character is whitespace, i.e. matches \s.
+ */
+Bool is_name_space(char c) {
+    switch (c) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\v':
+        case '\f':
+        case '\r':
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns whether the given character separates the parts of an instruction
+ * name, i.e. matches [\s,].
+ */
+static Bool is_name_separator(char c) {
+    return c == ',' || is_name_space(c);
+}
+
+/**
+ * Returns the lowercase version of the given character.
+ */
+static char to_lower_char(char c) {
+    return (char)std::tolower((unsigned char)c);
+}
+
+/**
+ * Returns the range of the given string without leading and trailing
+ * whitespace as a begin/end index pair.
+ */
+static void trim_range(const Str &str, UInt &begin, UInt &end) {
+    begin = 0;
+    end = str.size();
+    while (begin < end && is_name_space(str[begin])) begin++;
+    while (end > begin && is_name_space(str[end - 1])) end--;
+}
+
+/**
+ * Normalizes an instruction name or decomposition key from a platform
+ * configuration file, i.e. the key format used for the instruction map of the
+ * old platform. The name is converted to lower case, leading and trailing
+ * whitespace is removed, sequences of whitespace are collapsed to a single
+ * space, and whitespace around commas is removed. This is equivalent to
+ * applying the replacements `^\s+|\s+$` -> ``, `\s+` -> ` `, and `\s*,\s*` ->
+ * `,` in that order. For example, `" CZ  q0 , q1 "` becomes `"cz q0,q1"`.
+ */
+Str normalize_instruction_name(const Str &name) {
+    UInt begin, end;
+    trim_range(name, begin, end);
+    Str result;
+    result.reserve(end - begin);
+    UInt i = begin;
+    while (i < end) {
+        if (!is_name_separator(name[i])) {
+            result += to_lower_char(name[i++]);
+            continue;
+        }
+
+        // A run of whitespace and commas is replaced with one comma per comma
+        // in the run, or with a single space if there are no commas.
+        UInt commas = 0;
+        while (i < end && is_name_separator(name[i])) {
+            if (name[i++] == ',') commas++;
+        }
+        if (commas) {
+            result.append(commas, ',');
+        } else {
+            result += ' ';
+        }
+
+    }
+    return result;
+}
+
+/**
+ * Splits an instruction name or decomposition key from a platform
+ * configuration file into the instruction name followed by its
+ * specialization/decomposition template parameters. The name is converted to
+ * lower case, leading and trailing whitespace is ignored, and the parts are
+ * separated by any sequence of whitespace and commas. This is equivalent to
+ * applying the replacements `^\s+|\s+$` -> `` and `[\s,]+` -> ` ` and then
+ * splitting on spaces. The result always contains at least one element.
+ */
+List<Str> split_instruction_name(const Str &name) {
+    UInt begin, end;
+    trim_range(name, begin, end);
+    List<Str> parts;
+    UInt i = begin;
+    while (true) {
+        Str part;
+        while (i < end && !is_name_separator(name[i])) {
+            part += to_lower_char(name[i++]);
+        }
+        parts.push_back(std::move(part));
+        if (i >= end) break;
+        while (i < end && is_name_separator(name[i])) i++;
+    }
+    return parts;
+}
+
+/**
+ * Returns whether the given instruction parameter is a register reference of
+ * the form `[qbc][0-9]+`.
+ */
+Bool is_register_operand(const Str &operand) {
+    if (operand.size() < 2) return false;
+    if (operand[0] != 'q' && operand[0] != 'b' && operand[0] != 'c') return false;
+    for (UInt i = 1; i < operand.size(); i++) {
+        if (operand[i] < '0' || operand[i] > '9') return false;
+    }
+    return true;
+}
+
+/**
+ * Returns whether the given character may appear in an identifier.
+ */
+static Bool is_identifier_char(char c) {
+    return (c >= 'a' && c <= 'z')
+        || (c >= 'A' && c <= 'Z')
+        || (c >= '0' && c <= '9')
+        || c == '_';
+}
+
+/**
+ * Returns whether the given string is a valid identifier for the new IR, i.e.
+ * whether it matches `[a-zA-Z_][a-zA-Z0-9_]*`.
+ */
+Bool is_identifier(const Str &str) {
+    if (str.empty() || (str[0] >= '0' && str[0] <= '9')) return false;
+    for (auto c : str) {
+        if (!is_identifier_char(c)) return false;
+    }
+    return true;
+}
+
+/**
+ * Turns an arbitrary string into a valid identifier for the new IR by
+ * replacing all characters other than `[a-zA-Z0-9_]` with underscores, and
+ * prefixing an underscore if the result would otherwise be empty or start with
+ * a digit.
+ */
+Str make_identifier(const Str &str) {
+    Str result;
+    result.reserve(str.size() + 1);
+    if (str.empty() || (str[0] >= '0' && str[0] <= '9')) {
+        result += '_';
+    }
+    for (auto c : str) {
+        result += is_identifier_char(c) ? c : '_';
+    }
+    return result;
+}
+
+} // namespace compat
+} // namespace ir
+} // namespace ql
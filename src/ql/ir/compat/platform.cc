@@ -4,11 +4,17 @@
 
 #include "ql/ir/compat/platform.h"
 
-#include <regex>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <tuple>
 #include "ql/config.h"
+#include "ql/version.h"
 #include "ql/utils/filesystem.h"
 #include "ql/rmgr/manager.h"
 #include "ql/arch/factory.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/compat/names.h"
 
 namespace ql {
 namespace ir {
@@ -412,20 +418,6 @@ void Platform::dump_docs(std::ostream &os, const utils::Str &line_prefix) {
     )");
 }
 
-static const std::regex trim_pattern("^(\\s)+|(\\s)+$");
-static const std::regex multiple_space_pattern("(\\s)+");
-
-/**
- * Sanitizes the name of an instruction by converting to lower case and removing
- * the unnecessary spaces.
- */
-static utils::Str sanitize_instruction_name(utils::Str name) {
-    name = utils::to_lower(name);
-    name = std::regex_replace(name, trim_pattern, "");
-    name = std::regex_replace(name, multiple_space_pattern, " ");
-    return name;
-}
-
 static GateRef load_instruction(
     const utils::Str &name,
     utils::Json &instr,
@@ -451,6 +443,64 @@ static GateRef load_instruction(
     return g;
 }
 
+/**
+ * Parses the operand list of a specialized instruction name, i.e. the part
+ * after the last space in "<name> q<i>,q<j>,...", into qubit indices. Only
+ * canonically formatted lists (no leading zeros) are accepted, because only
+ * those can match the name that Kernel::add_custom_gate_if_available() used
+ * to construct for the lookup. Returns false if the list is not of this form.
+ */
+static utils::Bool parse_specialized_qubits(
+    const utils::Str &operands,
+    utils::Vec<utils::UInt> &qubits
+) {
+    qubits.clear();
+    utils::UInt pos = 0;
+    while (true) {
+        auto end = operands.find(',', pos);
+        if (end == utils::Str::npos) {
+            end = operands.size();
+        }
+        if (end - pos < 2 || operands[pos] != 'q') {
+            return false;
+        }
+        if (operands[pos + 1] == '0' && end - pos > 2) {
+            return false;
+        }
+        utils::UInt qubit = 0;
+        for (auto i = pos + 1; i < end; i++) {
+            if (operands[i] < '0' || operands[i] > '9') {
+                return false;
+            }
+            qubit = qubit * 10 + (operands[i] - '0');
+        }
+        qubits.push_back(qubit);
+        if (end == operands.size()) {
+            return true;
+        }
+        pos = end + 1;
+    }
+}
+
+/**
+ * (Re)builds custom_gate_index from instruction_map.
+ */
+void Platform::build_custom_gate_index() {
+    custom_gate_index.clear();
+    utils::Vec<utils::UInt> qubits;
+    for (const auto &it : instruction_map) {
+        custom_gate_index[it.first].generic = it.second;
+        auto space = it.first.rfind(' ');
+        if (space == utils::Str::npos) {
+            continue;
+        }
+        if (parse_specialized_qubits(it.first.substr(space + 1), qubits)) {
+            custom_gate_index[it.first.substr(0, space)].specialized.set(qubits) = it.second;
+        }
+    }
+    custom_gate_index_size = instruction_map.size();
+}
+
 /**
  * Loads the platform members from the given JSON data and optional
  * auxiliary compiler configuration file.
@@ -540,6 +590,16 @@ void Platform::load(
     // Do architecture-specific preprocessing before anything else.
     architecture->preprocess_platform(platform_config);
 
+    load_preprocessed();
+}
+
+/**
+ * Loads the platform members from platform_config, after the architecture and
+ * compiler settings have been determined and platform_config has been
+ * preprocessed by the architecture.
+ */
+void Platform::load_preprocessed() {
+
     // load hardware_settings
     if (platform_config.count("hardware_settings") <= 0) {
         QL_FATAL("'hardware_settings' section is not specified in the hardware config file");
@@ -597,14 +657,12 @@ void Platform::load(
 
     // load instructions
     const utils::Json &instructions = platform_config["instructions"];
-    static const std::regex comma_space_pattern("\\s*,\\s*");
 
     for (auto it = instructions.begin(); it != instructions.end(); ++it) {
         utils::Str instr_name = it.key();
         utils::Json attr = *it; //.value();
 
-        instr_name = sanitize_instruction_name(instr_name);
-        instr_name = std::regex_replace(instr_name, comma_space_pattern, ",");
+        instr_name = normalize_instruction_name(instr_name);
 
         // check for duplicate operations
         if (instruction_map.find(instr_name) != instruction_map.end()) {
@@ -637,8 +695,7 @@ void Platform::load(
             utils::Str comp_ins = it.key();
             QL_DOUT("");
             QL_DOUT("Adding composite instr : " << comp_ins);
-            comp_ins = sanitize_instruction_name(comp_ins);
-            comp_ins = std::regex_replace(comp_ins, comma_space_pattern, ",");
+            comp_ins = normalize_instruction_name(comp_ins);
             QL_DOUT("Adjusted composite instr : " << comp_ins);
 
             // format in json.instructions:
@@ -671,8 +728,7 @@ void Platform::load(
                 // standardize name of sub instruction
                 utils::Str sub_ins = sub_instructions[i];
                 QL_DOUT("Adding sub instr: " << sub_ins);
-                sub_ins = sanitize_instruction_name(sub_ins);
-                sub_ins = std::regex_replace(sub_ins, comma_space_pattern, ",");
+                sub_ins = normalize_instruction_name(sub_ins);
                 if (instruction_map.find(sub_ins) != instruction_map.end()) {
                     // using existing sub ins, e.g. "x q0" or "x %0"
                     QL_DOUT("using existing sub instr : " << sub_ins);
@@ -704,6 +760,13 @@ void Platform::load(
         }
     }
 
+    // Index the instructions for fast gate construction.
+    build_custom_gate_index();
+
+    // Hash the configuration once, so it needn't be dumped again to identify
+    // it.
+    platform_config_hash = std::hash<utils::Str>()(platform_config.dump());
+
 }
 
 /**
@@ -721,12 +784,21 @@ Platform::Platform(
     // query the default configuration for that architecture. Otherwise
     // interpret it as a filename, which it's historically always been.
     utils::Json config;
-    utils::Str platform_config_fname;
     architecture = arch_factory.build_from_namespace(platform_config);
     if (architecture.has_value()) {
         std::istringstream is{architecture->get_default_platform()};
         config = utils::parse_json(is);
         platform_config_fname = "";
+    } else if (is_preprocessed_config(platform_config)) {
+        if (!compiler_config.empty()) {
+            QL_FATAL(
+                "a compiler configuration file cannot be combined with a "
+                "preprocessed platform configuration; specify it when "
+                "creating the preprocessed configuration instead"
+            );
+        }
+        load_preprocessed_config(platform_config);
+        return;
     } else {
         try {
             config = utils::load_json(platform_config);
@@ -782,6 +854,214 @@ PlatformRef Platform::build(
     return ref;
 }
 
+/**
+ * Magic string at the start of preprocessed platform configuration files,
+ * followed by the CBOR encoding of the configuration.
+ */
+static const char PREPROCESSED_CONFIG_MAGIC[] = "OpenQL preprocessed platform configuration\n";
+static const utils::UInt PREPROCESSED_CONFIG_MAGIC_SIZE = sizeof(PREPROCESSED_CONFIG_MAGIC) - 1;
+
+/**
+ * Returns whether the given file is a preprocessed platform configuration
+ * file, as written by save_preprocessed_config(). Such files can be used in
+ * place of a platform configuration filename.
+ */
+utils::Bool Platform::is_preprocessed_config(const utils::Str &fname) {
+    std::ifstream ifs(fname, std::ios::binary);
+    if (!ifs.is_open()) {
+        return false;
+    }
+    utils::Str magic(PREPROCESSED_CONFIG_MAGIC_SIZE, '\0');
+    ifs.read(&magic[0], PREPROCESSED_CONFIG_MAGIC_SIZE);
+    return ifs && magic == PREPROCESSED_CONFIG_MAGIC;
+}
+
+/**
+ * Writes the preprocessed platform configuration to the given file, as a cache
+ * for loading the same platform again. The file is a binary (CBOR) encoding of
+ * the platform configuration after compiler configuration files have been
+ * resolved and architecture-specific preprocessing has been applied. Loading
+ * it only skips JSON parsing, resolution of the compiler configuration, and
+ * preprocessing; everything that is built from the configuration (instruction
+ * map, topology, resources, and the conversion to the new IR) is still built
+ * as usual. Such files can only be loaded by the same version of OpenQL that
+ * wrote them.
+ */
+void Platform::save_preprocessed_config(const utils::Str &fname) const {
+    utils::Json cache;
+    cache["version"] = OPENQL_VERSION_STRING;
+    cache["architecture"] = architecture->family->get_namespace_name() + "." + architecture->variant;
+    cache["compiler_settings"] = compiler_settings;
+    cache["platform"] = platform_config;
+    cache["platform_config_fname"] = platform_config_fname;
+    auto data = utils::Json::to_cbor(cache);
+
+    std::ofstream ofs(fname, std::ios::binary);
+    if (!ofs.is_open()) {
+        QL_FATAL("failed to open file '" << fname << "' for writing");
+    }
+    ofs.write(PREPROCESSED_CONFIG_MAGIC, PREPROCESSED_CONFIG_MAGIC_SIZE);
+    ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!ofs) {
+        QL_FATAL("failed to write preprocessed platform configuration '" << fname << "'");
+    }
+}
+
+/**
+ * Loads the platform members from the preprocessed platform configuration file
+ * with the given name, as written by save_preprocessed_config().
+ */
+void Platform::load_preprocessed_config(const utils::Str &fname) {
+    std::ifstream ifs(fname, std::ios::binary);
+    if (!ifs.is_open()) {
+        QL_FATAL("failed to open preprocessed platform configuration '" << fname << "'");
+    }
+    ifs.seekg(PREPROCESSED_CONFIG_MAGIC_SIZE);
+    std::vector<std::uint8_t> data{
+        std::istreambuf_iterator<char>(ifs),
+        std::istreambuf_iterator<char>()
+    };
+
+    utils::Json cache;
+    try {
+        cache = utils::Json::from_cbor(data);
+    } catch (utils::Json::exception &e) {
+        QL_FATAL(
+            "failed to load preprocessed platform configuration '" << fname << "': "
+            << utils::Str(e.what())
+        );
+    }
+
+    // The preprocessing logic may differ between versions, so only accept
+    // files written by this version.
+    utils::Str version = cache.value("version", "");
+    if (version != OPENQL_VERSION_STRING) {
+        QL_FATAL(
+            "preprocessed platform configuration '" << fname << "' was written by "
+            "OpenQL version '" << version << "', but this is version '"
+            << OPENQL_VERSION_STRING << "'; please recreate it"
+        );
+    }
+
+    utils::Str architecture_name = cache.value("architecture", "");
+    architecture = arch::Factory().build_from_namespace(architecture_name);
+    if (!architecture.has_value()) {
+        QL_FATAL(
+            "preprocessed platform configuration '" << fname << "' refers to "
+            "unknown architecture '" << architecture_name << "'"
+        );
+    }
+    compiler_settings = cache["compiler_settings"];
+    platform_config = cache["platform"];
+    platform_config_fname = cache.value("platform_config_fname", "");
+
+    load_preprocessed();
+}
+
+namespace {
+
+/**
+ * Entry of the in-process platform registry.
+ */
+struct SharedPlatform {
+
+    /**
+     * The contents of the platform configuration file when the platform was
+     * built, or empty if the configuration is an architecture name.
+     */
+    utils::Str platform_config_contents;
+
+    /**
+     * The contents of the compiler configuration file when the platform was
+     * built, or empty if there is none.
+     */
+    utils::Str compiler_config_contents;
+
+    /**
+     * The shared platform. Only the old-IR platform is kept here; its
+     * conversion to the new IR is cached as a template on the platform
+     * itself, of which every program gets its own copy.
+     */
+    PlatformRef platform;
+
+};
+
+} // anonymous namespace
+
+/**
+ * Returns the contents of the given file, or an empty string if it is not a
+ * file (for instance because it is an architecture name).
+ */
+static utils::Str read_if_file(const utils::Str &fname) {
+    if (fname.empty() || !utils::is_file(fname)) {
+        return "";
+    }
+    return utils::InFile(fname).read();
+}
+
+/**
+ * Mutex protecting the platform registry.
+ */
+static std::mutex shared_platforms_mutex;
+
+/**
+ * The in-process platform registry, keyed by name, platform configuration, and
+ * compiler configuration.
+ */
+static utils::Map<std::tuple<utils::Str, utils::Str, utils::Str>, SharedPlatform> shared_platforms;
+
+/**
+ * Returns the platform for the given configuration from the in-process
+ * platform registry, building and registering it if it is not there yet. The
+ * same platform instance (and the cached template for its conversion to the
+ * new IR) is thus shared by everything that requests the same configuration,
+ * rather than being loaded again each time. The configuration files are reread to detect changes, in
+ * which case the platform is rebuilt; files included by the platform
+ * configuration file are not checked.
+ */
+PlatformRef Platform::get_shared(
+    const utils::Str &name,
+    const utils::Str &platform_config,
+    const utils::Str &compiler_config
+) {
+    auto key = std::make_tuple(name, platform_config, compiler_config);
+    auto platform_config_contents = read_if_file(platform_config);
+    auto compiler_config_contents = read_if_file(compiler_config);
+
+    // The lock is held while building, so concurrent requests for a platform
+    // that is not registered yet don't build it more than once.
+    std::lock_guard<std::mutex> lock(shared_platforms_mutex);
+    auto it = shared_platforms.find(key);
+    if (
+        it != shared_platforms.end() &&
+        it->second.platform_config_contents == platform_config_contents &&
+        it->second.compiler_config_contents == compiler_config_contents
+    ) {
+        return it->second.platform;
+    }
+
+    SharedPlatform entry;
+    entry.platform_config_contents = std::move(platform_config_contents);
+    entry.compiler_config_contents = std::move(compiler_config_contents);
+    entry.platform = build(name, platform_config, compiler_config);
+
+    // Convert the platform once to populate its conversion cache. The
+    // converted root itself is discarded; it is not shared between programs.
+    ir::convert_old_to_new(entry.platform);
+    auto platform = entry.platform;
+    shared_platforms.set(key) = std::move(entry);
+    return platform;
+}
+
+/**
+ * Removes all platforms from the in-process platform registry. Platforms that
+ * are still in use elsewhere remain valid.
+ */
+void Platform::clear_shared() {
+    std::lock_guard<std::mutex> lock(shared_platforms_mutex);
+    shared_platforms.clear();
+}
+
 /**
  * Dumps some basic info about the platform to the given stream.
  */
@@ -809,6 +1089,49 @@ const utils::Json &Platform::find_instruction(const utils::Str &iname) const {
     return instruction_settings[iname];
 }
 
+/**
+ * Returns the custom gate template for a gate with the given name and qubit
+ * operands, or an empty reference if there is none. A specialized instruction
+ * (e.g. "cz q0,q3") takes precedence over the generic one (e.g. "cz").
+ */
+utils::Maybe<gate_types::Custom> Platform::find_custom_gate(
+    const utils::Str &name,
+    const utils::Vec<utils::UInt> &qubits
+) const {
+
+    // If instruction_map was modified since the index was built, fall back to
+    // looking up the canonical instruction names.
+    if (custom_gate_index_size != instruction_map.size()) {
+        utils::Str instr;
+        for (auto qubit : qubits) {
+            if (!instr.empty()) {
+                instr += ",";
+            }
+            instr += "q" + utils::to_string(qubit);
+        }
+        auto it = instruction_map.find(name + " " + instr);
+        if (it == instruction_map.end()) {
+            it = instruction_map.find(name);
+        }
+        if (it == instruction_map.end()) {
+            return {};
+        }
+        return it->second;
+    }
+
+    auto it = custom_gate_index.find(name);
+    if (it == custom_gate_index.end()) {
+        return {};
+    }
+    if (!qubits.empty()) {
+        auto spec = it->second.specialized.find(qubits);
+        if (spec != it->second.specialized.end()) {
+            return spec->second;
+        }
+    }
+    return it->second.generic;
+}
+
 /**
  * Returns the JSON data for all instructions as a JSON map.
  *
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <regex>
+
+#include "ql/utils/exception.h"
+#include "ql/ir/compat/names.h"
+
+using namespace ql::utils;
+using namespace ql::ir::compat;
+
+/**
+ * The legacy regex-based normalization rules, for comparison.
+ */
+static Str legacy_normalize(Str name) {
+    name = to_lower(name);
+    name = std::regex_replace(name, std::regex("^(\\s)+|(\\s)+$"), "");
+    name = std::regex_replace(name, std::regex("(\\s)+"), " ");
+    name = std::regex_replace(name, std::regex("\\s*,\\s*"), ",");
+    return name;
+}
+
+/**
+ * The legacy regex-based splitting rules, for comparison.
+ */
+static List<Str> legacy_split(Str name) {
+    name = to_lower(name);
+    name = std::regex_replace(name, std::regex("^(\\s+)|(\\s+)$"), "");
+    name = std::regex_replace(name, std::regex("[\\s,]+"), " ");
+    UInt pos = 0;
+    List<Str> parts;
+    while (true) {
+        auto next = name.find_first_of(' ', pos);
+        parts.push_back(name.substr(pos, next - pos));
+        if (next == Str::npos) break;
+        pos = next + 1;
+    }
+    return parts;
+}
+
+int main() {
+    QL_ASSERT(normalize_instruction_name(" CZ  q0 , q1 ") == "cz q0,q1");
+    QL_ASSERT(normalize_instruction_name("x") == "x");
+    QL_ASSERT(normalize_instruction_name("") == "");
+    QL_ASSERT((split_instruction_name(" CZ  q0 , q1 ") == List<Str>{"cz", "q0", "q1"}));
+    QL_ASSERT((split_instruction_name("") == List<Str>{""}));
+
+    const Str names[] = {
+        "", " ", ",", " , ", "x", "X", "  x  ", "cz q0,q1", "cz\tq0 ,\nq1",
+        "CZ  Q0 ,  ,Q1", "x q0,", ",x q0", "  cl_2 %0  ", "a,,b", "a , , b",
+        "a \t\r\n\v\f b"
+    };
+    for (const auto &name : names) {
+        QL_ASSERT(normalize_instruction_name(name) == legacy_normalize(name));
+        QL_ASSERT(split_instruction_name(name) == legacy_split(name));
+    }
+
+    QL_ASSERT(is_register_operand("q0"));
+    QL_ASSERT(is_register_operand("b12"));
+    QL_ASSERT(is_register_operand("c3"));
+    QL_ASSERT(!is_register_operand("q"));
+    QL_ASSERT(!is_register_operand("r0"));
+    QL_ASSERT(!is_register_operand("q0a"));
+    QL_ASSERT(!is_register_operand("%0"));
+
+    QL_ASSERT(is_identifier("_a1"));
+    QL_ASSERT(!is_identifier(""));
+    QL_ASSERT(!is_identifier("1a"));
+    QL_ASSERT(!is_identifier("a-b"));
+    QL_ASSERT(make_identifier("kernel-1.x") == "kernel_1_x");
+    QL_ASSERT(make_identifier("1st") == "_1st");
+    QL_ASSERT(make_identifier("") == "_");
+    QL_ASSERT(make_identifier("-") == "_");
+
+    return 0;
+}
@@ -7,7 +7,9 @@
 #include <regex>
 #include "ql/utils/exception.h"
 #include "ql/utils/set.h"
+#include "ql/utils/parallel.h"
 #include "ql/ir/ops.h"
+#include "ql/com/options.h"
 
 namespace ql {
 namespace ir {
@@ -18,11 +20,6 @@ namespace ir {
 class ConsistencyChecker : public RecursiveVisitor {
 private:
 
-    /**
-     * The set of all block names encountered.
-     */
-    utils::Set<utils::Str> block_names;
-
     /**
      * Whether we're currently traversing the tree inside a loop.
      */
@@ -135,104 +132,17 @@ private:
 public:
 
     /**
-     * Behavior for unknown node types. Assume that means that no check is
-     * needed.
+     * Constructs a consistency checker for (parts of) the given IR.
      */
-    void visit_node(Node &node) override {
+    explicit ConsistencyChecker(const Ref &ir) {
+        implicit_bit_type = ir->platform->implicit_bit_type;
     }
 
     /**
-     * Checks a platform node.
+     * Behavior for unknown node types. Assume that means that no check is
+     * needed.
      */
-    void visit_platform(Platform &node) override {
-        implicit_bit_type = node.implicit_bit_type;
-        RecursiveVisitor::visit_platform(node);
-
-        // Check uniqueness and ordering of the data type names.
-        if (!std::is_sorted(
-            node.data_types.get_vec().begin(),
-            node.data_types.get_vec().end(),
-            [](const utils::One<DataType> &lhs, const utils::One<DataType> &rhs) {
-                if (lhs->name == rhs->name) {
-                    QL_ICE("duplicate data type name " << lhs->name);
-                } else {
-                    return lhs->name < rhs->name;
-                }
-            }
-        )) {
-            QL_ICE("data types are not ordered by name");
-        }
-
-        // Check ordering of the instruction names.
-        if (!std::is_sorted(
-            node.instructions.get_vec().begin(),
-            node.instructions.get_vec().end(),
-            [](const utils::One<InstructionType> &lhs, const utils::One<InstructionType> &rhs) {
-                return lhs->name < rhs->name;
-            }
-        )) {
-            QL_ICE("instruction types are not ordered by name");
-        }
-
-        // Check that all toplevel instruction types are fully generalized.
-        for (const auto &insn_type : node.instructions) {
-            if (!insn_type->generalization.empty() || !insn_type->template_operands.empty()) {
-                QL_ICE(
-                    "toplevel entry for instruction type \"" << insn_type->name <<
-                    "\" is not fully generic"
-                );
-            }
-        }
-
-        // Check ordering of the function names.
-        if (!std::is_sorted(
-            node.functions.get_vec().begin(),
-            node.functions.get_vec().end(),
-            [](const utils::One<FunctionType> &lhs, const utils::One<FunctionType> &rhs) {
-                return lhs->name < rhs->name;
-            }
-        )) {
-            QL_ICE("function types are not ordered by name");
-        }
-
-        // Check uniqueness and ordering of the physical object names.
-        if (!std::is_sorted(
-            node.objects.get_vec().begin(),
-            node.objects.get_vec().end(),
-            [](const utils::One<PhysicalObject> &lhs, const utils::One<PhysicalObject> &rhs) {
-                if (lhs->name == rhs->name) {
-                    QL_ICE("duplicate physical object name " << lhs->name);
-                } else {
-                    return lhs->name < rhs->name;
-                }
-            }
-        )) {
-            QL_ICE("physical objects are not ordered by name");
-        }
-
-        // Check data type of main qubit type.
-        if (!node.qubits->data_type->as_qubit_type()) {
-            QL_ICE("main qubit register is not of a qubit-like data type");
-        }
-
-        // Check the implicit bit type.
-        if (!node.implicit_bit_type.empty()) {
-            if (!node.implicit_bit_type->as_bit_type()) {
-                QL_ICE("implicit bit type must be a bit-like type");
-            }
-        }
-
-        // Check existence of the topology, architecture, and resources objects.
-        if (!node.topology.is_populated()) {
-            QL_ICE("IR is missing topology information");
-        }
-        if (!node.architecture.is_populated()) {
-            QL_ICE("IR is missing architecture information");
-        }
-        if (!node.resources.is_populated()) {
-            QL_ICE("IR is missing resource information");
-        }
-
+    void visit_node(Node &node) override {
     }
 
     /**
@@ -554,28 +464,6 @@ public:
 
     }
 
-    /**
-     * Checks the program node.
-     */
-    void visit_program(Program &node) override {
-        RecursiveVisitor::visit_program(node);
-
-        // Check validity of the entry point.
-        utils::Bool ok = false;
-        for (const auto &block : node.blocks) {
-            if (node.entry_point.links_to(block)) {
-                ok = true;
-                break;
-            }
-        }
-        if (!ok) {
-            QL_ICE(
-                "program entry point does not link to block in program root"
-            );
-        }
-
-    }
-
     /**
      * Checks a sub-block.
      */
@@ -587,22 +475,6 @@ public:
 
     }
 
-    /**
-     * Checks a block.
-     */
-    void visit_block(Block &node) override {
-        RecursiveVisitor::visit_block(node);
-
-        // Check name.
-        if (!node.name.empty()) {
-            check_identifier("object name", node.name);
-            if (!block_names.insert(node.name).second) {
-                QL_ICE("duplicate block name " << node.name);
-            }
-        }
-
-    }
-
     /**
      * Checks the condition expression of a conditional instruction.
      */
@@ -931,23 +803,191 @@ public:
 };
 
 /**
- * Performs a consistency check of the IR. An exception is thrown if a problem
- * is found. The constraints checked by this must be met on any interface that
- * passes an IR reference, although actually checking it on every interface
- * might be detrimental for performance.
+ * Checks the constraints on the platform that don't require a traversal of the
+ * tree.
  */
-void check_consistency(const Ref &ir) {
+static void check_platform_structure(Platform &node) {
+
+    // Check uniqueness and ordering of the data type names.
+    if (!std::is_sorted(
+        node.data_types.get_vec().begin(),
+        node.data_types.get_vec().end(),
+        [](const utils::One<DataType> &lhs, const utils::One<DataType> &rhs) {
+            if (lhs->name == rhs->name) {
+                QL_ICE("duplicate data type name " << lhs->name);
+            } else {
+                return lhs->name < rhs->name;
+            }
+        }
+    )) {
+        QL_ICE("data types are not ordered by name");
+    }
+
+    // Check ordering of the instruction names.
+    if (!std::is_sorted(
+        node.instructions.get_vec().begin(),
+        node.instructions.get_vec().end(),
+        [](const utils::One<InstructionType> &lhs, const utils::One<InstructionType> &rhs) {
+            return lhs->name < rhs->name;
+        }
+    )) {
+        QL_ICE("instruction types are not ordered by name");
+    }
+
+    // Check that all toplevel instruction types are fully generalized.
+    for (const auto &insn_type : node.instructions) {
+        if (!insn_type->generalization.empty() || !insn_type->template_operands.empty()) {
+            QL_ICE(
+                "toplevel entry for instruction type \"" << insn_type->name <<
+                "\" is not fully generic"
+            );
+        }
+    }
+
+    // Check ordering of the function names.
+    if (!std::is_sorted(
+        node.functions.get_vec().begin(),
+        node.functions.get_vec().end(),
+        [](const utils::One<FunctionType> &lhs, const utils::One<FunctionType> &rhs) {
+            return lhs->name < rhs->name;
+        }
+    )) {
+        QL_ICE("function types are not ordered by name");
+    }
+
+    // Check uniqueness and ordering of the physical object names.
+    if (!std::is_sorted(
+        node.objects.get_vec().begin(),
+        node.objects.get_vec().end(),
+        [](const utils::One<PhysicalObject> &lhs, const utils::One<PhysicalObject> &rhs) {
+            if (lhs->name == rhs->name) {
+                QL_ICE("duplicate physical object name " << lhs->name);
+            } else {
+                return lhs->name < rhs->name;
+            }
+        }
+    )) {
+        QL_ICE("physical objects are not ordered by name");
+    }
+
+    // Check data type of main qubit type.
+    if (!node.qubits->data_type->as_qubit_type()) {
+        QL_ICE("main qubit register is not of a qubit-like data type");
+    }
+
+    // Check the implicit bit type.
+    if (!node.implicit_bit_type.empty()) {
+        if (!node.implicit_bit_type->as_bit_type()) {
+            QL_ICE("implicit bit type must be a bit-like type");
+        }
+    }
+
+    // Check existence of the topology, architecture, and resources objects.
+    if (!node.topology.is_populated()) {
+        QL_ICE("IR is missing topology information");
+    }
+    if (!node.architecture.is_populated()) {
+        QL_ICE("IR is missing architecture information");
+    }
+    if (!node.resources.is_populated()) {
+        QL_ICE("IR is missing resource information");
+    }
+
+}
+
+/**
+ * Checks the constraints on the program that don't require a traversal of the
+ * tree.
+ */
+static void check_program_structure(Program &node) {
+
+    // Check validity of the entry point.
+    utils::Bool ok = false;
+    for (const auto &block : node.blocks) {
+        if (node.entry_point.links_to(block)) {
+            ok = true;
+            break;
+        }
+    }
+    if (!ok) {
+        QL_ICE(
+            "program entry point does not link to block in program root"
+        );
+    }
+
+    // Check names of the blocks.
+    utils::Set<utils::Str> block_names;
+    for (const auto &block : node.blocks) {
+        if (!block->name.empty()) {
+            if (!std::regex_match(block->name, IDENTIFIER_RE)) {
+                QL_ICE("object name \"" << block->name << "\" is not a valid identifier");
+            }
+            if (!block_names.insert(block->name).second) {
+                QL_ICE("duplicate block name " << block->name);
+            }
+        }
+    }
+
+}
+
+/**
+ * Runs the checks for the given level, either for the complete IR (if blocks
+ * is null) or only for the program-level constraints and the given blocks.
+ */
+static void check_consistency(
+    const Ref &ir,
+    ConsistencyCheckLevel level,
+    const utils::Vec<BlockRef> *blocks
+) {
+    if (level == ConsistencyCheckLevel::OFF) {
+        return;
+    }
     try {
 
-        // First, check whether the tree itself is well-formed according to
-        // tree-gen.
-        ir.check_well_formed();
+        // Check whether the tree itself is well-formed according to tree-gen.
+        // This is not possible for only a part of the tree, as links would
+        // then point outside of it, so this is always done for the complete
+        // tree.
+        if (level == ConsistencyCheckLevel::FULL) {
+            ir.check_well_formed();
+        }
 
-        // The well-formedness check doesn't check any of the additional constraints
-        // that the IR imposes. The visitor pattern is great for doing checks like
-        // this, because it recursively walks through the entire tree by default.
-        ConsistencyChecker consistency_checker;
-        ir->visit(consistency_checker);
+        // Perform the checks that don't require a traversal.
+        check_platform_structure(*ir->platform);
+        if (!ir->program.empty()) {
+            check_program_structure(*ir->program);
+        }
+        if (level == ConsistencyCheckLevel::CHEAP) {
+            return;
+        }
+
+        // The well-formedness check doesn't check any of the additional
+        // constraints that the IR imposes. The visitor pattern is great for
+        // doing checks like this, because it recursively walks through the
+        // entire tree by default. The blocks are independent as far as the
+        // checks are concerned, so they are checked in parallel. For an
+        // incremental check, only the contents of the given blocks are
+        // traversed.
+        ConsistencyChecker platform_checker{ir};
+        ir->platform->visit(platform_checker);
+        if (ir->program.empty()) {
+            return;
+        }
+        ConsistencyChecker object_checker{ir};
+        for (const auto &object : ir->program->objects) {
+            object->visit(object_checker);
+        }
+        utils::Vec<BlockRef> all_blocks;
+        if (!blocks) {
+            for (const auto &block : ir->program->blocks) {
+                all_blocks.push_back(block);
+            }
+        }
+        const auto &to_check = blocks ? *blocks : all_blocks;
+        utils::parallel_for(to_check.size(), [&](utils::UInt i) {
+            ConsistencyChecker checker{ir};
+            to_check[i]->visit(checker);
+        }, com::options::global["num_threads"].as_uint());
 
     } catch (utils::Exception &e) {
 
@@ -962,6 +1002,53 @@ void check_consistency(const Ref &ir) {
     }
 }
 
+/**
+ * Returns the consistency check level selected via the `consistency_checks`
+ * global option.
+ */
+ConsistencyCheckLevel get_consistency_check_level() {
+    const auto &level = com::options::global["consistency_checks"].as_str();
+    if (level == "off") {
+        return ConsistencyCheckLevel::OFF;
+    } else if (level == "cheap") {
+        return ConsistencyCheckLevel::CHEAP;
+    } else {
+        return ConsistencyCheckLevel::FULL;
+    }
+}
+
+/**
+ * Performs a consistency check of the IR. An exception is thrown if a problem
+ * is found. The constraints checked by this must be met on any interface that
+ * passes an IR reference, although actually checking it on every interface
+ * might be detrimental for performance. The amount of checking is controlled
+ * by the `consistency_checks` global option.
+ */
+void check_consistency(const Ref &ir) {
+    check_consistency(ir, get_consistency_check_level(), nullptr);
+}
+
+/**
+ * Same as check_consistency(const Ref&), but using the given check level
+ * rather than the one selected via the global option.
+ */
+void check_consistency(const Ref &ir, ConsistencyCheckLevel level) {
+    check_consistency(ir, level, nullptr);
+}
+
+/**
+ * Incremental version of check_consistency(), for use after a transformation
+ * that only modified the given blocks of the program. The contents of all
+ * other blocks are assumed to still be consistent, so the statements and
+ * expressions within them are not traversed. The platform, the program-level
+ * constraints, and (for the full check) the well-formedness of the complete
+ * tree are still checked. The amount of checking is controlled by the
+ * `consistency_checks` global option.
+ */
+void check_consistency(const Ref &ir, const utils::Vec<BlockRef> &modified_blocks) {
+    check_consistency(ir, get_consistency_check_level(), &modified_blocks);
+}
+
 /**
  * Determines whether the IR is in basic-block form. This returns true only if:
  *  - all statements in the program's blocks are instructions (i.e., no
@@ -5,6 +5,7 @@
 
 #include "ql/ir/new_to_old.h"
 
+#include <atomic>
 #include "ql/ir/old_to_new.h"
 #include "ql/ir/ops.h"
 #include "ql/ir/describe.h"
@@ -969,14 +970,29 @@ void Operands::append(const NewToOldConverter &conv, const ExpressionRef &expr)
     }
 }
 
+/**
+ * Number of times convert_new_to_old() has been called.
+ */
+static std::atomic<utils::UInt> num_new_to_old_conversions{0};
+
 /**
  * Converts the new IR to the old one. This requires that the platform was
  * constructed using convert_old_to_new(), and (obviously) that no features of
  * the new IR are used that are not supported by the old IR.
  */
 compat::ProgramRef convert_new_to_old(const Ref &ir) {
+    num_new_to_old_conversions++;
     return NewToOldConverter::convert(ir);
 }
 
+/**
+ * Returns the number of times a program has been converted from the new to the
+ * old IR using convert_new_to_old() thus far. Used for profiling the overhead
+ * of legacy passes.
+ */
+utils::UInt get_num_new_to_old_conversions() {
+    return num_new_to_old_conversions;
+}
+
 } // namespace ir
 } // namespace ql
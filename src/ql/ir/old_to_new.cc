@@ -5,42 +5,18 @@
 
 #include "ql/ir/old_to_new.h"
 
+#include <atomic>
+#include <mutex>
 #include "ql/ir/ops.h"
 #include "ql/ir/consistency.h"
 #include "ql/ir/cqasm/read.h"
+#include "ql/ir/compat/names.h"
 #include "ql/rmgr/manager.h"
 #include "ql/arch/diamond/annotations.h"
 
 namespace ql {
 namespace ir {
 
-/**
- * Takes an instruction name from the JSON file, "sanitizes" it according to
- * the legacy platform loading rules, and splits it into the name and its
- * specialization/decomposition template parameters.
- */
-static utils::List<utils::Str> parse_instruction_name(utils::Str name) {
-
-    // Sanitize according to the legacy rules.
-    name = utils::to_lower(name);
-    static const std::regex TRIM("^(\\s+)|(\\s+)$");
-    name = std::regex_replace(name, TRIM, "");
-    static const std::regex SPACES("[\\s,]+");
-    name = std::regex_replace(name, SPACES, " ");
-
-    // Split on spaces.
-    utils::UInt pos = 0;
-    utils::List<utils::Str> template_params;
-    while (true) {
-        auto next = name.find_first_of(' ', pos);
-        template_params.push_back(name.substr(pos, next - pos));
-        if (next == utils::Str::npos) break;
-        pos = next + 1;
-    }
-
-    return template_params;
-}
-
 /**
  * Parses a parameter from an instruction or decomposition key.
  */
@@ -48,7 +24,7 @@ static ExpressionRef parse_instruction_parameter(
     const Ref &ir,
     const utils::Str &param
 ) {
-    if (std::regex_match(param, std::regex("[qbc][0-9]+"))) {
+    if (compat::is_register_operand(param)) {
         auto name = param.substr(0, 1);
         auto index = utils::parse_uint(param.substr(1));
 
@@ -243,11 +219,10 @@ static void parse_decomposition_rule(
 }
 
 /**
- * Converts the old platform to the new IR structure.
- *
- * See convert_old_to_new(const compat::ProgramRef&) for details.
+ * Actually converts the old platform to the new IR structure, bypassing the
+ * cache.
  */
-Ref convert_old_to_new(const compat::PlatformRef &old) {
+static Ref convert_platform(const compat::PlatformRef &old) {
     Ref ir;
     ir.emplace();
 
@@ -310,7 +285,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
     ) {
         unparsed_gate_types.push_back({
             it.key(),
-            parse_instruction_name(it.key()),
+            compat::split_instruction_name(it.key()),
             *it
         });
     }
@@ -339,7 +314,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
             auto name = template_params.front();
             template_params.pop_front();
             insn->name = name;
-            if (!std::regex_match(insn->name, IDENTIFIER_RE)) {
+            if (!compat::is_identifier(insn->name)) {
                 QL_USER_ERROR("instruction name is not a valid identifier");
             }
 
@@ -349,7 +324,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                 insn->cqasm_name = insn->name;
             } else if (it2->is_string()) {
                 insn->cqasm_name = it2->get<utils::Str>();
-                if (!std::regex_match(insn->cqasm_name, IDENTIFIER_RE)) {
+                if (!compat::is_identifier(insn->cqasm_name)) {
                     QL_USER_ERROR("cQASM name is not a valid identifier");
                 }
             } else {
@@ -471,13 +446,21 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
 
                 // We have to infer the prototype somehow...
                 prototype_inferred = true;
-                if (std::regex_match(insn->name, std::regex("move_init|prep(_?[xyz])?"))) {
+                static const std::regex PREP_RE("move_init|prep(_?[xyz])?");
+                static const std::regex H_I_RE("h|i");
+                static const std::regex X_RE("(m|mr|r)?xm?[0-9]*");
+                static const std::regex Y_RE("(m|mr|r)?ym?[0-9]*");
+                static const std::regex Z_RE("[st](dag)?|(m|mr|r)?zm?[0-9]*");
+                static const std::regex MEASURE_RE("meas(ure)?(_?[xyz])?(_keep)?");
+                static const std::regex SWAP_RE("(teleport)?(move|swap)");
+
+                if (std::regex_match(insn->name, PREP_RE)) {
 
                     // State initialization doesn't commute and kills the qubit
                     // for liveness analysis.
                     insn->operand_types.emplace(prim::OperandMode::WRITE, qubit_type);
 
-                } else if (std::regex_match(insn->name, std::regex("h|i"))) {
+                } else if (std::regex_match(insn->name, H_I_RE)) {
 
                     // Single-qubit gate that doesn't commute in any way we can
                     // represent.
@@ -489,7 +472,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                     insn->operand_types.emplace(prim::OperandMode::COMMUTE_X, qubit_type);
                     insn->operand_types.emplace(prim::OperandMode::LITERAL, real_type);
 
-                } else if (std::regex_match(insn->name, std::regex("(m|mr|r)?xm?[0-9]*"))) {
+                } else if (std::regex_match(insn->name, X_RE)) {
 
                     // Single-qubit gate that commutes on the X axis.
                     insn->operand_types.emplace(prim::OperandMode::COMMUTE_X, qubit_type);
@@ -500,7 +483,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                     insn->operand_types.emplace(prim::OperandMode::COMMUTE_Y, qubit_type);
                     insn->operand_types.emplace(prim::OperandMode::LITERAL, real_type);
 
-                } else if (std::regex_match(insn->name, std::regex("(m|mr|r)?ym?[0-9]*"))) {
+                } else if (std::regex_match(insn->name, Y_RE)) {
 
                     // Single-qubit gate that commutes on the Y axis.
                     insn->operand_types.emplace(prim::OperandMode::COMMUTE_Y, qubit_type);
@@ -525,18 +508,18 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                     insn->operand_types.emplace(prim::OperandMode::COMMUTE_Z, qubit_type);
                     insn->operand_types.emplace(prim::OperandMode::LITERAL, int_type);
 
-                } else if (std::regex_match(insn->name, std::regex("[st](dag)?|(m|mr|r)?zm?[0-9]*"))) {
+                } else if (std::regex_match(insn->name, Z_RE)) {
 
                     // Single-qubit gate that commutes on the Z axis.
                     insn->operand_types.emplace(prim::OperandMode::COMMUTE_Z, qubit_type);
 
-                } else if (std::regex_match(insn->name, std::regex("meas(ure)?(_?[xyz])?(_keep)?"))) {
+                } else if (std::regex_match(insn->name, MEASURE_RE)) {
 
                     // Measurements.
                     duplicate_with_breg_arg = true;
                     insn->operand_types.emplace(prim::OperandMode::MEASURE, qubit_type);
 
-                } else if (std::regex_match(insn->name, std::regex("(teleport)?(move|swap)"))) {
+                } else if (std::regex_match(insn->name, SWAP_RE)) {
 
                     // Swaps.
                     insn->operand_types.emplace(prim::OperandMode::UPDATE, qubit_type);
@@ -711,11 +694,11 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                 insn->decompositions.add(decomp);
 
                 // Figure out the name and template parameters.
-                auto template_params = parse_instruction_name(it2.key());
+                auto template_params = compat::split_instruction_name(it2.key());
                 insn->name = template_params.front();
                 insn->cqasm_name = insn->name;
                 template_params.pop_front();
-                if (!std::regex_match(insn->name, IDENTIFIER_RE)) {
+                if (!compat::is_identifier(insn->name)) {
                     throw utils::Exception(
                         "instruction name is not a valid identifier"
                     );
@@ -794,7 +777,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                         if (!sub_insn.is_string()) {
                             throw utils::Exception("sub-instructions must be strings");
                         }
-                        auto sub_insn_params = parse_instruction_name(sub_insn.get<utils::Str>());
+                        auto sub_insn_params = compat::split_instruction_name(sub_insn.get<utils::Str>());
                         auto sub_insn_name = sub_insn_params.front();
                         sub_insn_params.pop_front();
 
@@ -927,6 +910,147 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
     return ir;
 }
 
+namespace {
+
+/**
+ * The properties of an old platform that its conversion to the new IR depends
+ * on: the platform configuration, identified by the hash computed when it was
+ * loaded (it is not modified afterwards), and the members that can still
+ * change after the platform has been constructed (the creg and breg counts
+ * change when compat_implicit_creg_count is set and a larger program is
+ * constructed). These are cheap to gather and compare, so this can be done for
+ * every conversion.
+ */
+struct PlatformState {
+    std::size_t config_hash;
+    utils::UInt qubit_count;
+    utils::UInt creg_count;
+    utils::UInt breg_count;
+    utils::UInt cycle_time;
+    utils::UInt num_instructions;
+
+    utils::Bool operator==(const PlatformState &rhs) const {
+        return config_hash == rhs.config_hash
+            && qubit_count == rhs.qubit_count
+            && creg_count == rhs.creg_count
+            && breg_count == rhs.breg_count
+            && cycle_time == rhs.cycle_time
+            && num_instructions == rhs.num_instructions;
+    }
+
+};
+
+/**
+ * Returns the current state of the given old platform.
+ */
+PlatformState get_platform_state(const compat::Platform &old) {
+    return {
+        old.platform_config_hash,
+        old.qubit_count,
+        old.creg_count,
+        old.breg_count,
+        old.cycle_time,
+        old.instruction_map.size()
+    };
+}
+
+/**
+ * Annotation placed on old platforms to cache the result of converting them to
+ * the new IR. The cached platform is a template that is never handed out or
+ * modified itself; each converted root gets its own copy of it (see
+ * clone_platform()), because passes add instruction types and annotations to
+ * the platform of the program they compile. The cache entry is keyed on the
+ * state of the old platform at the time of conversion, such that it is
+ * invalidated when the old platform is modified.
+ *
+ * The template does not refer back to the old platform, neither through the
+ * compat::PlatformRef annotation nor through its resource manager; both are
+ * added to the copies. It therefore lives exactly as long as the old platform.
+ */
+struct ConvertedPlatform {
+
+    /**
+     * State of the old platform at the time of conversion.
+     */
+    PlatformState state;
+
+    /**
+     * The converted platform template.
+     */
+    utils::One<Platform> platform;
+
+};
+
+} // anonymous namespace
+
+/**
+ * Mutex protecting the ConvertedPlatform annotations.
+ */
+static std::mutex converted_platform_mutex;
+
+/**
+ * Number of times a platform has actually been converted, i.e. the number of
+ * cache misses of convert_old_to_new() for platforms.
+ */
+static std::atomic<utils::UInt> num_platform_conversions{0};
+
+/**
+ * Converts the old platform to the new IR structure, reusing the previously
+ * converted platform as a template if the old platform has not been modified
+ * since.
+ *
+ * Refer to the header file for details.
+ */
+Ref convert_old_to_new(const compat::PlatformRef &old) {
+    auto state = get_platform_state(*old);
+
+    // Look for the cached template.
+    utils::One<Platform> templ;
+    {
+        std::lock_guard<std::mutex> lock(converted_platform_mutex);
+        if (auto cached = old->get_annotation_ptr<ConvertedPlatform>()) {
+            if (cached->state == state) {
+                templ = cached->platform;
+            }
+        }
+    }
+
+    // Cache miss; convert the platform and cache the result as a template. The
+    // lock is not held during the conversion itself, so concurrent misses may
+    // convert the same platform twice, in which case the last one wins. The
+    // template is never allocated from the arena of the program being
+    // compiled, as it outlives it.
+    if (templ.empty()) {
+        num_platform_conversions++;
+        utils::ArenaScope no_arena(nullptr);
+        templ = convert_platform(old)->platform;
+        templ->erase_annotation<compat::PlatformRef>();
+        templ->resources = prim::ResourceManager();
+        std::lock_guard<std::mutex> lock(converted_platform_mutex);
+        old->set_annotation<ConvertedPlatform>({state, templ});
+    }
+
+    // Give the new root its own copy of the template. The resource manager
+    // refers to the IR root that it was built for, so it is built anew.
+    Ref ir;
+    ir.emplace();
+    ir->platform = clone_platform(templ);
+    ir->platform->set_annotation<compat::PlatformRef>(old);
+    rmgr::CRef resources;
+    resources.emplace(rmgr::Manager::from_defaults(old, {}, ir));
+    ir->platform->resources.populate(resources);
+    build_instruction_type_indices(ir);
+    return ir;
+}
+
+/**
+ * Returns the number of times an old platform has actually been converted to
+ * the new IR thus far, as opposed to having been taken from the cache.
+ */
+utils::UInt get_num_old_to_new_platform_conversions() {
+    return num_platform_conversions;
+}
+
 /**
  * Converts a classical operand to an expression.
  */
@@ -1072,7 +1196,7 @@ static InstructionRef convert_gate(
     // we'll use the name of the gate that the user would have to add (ry90) for
     // the real name, and use gate->name (y90) for the cQASM name, assuming
     // we'll need to add a new gate definition.
-    auto name = parse_instruction_name(gate->name).front();
+    auto name = compat::split_instruction_name(gate->name).front();
     auto cqasm_name = name;
     switch (gate->type()) {
         case compat::GateType::RX90:  name = "rx90";  break;
@@ -1627,12 +1751,18 @@ static utils::Str convert_kernels(
     return name;
 }
 
+/**
+ * Number of times convert_old_to_new() has been called for a program.
+ */
+static std::atomic<utils::UInt> num_old_to_new_conversions{0};
+
 /**
  * Converts the old IR (program and platform) to the new one.
  *
  * Refer to the header file for details.
  */
 Ref convert_old_to_new(const compat::ProgramRef &old) {
+    num_old_to_new_conversions++;
 
     // Build the platform.
     auto ir = convert_old_to_new(old->platform);
@@ -1663,14 +1793,13 @@ Ref convert_old_to_new(const compat::ProgramRef &old) {
         auto name = convert_kernels(ir, old, idx, block);
 
         // Sanitize and uniquify the kernel name.
-        name = std::regex_replace(name, std::regex("[^a-zA-Z0-9_]"), "_");
-        if (!std::regex_match(name, IDENTIFIER_RE)) name = "_" + name;
+        name = compat::make_identifier(name);
         auto unique_name = name;
         utils::UInt unique_idx = 1;
         while (!names.insert(unique_name).second) {
             unique_name = name + "_" + utils::to_string(unique_idx++);
         }
-        QL_ASSERT(std::regex_match(unique_name, IDENTIFIER_RE));
+        QL_ASSERT(compat::is_identifier(unique_name));
         block->name = unique_name;
 
         // Link the previous block to this one.
@@ -1693,5 +1822,14 @@ Ref convert_old_to_new(const compat::ProgramRef &old) {
     return ir;
 }
 
+/**
+ * Returns the number of times a program has been converted from the old to the
+ * new IR using convert_old_to_new() thus far. Used for profiling the overhead
+ * of legacy passes.
+ */
+utils::UInt get_num_old_to_new_conversions() {
+    return num_old_to_new_conversions;
+}
+
 } // namespace ir
 } // namespace ql
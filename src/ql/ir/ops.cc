@@ -4,12 +4,675 @@
 
 #include "ql/ir/ops.h"
 
+#include <mutex>
+#include <unordered_map>
 #include "ql/ir/describe.h"
 #include "ql/ir/old_to_new.h"
 
 namespace ql {
 namespace ir {
 
+namespace {
+
+/**
+ * Mutex guarding the instruction type and specialization indices, and the
+ * instruction type lists and specialization trees they index. The functions
+ * in this file that use or modify them hold this mutex for their whole
+ * duration, so lookups that lazily (re)build an index, or that generate
+ * instruction types, are safe to call from multiple threads. It is recursive
+ * because these functions call each other.
+ */
+std::recursive_mutex index_mutex;
+
+/**
+ * Lock type for index_mutex.
+ */
+using IndexLock = std::lock_guard<std::recursive_mutex>;
+
+/**
+ * Hash index over the instruction types of a platform, keyed by name and
+ * operand data types. This is attached to the platform node as an annotation,
+ * and kept up to date by the functions in this file that add instruction
+ * types. Code that modifies the instruction type list by other means must call
+ * invalidate_instruction_type_indices(). The index is also rebuilt from
+ * scratch if the annotation was copied along with a cloned platform, or as a
+ * safety net if the number of instruction types changed. index_mutex must be
+ * held while using it.
+ */
+struct InstructionTypeIndex {
+
+    /**
+     * The platform that the index was built for.
+     */
+    const Platform *platform = nullptr;
+
+    /**
+     * The number of instruction types in the index.
+     */
+    utils::UInt num_indexed = 0;
+
+    /**
+     * The first instruction type (in platform order) for each name.
+     */
+    std::unordered_map<utils::Str, utils::One<InstructionType>> by_name;
+
+    /**
+     * All instruction types by hash of their signature (see hash_signature()),
+     * in platform order.
+     */
+    std::unordered_map<std::size_t, utils::Vec<utils::One<InstructionType>>> by_signature;
+
+};
+
+/**
+ * Compares the name of a named node with the given name, for searching sorted
+ * node lists by name without having to construct a node.
+ */
+template <class T>
+utils::Bool compare_name_with(const utils::One<T> &lhs, const utils::Str &rhs) {
+    return lhs->name < rhs;
+}
+
+/**
+ * Incrementally combines a hash value into a running hash.
+ */
+void hash_combine(std::size_t &seed, std::size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/**
+ * Hashes the signature of an instruction type, consisting of its name and the
+ * identities of its operand data types.
+ */
+std::size_t hash_signature(const utils::Str &name, const utils::Vec<DataTypeLink> &types) {
+    auto seed = std::hash<utils::Str>()(name);
+    for (const auto &type : types) {
+        hash_combine(seed, std::hash<const void*>()(type.get_ptr().get()));
+    }
+    return seed;
+}
+
+/**
+ * Hashes the signature of the given instruction type.
+ */
+std::size_t hash_signature(const InstructionType &insn) {
+    auto seed = std::hash<utils::Str>()(insn.name);
+    for (const auto &operand_type : insn.operand_types) {
+        hash_combine(seed, std::hash<const void*>()(operand_type->data_type.get_ptr().get()));
+    }
+    return seed;
+}
+
+/**
+ * Returns whether the operand data types of the given instruction type match
+ * the given data types.
+ */
+utils::Bool operand_types_match(const InstructionType &insn, const utils::Vec<DataTypeLink> &types) {
+    if (insn.operand_types.size() != types.size()) {
+        return false;
+    }
+    for (utils::UInt i = 0; i < types.size(); i++) {
+        if (insn.operand_types[i]->data_type != types[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Adds the given instruction type to the index. Instruction types must be
+ * added in platform order for each name.
+ */
+void add_to_index(InstructionTypeIndex &index, const utils::One<InstructionType> &insn) {
+    index.by_name.emplace(insn->name, insn);
+    index.by_signature[hash_signature(*insn)].push_back(insn);
+    index.num_indexed++;
+}
+
+/**
+ * Returns the instruction type index for the given IR's platform, building
+ * or rebuilding it if needed. index_mutex must be held.
+ */
+InstructionTypeIndex &get_index(const Ref &ir) {
+    auto &platform = *ir->platform;
+    auto index = platform.get_annotation_ptr<InstructionTypeIndex>();
+    if (
+        index == nullptr ||
+        index->platform != &platform ||
+        index->num_indexed != platform.instructions.size()
+    ) {
+        platform.set_annotation<InstructionTypeIndex>({});
+        index = platform.get_annotation_ptr<InstructionTypeIndex>();
+        index->platform = &platform;
+        for (const auto &insn : platform.instructions) {
+            add_to_index(*index, insn);
+        }
+    }
+    return *index;
+}
+
+/**
+ * Inserts the given instruction type into the platform after all existing
+ * instruction types with the same name, to maintain sort order, and adds it to
+ * the given index.
+ */
+void insert_instruction_type(
+    const Ref &ir,
+    InstructionTypeIndex &index,
+    const utils::One<InstructionType> &insn
+) {
+    auto &vec = ir->platform->instructions.get_vec();
+    auto pos = std::upper_bound(
+        vec.begin(), vec.end(), insn->name,
+        [](const utils::Str &name, const utils::One<InstructionType> &other) {
+            return name < other->name;
+        }
+    );
+    vec.insert(pos, insn);
+    add_to_index(index, insn);
+}
+
+/**
+ * Hashable key for a literal template operand, i.e. an integer or bit literal
+ * or a reference to a single element of an object using a literal index, such
+ * as a qubit. Two such operands are equal according to equals() if and only if
+ * their keys are equal.
+ */
+struct LiteralKey {
+
+    /**
+     * The referenced object for references, or null for literals.
+     */
+    const void *target;
+
+    /**
+     * The data type of the literal or reference.
+     */
+    const void *data_type;
+
+    /**
+     * The data type of the index literal for references, or null for literals.
+     */
+    const void *index_type;
+
+    /**
+     * The value of the (index) literal.
+     */
+    utils::Int value;
+
+    /**
+     * Equality operator.
+     */
+    utils::Bool operator==(const LiteralKey &rhs) const {
+        return target == rhs.target
+            && data_type == rhs.data_type
+            && index_type == rhs.index_type
+            && value == rhs.value;
+    }
+
+};
+
+/**
+ * Hash functor for LiteralKey.
+ */
+struct LiteralKeyHash {
+    std::size_t operator()(const LiteralKey &key) const {
+        auto seed = std::hash<const void*>()(key.target);
+        hash_combine(seed, std::hash<const void*>()(key.data_type));
+        hash_combine(seed, std::hash<const void*>()(key.index_type));
+        hash_combine(seed, std::hash<utils::Int>()(key.value));
+        return seed;
+    }
+};
+
+/**
+ * Computes the key for the given expression. Returns false if the expression
+ * is not of a supported form.
+ */
+utils::Bool get_literal_key(const Expression &expr, LiteralKey &key) {
+    if (auto ilit = expr.as_int_literal()) {
+        key = {nullptr, ilit->data_type.get_ptr().get(), nullptr, ilit->value};
+        return true;
+    } else if (auto blit = expr.as_bit_literal()) {
+        key = {nullptr, blit->data_type.get_ptr().get(), nullptr, blit->value ? 1 : 0};
+        return true;
+    } else if (auto ref = expr.as_reference()) {
+        if (ref->indices.size() != 1) {
+            return false;
+        }
+        auto index = ref->indices[0]->as_int_literal();
+        if (!index) {
+            return false;
+        }
+        key = {
+            ref->target.get_ptr().get(),
+            ref->data_type.get_ptr().get(),
+            index->data_type.get_ptr().get(),
+            index->value
+        };
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Hash index over the specializations of an instruction type, keyed by their
+ * last template operand. This is attached to the instruction type node as an
+ * annotation, and kept up to date by add_or_find_instruction_type(). Like
+ * InstructionTypeIndex, it must be invalidated explicitly when the
+ * specialization list is modified by other means, is rebuilt if it was copied
+ * along with the node, and must only be used with index_mutex held.
+ */
+struct SpecializationIndex {
+
+    /**
+     * The instruction type that the index was built for.
+     */
+    const InstructionType *instruction_type = nullptr;
+
+    /**
+     * The number of specializations in the index.
+     */
+    utils::UInt num_indexed = 0;
+
+    /**
+     * The first specialization (in list order) for each literal template
+     * operand.
+     */
+    std::unordered_map<LiteralKey, utils::One<InstructionType>, LiteralKeyHash> by_literal;
+
+    /**
+     * The specializations with a template operand that has no LiteralKey, in
+     * list order. These are searched linearly.
+     */
+    utils::Vec<utils::One<InstructionType>> other;
+
+};
+
+/**
+ * Adds the given specialization to the given index. Specializations must be
+ * added in list order.
+ */
+void add_to_index(SpecializationIndex &index, const utils::One<InstructionType> &spec) {
+    LiteralKey key;
+    if (get_literal_key(*spec->template_operands.back(), key)) {
+        index.by_literal.emplace(key, spec);
+    } else {
+        index.other.push_back(spec);
+    }
+    index.num_indexed++;
+}
+
+/**
+ * Returns the specialization index for the given instruction type, building or
+ * rebuilding it if needed. index_mutex must be held.
+ */
+SpecializationIndex &get_index(InstructionType &instruction_type) {
+    auto index = instruction_type.get_annotation_ptr<SpecializationIndex>();
+    if (
+        index == nullptr ||
+        index->instruction_type != &instruction_type ||
+        index->num_indexed != instruction_type.specializations.size()
+    ) {
+        instruction_type.set_annotation<SpecializationIndex>({});
+        index = instruction_type.get_annotation_ptr<SpecializationIndex>();
+        index->instruction_type = &instruction_type;
+        for (const auto &spec : instruction_type.specializations) {
+            add_to_index(*index, spec);
+        }
+    }
+    return *index;
+}
+
+/**
+ * Returns the specialization of the given instruction type for the given
+ * value of its first operand, or returns an empty reference if there is no
+ * such specialization. index_mutex must be held.
+ */
+utils::One<InstructionType> find_specialization(
+    InstructionType &instruction_type,
+    const ExpressionRef &operand
+) {
+    if (instruction_type.specializations.empty()) {
+        return {};
+    }
+    auto &index = get_index(instruction_type);
+    LiteralKey key;
+    if (get_literal_key(*operand, key)) {
+        auto it = index.by_literal.find(key);
+        if (it != index.by_literal.end()) {
+            return it->second;
+        }
+        return {};
+    }
+    for (const auto &spec : index.other) {
+        if (spec->template_operands.back().equals(operand)) {
+            return spec;
+        }
+    }
+    return {};
+}
+
+/**
+ * Recursively builds the specialization indices for the given instruction type
+ * and its specializations. index_mutex must be held.
+ */
+void build_specialization_indices(InstructionType &instruction_type) {
+    if (instruction_type.specializations.empty()) {
+        return;
+    }
+    get_index(instruction_type);
+    for (const auto &spec : instruction_type.specializations) {
+        build_specialization_indices(*spec);
+    }
+}
+
+/**
+ * Recursively removes the specialization indices from the given instruction
+ * type and its specializations. index_mutex must be held.
+ */
+void erase_specialization_indices(InstructionType &instruction_type) {
+    instruction_type.erase_annotation<SpecializationIndex>();
+    for (const auto &spec : instruction_type.specializations) {
+        erase_specialization_indices(*spec);
+    }
+}
+
+} // anonymous namespace
+
+/**
+ * Builds the lookup indices for the instruction types of the given IR's
+ * platform and their specializations, if they don't exist or are out of date.
+ * The indices are otherwise built lazily on first use; building them up front
+ * avoids serializing the first lookups of threads that use the platform
+ * concurrently.
+ */
+void build_instruction_type_indices(const Ref &ir) {
+    IndexLock lock(index_mutex);
+    get_index(ir);
+    for (const auto &insn : ir->platform->instructions) {
+        build_specialization_indices(*insn);
+    }
+}
+
+/**
+ * Invalidates the lookup indices for the instruction types of the given IR's
+ * platform and their specializations. This must be called after modifying the
+ * instruction type list or a specialization list of the platform by any means
+ * other than the functions in this file.
+ */
+void invalidate_instruction_type_indices(const Ref &ir) {
+    IndexLock lock(index_mutex);
+    ir->platform->erase_annotation<InstructionTypeIndex>();
+    for (const auto &insn : ir->platform->instructions) {
+        erase_specialization_indices(*insn);
+    }
+}
+
+namespace {
+
+/**
+ * Visitor that lists all nodes of a subtree in traversal order.
+ */
+class NodeLister : public RecursiveVisitor {
+public:
+
+    /**
+     * The nodes in traversal order.
+     */
+    utils::Vec<Node*> nodes;
+
+    /**
+     * Lists any node.
+     */
+    void visit_node(Node &node) override {
+        nodes.push_back(&node);
+    }
+
+};
+
+/**
+ * Mapping from the nodes of a platform that links may refer to, to the
+ * corresponding nodes of a clone of that platform.
+ */
+struct CloneMap {
+    std::unordered_map<const DataType*, utils::One<DataType>> data_types;
+    std::unordered_map<const Object*, utils::One<Object>> objects;
+    std::unordered_map<const PhysicalObject*, utils::One<PhysicalObject>> physical_objects;
+    std::unordered_map<const InstructionType*, utils::One<InstructionType>> instruction_types;
+    std::unordered_map<const FunctionType*, utils::One<FunctionType>> function_types;
+};
+
+/**
+ * Adds the given original node and its clone to the given map.
+ */
+template <class T, class U>
+void add_to_map(
+    std::unordered_map<const T*, utils::One<T>> &map,
+    const utils::One<U> &original,
+    const utils::One<U> &clone
+) {
+    map.emplace(original.get_ptr().get(), clone);
+}
+
+/**
+ * Adds the given original decomposition rules and their clones to the given
+ * map. Expansions refer to the parameters and objects of the rule.
+ */
+void add_decompositions_to_map(
+    CloneMap &map,
+    const utils::Any<InstructionDecomposition> &originals,
+    const utils::Any<InstructionDecomposition> &clones
+) {
+    for (utils::UInt i = 0; i < originals.size(); i++) {
+        for (utils::UInt j = 0; j < originals[i]->parameters.size(); j++) {
+            add_to_map(map.objects, originals[i]->parameters[j], clones[i]->parameters[j]);
+        }
+        for (utils::UInt j = 0; j < originals[i]->objects.size(); j++) {
+            add_to_map(map.objects, originals[i]->objects[j], clones[i]->objects[j]);
+        }
+    }
+}
+
+/**
+ * Recursively adds the given original instruction types and their clones to
+ * the given map, along with their specializations and decomposition rules.
+ */
+void add_instruction_types_to_map(
+    CloneMap &map,
+    const utils::Any<InstructionType> &originals,
+    const utils::Any<InstructionType> &clones
+) {
+    for (utils::UInt i = 0; i < originals.size(); i++) {
+        add_to_map(map.instruction_types, originals[i], clones[i]);
+        add_decompositions_to_map(map, originals[i]->decompositions, clones[i]->decompositions);
+        add_instruction_types_to_map(map, originals[i]->specializations, clones[i]->specializations);
+    }
+}
+
+/**
+ * Redirects the given link to the clone of its target, if the target is part
+ * of the cloned tree.
+ */
+template <class T>
+void relink(
+    utils::OptLink<T> &link,
+    const std::unordered_map<const T*, utils::One<T>> &map
+) {
+    if (link.empty()) {
+        return;
+    }
+    auto it = map.find(link.get_ptr().get());
+    if (it != map.end()) {
+        link = it->second;
+    }
+}
+
+/**
+ * Visitor that redirects all links in a cloned platform from the nodes of the
+ * original platform to their clones.
+ */
+class Relinker : public RecursiveVisitor {
+private:
+
+    /**
+     * The mapping from original to cloned nodes.
+     */
+    const CloneMap &map;
+
+public:
+
+    /**
+     * Constructs a relinker using the given map.
+     */
+    explicit Relinker(const CloneMap &map) : map(map) {
+    }
+
+    /**
+     * Behavior for node types without links.
+     */
+    void visit_node(Node &node) override {
+    }
+
+    /**
+     * Relinks platform nodes.
+     */
+    void visit_platform(Platform &node) override {
+        RecursiveVisitor::visit_platform(node);
+        relink(node.qubits, map.physical_objects);
+        relink(node.implicit_bit_type, map.data_types);
+        relink(node.default_bit_type, map.data_types);
+        relink(node.default_int_type, map.data_types);
+    }
+
+    /**
+     * Relinks instruction type nodes.
+     */
+    void visit_instruction_type(InstructionType &node) override {
+        RecursiveVisitor::visit_instruction_type(node);
+        relink(node.generalization, map.instruction_types);
+    }
+
+    /**
+     * Relinks function type nodes.
+     */
+    void visit_function_type(FunctionType &node) override {
+        RecursiveVisitor::visit_function_type(node);
+        relink(node.return_type, map.data_types);
+    }
+
+    /**
+     * Relinks function decomposition nodes.
+     */
+    void visit_function_decomposition(FunctionDecomposition &node) override {
+        RecursiveVisitor::visit_function_decomposition(node);
+        relink(node.instruction_type, map.instruction_types);
+    }
+
+    /**
+     * Relinks fixed-object return location nodes.
+     */
+    void visit_return_in_fixed_object(ReturnInFixedObject &node) override {
+        RecursiveVisitor::visit_return_in_fixed_object(node);
+        relink(node.object, map.physical_objects);
+    }
+
+    /**
+     * Relinks object nodes.
+     */
+    void visit_object(Object &node) override {
+        RecursiveVisitor::visit_object(node);
+        relink(node.data_type, map.data_types);
+    }
+
+    /**
+     * Relinks operand type nodes.
+     */
+    void visit_operand_type(OperandType &node) override {
+        RecursiveVisitor::visit_operand_type(node);
+        relink(node.data_type, map.data_types);
+    }
+
+    /**
+     * Relinks custom instruction nodes.
+     */
+    void visit_custom_instruction(CustomInstruction &node) override {
+        RecursiveVisitor::visit_custom_instruction(node);
+        relink(node.instruction_type, map.instruction_types);
+    }
+
+    /**
+     * Relinks literal nodes.
+     */
+    void visit_literal(Literal &node) override {
+        RecursiveVisitor::visit_literal(node);
+        relink(node.data_type, map.data_types);
+    }
+
+    /**
+     * Relinks reference nodes.
+     */
+    void visit_reference(Reference &node) override {
+        RecursiveVisitor::visit_reference(node);
+        relink(node.target, map.objects);
+        relink(node.data_type, map.data_types);
+    }
+
+    /**
+     * Relinks function call nodes.
+     */
+    void visit_function_call(FunctionCall &node) override {
+        RecursiveVisitor::visit_function_call(node);
+        relink(node.function_type, map.function_types);
+    }
+
+};
+
+} // anonymous namespace
+
+/**
+ * Returns a deep copy of the given platform. Unlike clone(), links within the
+ * platform refer to the copied nodes rather than to the original ones, and the
+ * annotations of all nodes are copied along, except for the instruction type
+ * lookup indices. The resource manager is shared with the original, so it
+ * still refers to the IR it was built for.
+ */
+utils::One<Platform> clone_platform(const utils::One<Platform> &platform) {
+    auto clone = platform.clone();
+
+    // Copy the annotations of all nodes.
+    NodeLister originals;
+    platform->visit(originals);
+    NodeLister clones;
+    clone->visit(clones);
+    QL_ASSERT(originals.nodes.size() == clones.nodes.size());
+    for (utils::UInt i = 0; i < originals.nodes.size(); i++) {
+        clones.nodes[i]->copy_annotations(*originals.nodes[i]);
+    }
+    clone->erase_annotation<InstructionTypeIndex>();
+    for (const auto &insn : clone->instructions) {
+        erase_specialization_indices(*insn);
+    }
+
+    // Redirect links to the copied nodes.
+    CloneMap map;
+    for (utils::UInt i = 0; i < platform->data_types.size(); i++) {
+        add_to_map(map.data_types, platform->data_types[i], clone->data_types[i]);
+    }
+    for (utils::UInt i = 0; i < platform->objects.size(); i++) {
+        add_to_map(map.physical_objects, platform->objects[i], clone->objects[i]);
+        add_to_map(map.objects, platform->objects[i], clone->objects[i]);
+    }
+    add_instruction_types_to_map(map, platform->instructions, clone->instructions);
+    for (utils::UInt i = 0; i < platform->functions.size(); i++) {
+        add_to_map(map.function_types, platform->functions[i], clone->functions[i]);
+    }
+    Relinker relinker{map};
+    clone->visit(relinker);
+
+    return clone;
+}
+
 /**
  * Returns the data type with the given name, or returns an empty link if the
  * type does not exist.
@@ -19,8 +682,8 @@ DataTypeLink find_type(const Ref &ir, const utils::Str &name) {
     auto end = ir->platform->data_types.get_vec().end();
     auto pos = std::lower_bound(
         begin, end,
-        utils::make<QubitType>(name),
-        compare_by_name<DataType>
+        name,
+        compare_name_with<DataType>
     );
     if (pos == end || (*pos)->name != name) {
         return {};
@@ -99,8 +762,8 @@ ObjectLink find_physical_object(const Ref &ir, const utils::Str &name) {
     auto end = ir->platform->objects.get_vec().end();
     auto pos = std::lower_bound(
         begin, end,
-        utils::make<PhysicalObject>(name),
-        compare_by_name<PhysicalObject>
+        name,
+        compare_name_with<PhysicalObject>
     );
     if (pos == end || (*pos)->name != name) {
         return {};
@@ -126,40 +789,48 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
     QL_ASSERT(instruction_type->specializations.empty());
     QL_ASSERT(instruction_type->template_operands.empty());
     QL_ASSERT(instruction_type->generalization.empty());
-
-    // Check its name.
-    if (!std::regex_match(instruction_type->name, IDENTIFIER_RE)) {
-        QL_USER_ERROR(
-            "invalid name for new instruction type: \"" <<
-            instruction_type->name << "\" is not a valid identifier"
-        );
-    }
+    IndexLock lock(index_mutex);
 
     // Search for an existing matching instruction.
-    auto begin = ir->platform->instructions.get_vec().begin();
-    auto end = ir->platform->instructions.get_vec().end();
-    auto pos = std::lower_bound(begin, end, instruction_type, compare_by_name<InstructionType>);
-    auto already_exists = false;
-    for (; pos != end && (*pos)->name == instruction_type->name; ++pos) {
-        if ((*pos)->operand_types.size() != instruction_type->operand_types.size()) {
-            continue;
-        }
-        auto match = true;
-        for (utils::UInt i = 0; i < (*pos)->operand_types.size(); i++) {
-            if ((*pos)->operand_types[i]->data_type != instruction_type->operand_types[i]->data_type) {
-                match = false;
+    auto &index = get_index(ir);
+    utils::One<InstructionType> existing;
+    auto it = index.by_signature.find(hash_signature(*instruction_type));
+    if (it != index.by_signature.end()) {
+        for (const auto &candidate : it->second) {
+            if (candidate->name != instruction_type->name) {
+                continue;
+            }
+            if (candidate->operand_types.size() != instruction_type->operand_types.size()) {
+                continue;
+            }
+            auto match = true;
+            for (utils::UInt i = 0; i < candidate->operand_types.size(); i++) {
+                if (candidate->operand_types[i]->data_type != instruction_type->operand_types[i]->data_type) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                existing = candidate;
                 break;
             }
         }
-        if (match) {
-            already_exists = true;
-            break;
-        }
     }
 
     // If the generalized instruction doesn't already exist, add it.
     auto added_anything = false;
-    if (!already_exists) {
+    if (existing.empty()) {
+
+        // Check its name. This is only needed when we actually add something;
+        // if an instruction type by this name already exists, the name was
+        // checked when that one was added.
+        if (!std::regex_match(instruction_type->name, IDENTIFIER_RE)) {
+            QL_USER_ERROR(
+                "invalid name for new instruction type: \"" <<
+                instruction_type->name << "\" is not a valid identifier"
+            );
+        }
+
         auto clone = instruction_type.clone();
         clone->copy_annotations(*instruction_type);
 
@@ -170,7 +841,8 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
         // the original from instruction_type at the end.
         clone->decompositions.reset();
 
-        pos = ir->platform->instructions.get_vec().insert(pos, clone);
+        insert_instruction_type(ir, index, clone);
+        existing = clone;
         added_anything = true;
     } else {
 
@@ -180,28 +852,22 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
         // descriptiveness, so we need to copy anything that must be the same
         // across specializations to the incoming instruction type in case it's
         // added.
-        for (utils::UInt i = 0; i < (*pos)->operand_types.size(); i++) {
-            instruction_type->operand_types[i]->mode = (*pos)->operand_types[i]->mode;
+        for (utils::UInt i = 0; i < existing->operand_types.size(); i++) {
+            instruction_type->operand_types[i]->mode = existing->operand_types[i]->mode;
         }
 
     }
 
     // Now create/add/look for specializations as appropriate.
-    auto ityp = *pos;
+    auto ityp = existing;
     for (utils::UInt i = 0; i < template_operands.size(); i++) {
         auto op = template_operands[i];
 
         // See if the specialization already exists, and if so, recurse into
         // it.
-        auto already_exists = false;
-        for (const auto &spec : ityp->specializations) {
-            if (spec->template_operands.back().equals(op)) {
-                already_exists = true;
-                ityp = spec;
-                break;
-            }
-        }
-        if (already_exists) {
+        auto existing_spec = find_specialization(*ityp, op);
+        if (!existing_spec.empty()) {
+            ityp = existing_spec;
             continue;
         }
 
@@ -218,6 +884,7 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
             spec->generalization.reset();
         }
         spec->decompositions.reset();
+        spec->erase_annotation<SpecializationIndex>();
 
         // Move from operand types into template operands.
         for (utils::UInt j = 0; j <= i; j++) {
@@ -229,7 +896,9 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
         }
 
         // Link the specialization up.
+        auto &spec_index = get_index(*ityp);
         ityp->specializations.add(spec);
+        add_to_index(spec_index, spec);
         spec->generalization = ityp;
         added_anything = true;
 
@@ -291,28 +960,22 @@ InstructionTypeLink find_instruction_type(
     utils::Bool generate_overload_if_needed
 ) {
     QL_ASSERT(types.size() == writable.size());
-
-    // Search for a matching instruction.
-    auto begin = ir->platform->instructions.get_vec().begin();
-    auto end = ir->platform->instructions.get_vec().end();
-    auto first = std::lower_bound(
-        begin, end,
-        utils::make<InstructionType>(name),
-        compare_by_name<InstructionType>
-    );
-    auto pos = first;
-    for (; pos != end && (*pos)->name == name; ++pos) {
-        if ((*pos)->operand_types.size() != types.size()) {
-            continue;
-        }
-        auto match = true;
-        for (utils::UInt i = 0; i < (*pos)->operand_types.size(); i++) {
-            if ((*pos)->operand_types[i]->data_type != types[i]) {
-                match = false;
-                break;
+    IndexLock lock(index_mutex);
+
+    // Search for a matching instruction using the index.
+    auto &index = get_index(ir);
+    auto it = index.by_signature.find(hash_signature(name, types));
+    if (it != index.by_signature.end()) {
+        for (const auto &candidate : it->second) {
+            if (candidate->name != name || !operand_types_match(*candidate, types)) {
+                continue;
             }
-            if (!writable[i]) {
-                switch ((*pos)->operand_types[i]->mode) {
+            auto match = true;
+            for (utils::UInt i = 0; i < types.size(); i++) {
+                if (writable[i]) {
+                    continue;
+                }
+                switch (candidate->operand_types[i]->mode) {
                     case prim::OperandMode::BARRIER:
                     case prim::OperandMode::WRITE:
                     case prim::OperandMode::UPDATE:
@@ -329,20 +992,21 @@ InstructionTypeLink find_instruction_type(
                 }
                 if (!match) break;
             }
-        }
-        if (match) {
-            return *pos;
+            if (match) {
+                return candidate;
+            }
         }
     }
 
-    // pos equalling first implies that (*pos)->name != name, i.e. there is no
-    // instruction by this name.
-    if (pos == first) {
+    // If there is no instruction by this name, stop now.
+    auto first_it = index.by_name.find(name);
+    if (first_it == index.by_name.end()) {
         return {};
     }
+    const auto &first = first_it->second;
 
     // If we shouldn't generate an overload if only the name matches, stop now.
-    if (!generate_overload_if_needed || !(*first)->has_annotation<PrototypeInferred>()) {
+    if (!generate_overload_if_needed || !first->has_annotation<PrototypeInferred>()) {
         return {};
     }
 
@@ -350,8 +1014,8 @@ InstructionTypeLink find_instruction_type(
     // parameters, conservatively assuming write access mode for references and
     // read for everything else. This is based on the first instruction we
     // encounter with this name.
-    auto ityp = first->clone();
-    ityp->copy_annotations(**first);
+    auto ityp = first.clone();
+    ityp->copy_annotations(*first);
     ityp->operand_types.reset();
     for (utils::UInt i = 0; i < types.size(); i++) {
         ityp->operand_types.emplace(
@@ -361,8 +1025,8 @@ InstructionTypeLink find_instruction_type(
     }
 
     // Insert the instruction just after all the other instructions with this
-    // name, i.e. at pos, to maintain sort order.
-    ir->platform->instructions.get_vec().insert(pos, ityp);
+    // name, to maintain sort order.
+    insert_instruction_type(ir, index, ityp);
 
     return ityp;
 }
@@ -568,18 +1232,25 @@ void specialize_instruction(
     const InstructionRef &instruction
 ) {
     if (auto custom_insn = instruction->as_custom_instruction()) {
-        utils::Bool specialization_found;
-        do {
-            specialization_found = false;
-            for (const auto &spec : custom_insn->instruction_type->specializations) {
-                if (spec->template_operands.back().equals(custom_insn->operands.front())) {
-                    custom_insn->operands.remove(0);
-                    custom_insn->instruction_type = spec;
-                    specialization_found = true;
-                    break;
-                }
+        IndexLock lock(index_mutex);
+
+        // Descend the specialization tree as far as possible, then drop the
+        // operands that became template operands all at once.
+        auto &operands = custom_insn->operands.get_vec();
+        utils::UInt num_specialized = 0;
+        while (num_specialized < operands.size()) {
+            auto spec = find_specialization(
+                *custom_insn->instruction_type,
+                operands[num_specialized]
+            );
+            if (spec.empty()) {
+                break;
             }
-        } while (specialization_found);
+            custom_insn->instruction_type = spec;
+            num_specialized++;
+        }
+        operands.erase(operands.begin(), operands.begin() + num_specialized);
+
     }
 }
 
@@ -723,8 +1394,8 @@ FunctionTypeLink find_function_type(
     auto pos = std::lower_bound(
         begin,
         end,
-        utils::make<FunctionType>(name),
-        compare_by_name<FunctionType>
+        name,
+        compare_name_with<FunctionType>
     );
     for (; pos != end && (*pos)->name == name; ++pos) {
         if ((*pos)->operand_types.size() != types.size()) {
@@ -0,0 +1,149 @@
+#include <random>
+#include <set>
+#include <vector>
+
+#include "ql/ir/ir.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/ops.h"
+
+using namespace ql;
+
+/**
+ * Makes a fully generalized test instruction type, with two qubit operands and
+ * an integer operand.
+ */
+static utils::One<ir::InstructionType> make_instruction_type(
+    const ir::DataTypeLink &qubit_type,
+    const ir::DataTypeLink &int_type
+) {
+    auto instruction_type = utils::make<ir::InstructionType>();
+    instruction_type->name = "spec_test";
+    instruction_type->operand_types.emplace(ir::prim::OperandMode::UPDATE, qubit_type);
+    instruction_type->operand_types.emplace(ir::prim::OperandMode::UPDATE, qubit_type);
+    instruction_type->operand_types.emplace(ir::prim::OperandMode::READ, int_type);
+    instruction_type->duration = 1;
+    return instruction_type;
+}
+
+/**
+ * Returns the most specialized variant of the given instruction type for the
+ * given operands by searching the specialization lists linearly, the way
+ * specialize_instruction() used to, along with the number of operands that
+ * became template operands.
+ */
+static utils::Pair<ir::InstructionTypeLink, utils::UInt> find_linear(
+    ir::InstructionTypeLink instruction_type,
+    const utils::Any<ir::Expression> &operands
+) {
+    utils::UInt num_specialized = 0;
+    while (num_specialized < operands.size()) {
+        ir::InstructionTypeLink found;
+        for (const auto &spec : instruction_type->specializations) {
+            if (spec->template_operands.back().equals(operands[num_specialized])) {
+                found = spec;
+                break;
+            }
+        }
+        if (found.empty()) {
+            break;
+        }
+        instruction_type = found;
+        num_specialized++;
+    }
+    return {instruction_type, num_specialized};
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    auto ir = ir::convert_old_to_new(program);
+    auto qubit_type = ir::get_type_of(ir::make_qubit_ref(ir, 0));
+    auto int_type = ir->platform->default_int_type;
+
+    // A variable that is used as a template operand. References without
+    // literal indices can't be hashed, so these specializations are searched
+    // linearly.
+    auto var = ir::make_temporary(ir, int_type);
+
+    // Add the generalized instruction type, and a random set of
+    // specializations for the first one, two, or all three operands. The
+    // third is either an integer literal or the variable (-1). Qubit 6 is left
+    // out of the first operand for the test below. The keys are added in
+    // lexicographical order, so each key is added after its prefixes; adding a
+    // prefix after a longer key would fail, because the prefix is then
+    // already added implicitly.
+    std::mt19937 rng(42);
+    auto generic = ir::add_instruction_type(ir, make_instruction_type(qubit_type, int_type));
+    std::set<std::vector<utils::Int>> keys;
+    for (utils::UInt i = 0; i < 100; i++) {
+        std::vector<utils::Int> key = {
+            (utils::Int)(rng() % 6),
+            (utils::Int)(rng() % 7),
+            (utils::Int)(rng() % 5) - 1
+        };
+        key.resize(rng() % 3 + 1);
+        keys.insert(key);
+    }
+    for (const auto &key : keys) {
+        utils::Any<ir::Expression> template_operands;
+        template_operands.add(ir::make_qubit_ref(ir, key[0]));
+        if (key.size() > 1) {
+            template_operands.add(ir::make_qubit_ref(ir, key[1]));
+        }
+        if (key.size() > 2) {
+            if (key[2] < 0) {
+                template_operands.add(ir::make_reference(ir, var));
+            } else {
+                template_operands.add(ir::make_int_lit(ir, key[2]));
+            }
+        }
+        ir::add_instruction_type(ir, make_instruction_type(qubit_type, int_type), template_operands);
+    }
+
+    // Instructions built for random operands must use the same specialization
+    // as a linear search would find, also after generalizing and specializing
+    // them again.
+    for (utils::UInt i = 0; i < 500; i++) {
+        utils::Any<ir::Expression> operands;
+        operands.add(ir::make_qubit_ref(ir, rng() % 7));
+        operands.add(ir::make_qubit_ref(ir, rng() % 7));
+        auto value = (utils::Int)(rng() % 6) - 1;
+        if (value < 0) {
+            operands.add(ir::make_reference(ir, var));
+        } else {
+            operands.add(ir::make_int_lit(ir, value));
+        }
+        auto expected = find_linear(generic, operands);
+
+        auto insn = ir::make_instruction(ir, "spec_test", operands);
+        auto custom = insn->as_custom_instruction();
+        QL_ASSERT(custom);
+        QL_ASSERT(custom->instruction_type.get_ptr() == expected.first.get_ptr());
+        QL_ASSERT_EQ(custom->operands.size(), 3 - expected.second);
+
+        ir::generalize_instruction(insn);
+        QL_ASSERT(custom->instruction_type.get_ptr() == generic.get_ptr());
+        QL_ASSERT_EQ(custom->operands.size(), 3);
+        ir::specialize_instruction(insn);
+        QL_ASSERT(custom->instruction_type.get_ptr() == expected.first.get_ptr());
+        QL_ASSERT_EQ(custom->operands.size(), 3 - expected.second);
+    }
+
+    // Specializations added by modifying the list directly are found after
+    // invalidating the indices.
+    auto spec = make_instruction_type(qubit_type, int_type);
+    spec->operand_types.remove(0);
+    spec->template_operands.add(ir::make_qubit_ref(ir, 6));
+    spec->generalization = generic;
+    generic->specializations.add(spec);
+    ir::invalidate_instruction_type_indices(ir);
+    utils::Any<ir::Expression> operands;
+    operands.add(ir::make_qubit_ref(ir, 6));
+    operands.add(ir::make_qubit_ref(ir, 0));
+    operands.add(ir::make_int_lit(ir, 0));
+    auto insn = ir::make_instruction(ir, "spec_test", operands);
+    QL_ASSERT(insn->as_custom_instruction()->instruction_type.get_ptr() == spec.get_ptr());
+    QL_ASSERT_EQ(insn->as_custom_instruction()->operands.size(), 2);
+
+    return 0;
+}
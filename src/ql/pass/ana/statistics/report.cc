@@ -6,6 +6,9 @@
 
 #include "ql/utils/filesystem.h"
 #include "ql/com/ana/metrics.h"
+#include "ql/com/ana/metric_set.h"
+#include "ql/com/ana/interaction_graph.h"
+#include "ql/com/options.h"
 
 namespace ql {
 namespace pass {
@@ -13,29 +16,165 @@ namespace ana {
 namespace statistics {
 namespace report {
 
+namespace {
+
 /**
- * Dumps basic statistics for the given kernel to the given output stream.
+ * The values reported for a block or program.
  */
-void dump(
-    const ir::Ref &ir,
+struct Results {
+    utils::UInt latency;
+    utils::UInt executed_latency;
+    utils::UInt quantum_gates;
+    utils::UInt executed_quantum_gates;
+    utils::UInt multi_qubit_gates;
+    utils::UInt classical_operations;
+    utils::UInt qubits_used;
+    utils::SparseMap<utils::UInt, utils::UInt, 0> qubit_cycles;
+    utils::UInt interacting_pairs;
+};
+
+/**
+ * The set of metrics used for the statistics report, computed in a single
+ * traversal.
+ */
+class ReportMetrics {
+private:
+    com::ana::MetricSet metrics;
+    com::ana::MetricHandle<com::ana::Latency> latency = metrics.add<com::ana::Latency>();
+    com::ana::MetricHandle<com::ana::Latency> executed_latency = metrics.add<com::ana::Latency>(true);
+    com::ana::MetricHandle<com::ana::QuantumGateCount> quantum_gates = metrics.add<com::ana::QuantumGateCount>();
+    com::ana::MetricHandle<com::ana::QuantumGateCount> executed_quantum_gates = metrics.add<com::ana::QuantumGateCount>(true);
+    com::ana::MetricHandle<com::ana::MultiQubitGateCount> multi_qubit_gates = metrics.add<com::ana::MultiQubitGateCount>();
+    com::ana::MetricHandle<com::ana::ClassicalOperationCount> classical_operations = metrics.add<com::ana::ClassicalOperationCount>();
+    com::ana::MetricHandle<com::ana::QubitUsageCount> qubit_usage = metrics.add<com::ana::QubitUsageCount>();
+    com::ana::MetricHandle<com::ana::QubitUsedCycleCount> qubit_cycles = metrics.add<com::ana::QubitUsedCycleCount>();
+    com::ana::MetricHandle<com::ana::MultiQubitInteractions> interactions = metrics.add<com::ana::MultiQubitInteractions>();
+
+public:
+
+    /**
+     * Computes the metrics for the given block.
+     */
+    void compute_block(const ir::Ref &ir, const ir::BlockBaseRef &block) {
+        metrics.compute_block(ir, block);
+    }
+
+    /**
+     * Computes the metrics for each block of the program and for the program
+     * as a whole.
+     */
+    void compute_program(const ir::Ref &ir) {
+        metrics.compute_program(ir, com::options::global["num_threads"].as_uint());
+    }
+
+    /**
+     * Returns the results for the block with the given index.
+     */
+    Results get_block_results(utils::UInt block) const {
+        Results results;
+        results.latency = metrics.get_block_result(latency, block);
+        results.executed_latency = metrics.get_block_result(executed_latency, block);
+        results.quantum_gates = metrics.get_block_result(quantum_gates, block);
+        results.executed_quantum_gates = metrics.get_block_result(executed_quantum_gates, block);
+        results.multi_qubit_gates = metrics.get_block_result(multi_qubit_gates, block);
+        results.classical_operations = metrics.get_block_result(classical_operations, block);
+        results.qubits_used = metrics.get_block_result(qubit_usage, block).sparse_size();
+        results.qubit_cycles = metrics.get_block_result(qubit_cycles, block);
+        results.interacting_pairs = metrics.get_block_result(interactions, block).get_num_edges();
+        return results;
+    }
+
+    /**
+     * Returns the results for the program as a whole.
+     */
+    Results get_program_results() const {
+        Results results;
+        results.latency = metrics.get_program_result(latency);
+        results.executed_latency = metrics.get_program_result(executed_latency);
+        results.quantum_gates = metrics.get_program_result(quantum_gates);
+        results.executed_quantum_gates = metrics.get_program_result(executed_quantum_gates);
+        results.multi_qubit_gates = metrics.get_program_result(multi_qubit_gates);
+        results.classical_operations = metrics.get_program_result(classical_operations);
+        results.qubits_used = metrics.get_program_result(qubit_usage).sparse_size();
+        results.qubit_cycles = metrics.get_program_result(qubit_cycles);
+        results.interacting_pairs = metrics.get_program_result(interactions).get_num_edges();
+        return results;
+    }
+
+};
+
+/**
+ * Dumps the given statistics for a block to the given output stream.
+ */
+void dump_block_results(
+    const Results &results,
     const ir::BlockRef &block,
     std::ostream &os,
     const utils::Str &line_prefix
 ) {
-    using namespace com::ana;
-
-    os << line_prefix << "Duration (assuming no control-flow): " << compute_block<Latency>(ir, block) << "\n";
-    os << line_prefix << "Number of quantum gates: " << compute_block<QuantumGateCount>(ir, block) << "\n";
-    os << line_prefix << "Number of multi-qubit gates: " << compute_block<MultiQubitGateCount>(ir, block) << "\n";
-    os << line_prefix << "Number of classical operations: " << compute_block<ClassicalOperationCount>(ir, block) << "\n";
-    os << line_prefix << "Number of qubits used: " << compute_block<QubitUsageCount>(ir, block).sparse_size() << "\n";
-    os << line_prefix << "Qubit cycles use (assuming no control-flow): " << compute_block<QubitUsedCycleCount>(ir, block) << "\n";
+    os << line_prefix << "Duration (assuming no control-flow): " << results.latency << "\n";
+    if (results.executed_latency != results.latency) {
+        os << line_prefix << "Duration (with static loops unrolled): " << results.executed_latency << "\n";
+    }
+    os << line_prefix << "Number of quantum gates: " << results.quantum_gates << "\n";
+    if (results.executed_quantum_gates != results.quantum_gates) {
+        os << line_prefix << "Number of executed quantum gates (with static loops unrolled): " << results.executed_quantum_gates << "\n";
+    }
+    os << line_prefix << "Number of multi-qubit gates: " << results.multi_qubit_gates << "\n";
+    os << line_prefix << "Number of classical operations: " << results.classical_operations << "\n";
+    os << line_prefix << "Number of qubits used: " << results.qubits_used << "\n";
+    os << line_prefix << "Qubit cycles use (assuming no control-flow): " << results.qubit_cycles << "\n";
+    os << line_prefix << "Number of interacting qubit pairs: " << results.interacting_pairs << "\n";
     for (const auto &line : AdditionalStats::pop(block)) {
         os << line_prefix << "----- " << line << "\n";
     }
     os.flush();
 }
 
+/**
+ * Dumps the given global statistics for a program to the given output stream.
+ */
+void dump_program_results(
+    const Results &results,
+    const ir::ProgramRef &program,
+    std::ostream &os,
+    const utils::Str &line_prefix
+) {
+    os << line_prefix << "Total duration (assuming no control-flow): " << results.latency << "\n";
+    if (results.executed_latency != results.latency) {
+        os << line_prefix << "Total duration (with static loops unrolled): " << results.executed_latency << "\n";
+    }
+    os << line_prefix << "Total number of quantum gates: " << results.quantum_gates << "\n";
+    if (results.executed_quantum_gates != results.quantum_gates) {
+        os << line_prefix << "Total number of executed quantum gates (with static loops unrolled): " << results.executed_quantum_gates << "\n";
+    }
+    os << line_prefix << "Total number of multi-qubit gates: " << results.multi_qubit_gates << "\n";
+    os << line_prefix << "Total number of classical operations: " << results.classical_operations << "\n";
+    os << line_prefix << "Number of qubits used: " << results.qubits_used << "\n";
+    os << line_prefix << "Qubit cycles use (assuming no control-flow): " << results.qubit_cycles << "\n";
+    os << line_prefix << "Number of interacting qubit pairs: " << results.interacting_pairs << "\n";
+    for (const auto &line : AdditionalStats::pop(program)) {
+        os << line_prefix << line << "\n";
+    }
+    os.flush();
+}
+
+} // anonymous namespace
+
+/**
+ * Dumps basic statistics for the given kernel to the given output stream.
+ */
+void dump(
+    const ir::Ref &ir,
+    const ir::BlockRef &block,
+    std::ostream &os,
+    const utils::Str &line_prefix
+) {
+    ReportMetrics metrics;
+    metrics.compute_block(ir, block);
+    dump_block_results(metrics.get_block_results(0), block, os, line_prefix);
+}
+
 /**
  * Dumps basic statistics for the given program to the given output stream. This
  * only dumps the global statistics, not the statistics for each individual
@@ -47,23 +186,15 @@ void dump(
     std::ostream &os,
     const utils::Str &line_prefix
 ) {
-    using namespace com::ana;
-
-    os << line_prefix << "Total duration (assuming no control-flow): " << compute_program<Latency>(ir) << "\n";
-    os << line_prefix << "Total number of quantum gates: " << compute_program<QuantumGateCount>(ir) << "\n";
-    os << line_prefix << "Total number of multi-qubit gates: " << compute_program<MultiQubitGateCount>(ir) << "\n";
-    os << line_prefix << "Total number of classical operations: " << compute_program<ClassicalOperationCount>(ir) << "\n";
-    os << line_prefix << "Number of qubits used: " << compute_program<QubitUsageCount>(ir).sparse_size() << "\n";
-    os << line_prefix << "Qubit cycles use (assuming no control-flow): " << compute_program<QubitUsedCycleCount>(ir) << "\n";
-    for (const auto &line : AdditionalStats::pop(program)) {
-        os << line_prefix << line << "\n";
-    }
-    os.flush();
+    ReportMetrics metrics;
+    metrics.compute_program(ir);
+    dump_program_results(metrics.get_program_results(), program, os, line_prefix);
 }
 
 /**
  * Dumps statistics for the given program and its kernels to the given output
- * stream.
+ * stream. All statistics are computed in a single traversal of the program,
+ * processing the blocks in parallel.
  */
 void dump_all(
     const ir::Ref &ir,
@@ -73,13 +204,16 @@ void dump_all(
     if (ir->program.empty()) {
         os << line_prefix << "no program node to dump statistics for" << std::endl;
     } else {
-        for (const auto &block : ir->program->blocks) {
-            os << line_prefix << "For block with name \"" << block->name << "\":\n";
-            dump(ir, block, os, line_prefix + "    ");
+        ReportMetrics metrics;
+        metrics.compute_program(ir);
+        const auto &blocks = ir->program->blocks;
+        for (utils::UInt i = 0; i < blocks.size(); i++) {
+            os << line_prefix << "For block with name \"" << blocks[i]->name << "\":\n";
+            dump_block_results(metrics.get_block_results(i), blocks[i], os, line_prefix + "    ");
             os << "\n";
         }
         os << line_prefix << "Global statistics:\n";
-        dump(ir, ir->program, os, line_prefix);
+        dump_program_results(metrics.get_program_results(), ir->program, os, line_prefix);
     }
 }
 
@@ -57,7 +57,11 @@ void VisualizeCircuitPass::dump_docs(
       NOTE: when the to-be-visualized circuit is very large, the interactive
       window may have trouble rendering the circuit even when zoomed in.
       Therefore, it is recommended to use non-interactive mode and view the
-      generated bitmap with a more capable external viewer.
+      generated bitmap with a more capable external viewer. For very long
+      circuits, even the bitmap may become too large to generate; in that
+      case, use the `image_format` option to generate an SVG image instead,
+      and/or the `tile_cycles` option to split the circuit over multiple
+      images.
 
       The `"circuit"` section has several child sections.
 
@@ -358,7 +362,29 @@ VisualizeCircuitPass::VisualizeCircuitPass(
     options.add_bool(
         "interactive",
         "When yes, the visualizer will open a window when the pass is run. "
-        "When no, an image will be saved as <output_prefix>.bmp instead."
+        "When no, an image will be saved as <output_prefix>.bmp (or .svg) "
+        "instead. Interactive mode requires untiled bmp output."
+    );
+    options.add_enum(
+        "image_format",
+        "The format of the generated image(s). bmp renders a raster image, "
+        "the memory footprint of which scales with the image area. svg writes "
+        "a vector image instead, which is usually much smaller and can be "
+        "zoomed into freely.",
+        "bmp",
+        {"bmp", "svg"}
+    );
+    options.add_int(
+        "tile_cycles",
+        "When nonzero, the circuit is rendered as a series of images (tiles) "
+        "of at most this many cycles each, rather than as a single image, so "
+        "long circuits can be visualized with bounded memory. Ranges of cut "
+        "(empty) cycles are never split over two tiles, so a tile that would "
+        "end in one is extended to the end of it. The tiles are "
+        "saved as <output_prefix>_<index>.bmp (or .svg), and an index of the "
+        "tiles and their cycle ranges is written to "
+        "<output_prefix>_index.json.",
+        "0", 0
     );
 }
 
@@ -377,7 +403,9 @@ utils::Int VisualizeCircuitPass::run(
             options["waveform_mapping"].as_str(),
             options["interactive"].as_bool(),
             context.output_prefix,
-            context.full_pass_name
+            context.full_pass_name,
+            options["image_format"].as_str() == "svg" ? detail::ImageFormat::SVG : detail::ImageFormat::BMP,
+            options["tile_cycles"].as_uint()
         }
     );
     return 0;
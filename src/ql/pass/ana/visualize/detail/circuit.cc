@@ -7,7 +7,14 @@
 #include "circuit.h"
 
 #include <regex>
+#include <iomanip>
+#include <fstream>
+#include <mutex>
+#include <algorithm>
 #include "ql/utils/exception.h"
+#include "ql/utils/filesystem.h"
+#include "ql/utils/parallel.h"
+#include "ql/com/options.h"
 #include "common.h"
 
 namespace ql {
@@ -540,31 +547,14 @@ void Structure::printProperties() const {
     }
 }
 
-void visualizeCircuit(const ir::compat::ProgramRef &program, const VisualizerConfiguration &configuration) {
-    const Vec<GateProperties> gates = parseGates(program);
-    const Int cycleDuration = utoi(program->platform->cycle_time);
-    const Int amountOfCycles = calculateAmountOfCycles(gates, cycleDuration);
-    const Vec<Int> minCycleWidths(amountOfCycles, 0);
-
-    // Generate the image.
-    ImageOutput imageOutput = generateImage(program, configuration, minCycleWidths, 0);
-
-    // Save the image if enabled.
-    if (imageOutput.circuitLayout.saveImage || !configuration.interactive) {
-        imageOutput.image.save(configuration.output_prefix + ".bmp");
-    }
-
-    // Display the image if enabled.
-    if (configuration.interactive) {
-        QL_DOUT("Displaying image...");
-        imageOutput.image.display("Quantum Circuit (" + configuration.pass_name + ")");
-    }
-}
-
-ImageOutput generateImage(const ir::compat::ProgramRef &program, const VisualizerConfiguration &configuration, const Vec<Int> &minCycleWidths, const utils::Int extendedImageHeight) {
+/**
+ * Parses the gates of the given program into gates, and loads and validates
+ * the circuit layout for them.
+ */
+static CircuitLayout prepareCircuit(const ir::compat::ProgramRef &program, const VisualizerConfiguration &configuration, Vec<GateProperties> &gates) {
     // Get the gate list from the program.
     QL_DOUT("Getting gate list...");
-    Vec<GateProperties> gates = parseGates(program);
+    gates = parseGates(program);
     if (gates.size() == 0) {
         QL_FATAL("Quantum program contains no gates!");
     }
@@ -573,35 +563,68 @@ ImageOutput generateImage(const ir::compat::ProgramRef &program, const Visualize
     CircuitLayout layout = parseCircuitConfiguration(gates, configuration.visualizerConfigPath, program->platform->get_instructions());
     validateCircuitLayout(layout, configuration.visualizationType);
 
-    // Calculate circuit properties.
-    QL_DOUT("Calculating circuit properties...");
-    const Int cycleDuration = utoi(program->platform->cycle_time);
-    QL_DOUT("Cycle duration is: " + to_string(cycleDuration) + " ns.");
     // Fix measurement gates without classical operands.
     fixMeasurementOperands(gates);
 
-    // Initialize the circuit properties.
-    CircuitData circuitData(gates, layout, cycleDuration);
-    circuitData.printProperties();
+    return layout;
+}
 
-    // Initialize the structure of the visualization.
-    QL_DOUT("Initializing visualization structure...");
-    Structure structure(layout, circuitData, minCycleWidths, extendedImageHeight);
-    structure.printProperties();
+/**
+ * Returns the largest number of cycles spanned by any of the given gates, and
+ * at least 1.
+ */
+static Int calculateMaxGateCycles(const Vec<GateProperties> &gates, const Int cycleDuration) {
+    Int maxGateCycles = 1;
+    for (const GateProperties &gate : gates) {
+        maxGateCycles = max(maxGateCycles, (gate.duration + cycleDuration - 1) / cycleDuration);
+    }
+    return maxGateCycles;
+}
 
-    // Initialize image.
-    QL_DOUT("Initializing image...");
-    Image image(structure.getImageWidth(), structure.getImageHeight());
-    image.fill(layout.backgroundColor);
+/**
+ * Loads the waveform mapping and generates the pulse lines of each qubit if
+ * pulse visualization is enabled. Returns an empty vector otherwise.
+ */
+static Vec<QubitLines> prepareQubitLines(const VisualizerConfiguration &configuration,
+                                         const CircuitLayout &layout,
+                                         const Vec<GateProperties> &gates,
+                                         const CircuitData &circuitData) {
+    if (!layout.pulses.areEnabled()) {
+        return {};
+    }
+    const PulseVisualization pulseVisualization = parseWaveformMapping(configuration.waveformMappingPath);
+    return generateQubitLines(gates, pulseVisualization, circuitData);
+}
+
+/**
+ * Draws the circuit onto the given image. Only cycles firstCycle up to and
+ * including lastCycle are drawn, along with the cycles before them that
+ * contain gates that may extend into that range. maxGateCycles and
+ * linesPerQubit must come from calculateMaxGateCycles() and
+ * prepareQubitLines(); they cover the whole circuit, so they are computed
+ * once by the caller rather than for each tile.
+ */
+static void drawCircuit(Image &image,
+                        const CircuitLayout &layout,
+                        const CircuitData &circuitData,
+                        const Structure &structure,
+                        const Int maxGateCycles,
+                        const Vec<QubitLines> &linesPerQubit,
+                        const Int firstCycle,
+                        const Int lastCycle) {
+
+    // Gates can span multiple cycles, so the gates that are visible in the
+    // given range may start before it.
+    const Int firstDrawnCycle = max<Int>(0, firstCycle - maxGateCycles + 1);
 
     // Draw the cycle labels if the option has been set.
     if (layout.cycles.labels.areEnabled()) {
-        drawCycleLabels(image, layout, circuitData, structure);
+        drawCycleLabels(image, layout, circuitData, structure, firstCycle, lastCycle);
     }
 
     // Draw the cycle edges if the option has been set.
     if (layout.cycles.edges.areEnabled()) {
-        drawCycleEdges(image, layout, circuitData, structure);
+        drawCycleEdges(image, layout, circuitData, structure, firstCycle, lastCycle);
     }
 
     // Draw the bit line edges if enabled.
@@ -616,25 +639,25 @@ ImageOutput generateImage(const ir::compat::ProgramRef &program, const Visualize
 
     // Draw the circuit as pulses if enabled.
     if (layout.pulses.areEnabled()) {
-        PulseVisualization pulseVisualization = parseWaveformMapping(configuration.waveformMappingPath);
-        const Vec<QubitLines> linesPerQubit = generateQubitLines(gates, pulseVisualization, circuitData);
-
         // Draw the lines of each qubit.
         QL_DOUT("Drawing qubit lines for pulse visualization...");
         for (Int qubitIndex = 0; qubitIndex < circuitData.amountOfQubits; qubitIndex++) {
             const Int yBase = structure.getCellPosition(0, qubitIndex, QUANTUM).y0;
 
-            drawLine(image, structure, cycleDuration, linesPerQubit[qubitIndex].microwave, qubitIndex,
+            drawLine(image, structure, circuitData.cycleDuration, linesPerQubit[qubitIndex].microwave, qubitIndex,
+                firstDrawnCycle, lastCycle,
                 yBase,
                 layout.pulses.getPulseRowHeightMicrowave(),
                 layout.pulses.getPulseColorMicrowave());
 
-            drawLine(image, structure, cycleDuration, linesPerQubit[qubitIndex].flux, qubitIndex,
+            drawLine(image, structure, circuitData.cycleDuration, linesPerQubit[qubitIndex].flux, qubitIndex,
+                firstDrawnCycle, lastCycle,
                 yBase + layout.pulses.getPulseRowHeightMicrowave(),
                 layout.pulses.getPulseRowHeightFlux(),
                 layout.pulses.getPulseColorFlux());
 
-            drawLine(image, structure, cycleDuration, linesPerQubit[qubitIndex].readout, qubitIndex,
+            drawLine(image, structure, circuitData.cycleDuration, linesPerQubit[qubitIndex].readout, qubitIndex,
+                firstDrawnCycle, lastCycle,
                 yBase + layout.pulses.getPulseRowHeightMicrowave() + layout.pulses.getPulseRowHeightFlux(),
                 layout.pulses.getPulseRowHeightReadout(),
                 layout.pulses.getPulseColorReadout());
@@ -705,7 +728,7 @@ ImageOutput generateImage(const ir::compat::ProgramRef &program, const Visualize
 
         // Draw the cycles.
         QL_DOUT("Drawing cycles...");
-        for (Int i = 0; i < circuitData.getAmountOfCycles(); i++) {
+        for (Int i = firstDrawnCycle; i <= lastCycle; i++) {
             // Only draw a cut cycle if its the first in its cut range.
             if (circuitData.isCycleCut(i)) {
                 if (i > 0 && !circuitData.isCycleCut(i - 1)) {
@@ -717,6 +740,153 @@ ImageOutput generateImage(const ir::compat::ProgramRef &program, const Visualize
             }
         }
     }
+}
+
+/**
+ * Renders the circuit as a series of images (tiles) of at most
+ * configuration.tileCycles cycles each, such that only one tile needs to be in
+ * memory at any time. The exception is a range of cut cycles, which is drawn
+ * only at its first cycle and therefore never split over two tiles; a tile that
+ * would end inside one is extended to the end of the range instead. Each tile
+ * repeats the bit line labels. An index file
+ * named <output_prefix>_index.json is written alongside the tiles, listing the
+ * file name, cycle range, and dimensions of each tile.
+ */
+static void visualizeCircuitTiled(const ir::compat::ProgramRef &program, const VisualizerConfiguration &configuration, const Vec<Int> &minCycleWidths) {
+    Vec<GateProperties> gates;
+    const CircuitLayout layout = prepareCircuit(program, configuration, gates);
+    const CircuitData circuitData(gates, layout, utoi(program->platform->cycle_time));
+    circuitData.printProperties();
+    const Structure structure(layout, circuitData, minCycleWidths, 0);
+    structure.printProperties();
+    const Int maxGateCycles = calculateMaxGateCycles(gates, circuitData.cycleDuration);
+    const Vec<QubitLines> linesPerQubit = prepareQubitLines(configuration, layout, gates, circuitData);
+
+    // Everything left of the first cycle (the border and the bit line label
+    // column) is repeated on each tile, as is the border on the right.
+    const Int amountOfCycles = circuitData.getAmountOfCycles();
+    const Int leftWidth = structure.getCellPosition(0, 0, QUANTUM).x0;
+    const Int rightWidth = layout.grid.getBorderSize();
+    const Int imageHeight = structure.getImageHeight();
+    const Int tileCycles = utoi(configuration.tileCycles);
+    const Str extension = getImageExtension(configuration.imageFormat);
+
+    // Tile file names in the index are relative to the directory of the index
+    // file.
+    const auto slash = configuration.output_prefix.find_last_of('/');
+    const Str baseName = slash == Str::npos ? configuration.output_prefix : configuration.output_prefix.substr(slash + 1);
+
+    Json tiles = Json::array();
+    Int tileIndex = 0;
+    for (Int firstCycle = 0; firstCycle < amountOfCycles; tileIndex++) {
+        // Don't end the tile inside a range of cut cycles.
+        Int lastCycle = min(firstCycle + tileCycles, amountOfCycles) - 1;
+        while (lastCycle < amountOfCycles - 1 && circuitData.isCycleCut(lastCycle) && circuitData.isCycleCut(lastCycle + 1)) {
+            lastCycle++;
+        }
+        const Int x0 = structure.getCellPosition(firstCycle, 0, QUANTUM).x0;
+        const Int x1 = structure.getCellPosition(lastCycle, 0, QUANTUM).x1;
+        const Int tileWidth = leftWidth + (x1 - x0) + rightWidth;
+        QL_DOUT("Drawing tile " << tileIndex << " with cycles " << firstCycle << " to " << lastCycle << "...");
+
+        Image image(tileWidth, imageHeight, configuration.imageFormat);
+        image.fill(layout.backgroundColor);
+        image.setOrigin(x0 - leftWidth, 0);
+        drawCircuit(image, layout, circuitData, structure, maxGateCycles, linesPerQubit, firstCycle, lastCycle);
+
+        // Clear whatever was drawn of the neighboring tiles in the margins,
+        // and redraw the bit line labels.
+        image.setOrigin(0, 0);
+        if (firstCycle > 0) {
+            image.drawFilledRectangle(0, 0, leftWidth - 1, imageHeight, layout.backgroundColor);
+            if (layout.bitLines.labels.areEnabled()) {
+                drawBitLineLabels(image, layout, circuitData, structure);
+            }
+        }
+        if (lastCycle < amountOfCycles - 1) {
+            image.drawFilledRectangle(tileWidth - rightWidth, 0, tileWidth, imageHeight, layout.backgroundColor);
+        }
+
+        const Str fileName = baseName + "_" + to_string(tileIndex) + "." + extension;
+        image.save(configuration.output_prefix + "_" + to_string(tileIndex) + "." + extension);
+        tiles.push_back({
+            {"file", fileName},
+            {"firstCycle", firstCycle},
+            {"lastCycle", lastCycle},
+            {"width", tileWidth},
+            {"height", imageHeight}
+        });
+        firstCycle = lastCycle + 1;
+    }
+
+    Json index;
+    index["format"] = extension;
+    index["cycleDuration"] = circuitData.cycleDuration;
+    index["amountOfCycles"] = amountOfCycles;
+    index["tileCycles"] = tileCycles;
+    index["tiles"] = tiles;
+    OutFile(configuration.output_prefix + "_index.json") << std::setw(4) << index << std::endl;
+}
+
+void visualizeCircuit(const ir::compat::ProgramRef &program, const VisualizerConfiguration &configuration) {
+    const Vec<GateProperties> gates = parseGates(program);
+    const Int cycleDuration = utoi(program->platform->cycle_time);
+    const Int amountOfCycles = calculateAmountOfCycles(gates, cycleDuration);
+    const Vec<Int> minCycleWidths(amountOfCycles, 0);
+
+    // Neither SVG images nor tiles can be displayed.
+    if (configuration.interactive && (configuration.imageFormat != ImageFormat::BMP || configuration.tileCycles > 0)) {
+        QL_FATAL("Interactive mode requires untiled BMP output!");
+    }
+
+    // Render the circuit in tiles if enabled.
+    if (configuration.tileCycles > 0) {
+        visualizeCircuitTiled(program, configuration, minCycleWidths);
+        return;
+    }
+
+    // Generate the image.
+    ImageOutput imageOutput = generateImage(program, configuration, minCycleWidths, 0);
+
+    // Save the image if enabled.
+    if (imageOutput.circuitLayout.saveImage || !configuration.interactive) {
+        imageOutput.image.save(configuration.output_prefix + "." + getImageExtension(configuration.imageFormat));
+    }
+
+    // Display the image if enabled.
+    if (configuration.interactive) {
+        QL_DOUT("Displaying image...");
+        imageOutput.image.display("Quantum Circuit (" + configuration.pass_name + ")");
+    }
+}
+
+ImageOutput generateImage(const ir::compat::ProgramRef &program, const VisualizerConfiguration &configuration, const Vec<Int> &minCycleWidths, const utils::Int extendedImageHeight) {
+    Vec<GateProperties> gates;
+    CircuitLayout layout = prepareCircuit(program, configuration, gates);
+
+    // Calculate circuit properties.
+    QL_DOUT("Calculating circuit properties...");
+    const Int cycleDuration = utoi(program->platform->cycle_time);
+    QL_DOUT("Cycle duration is: " + to_string(cycleDuration) + " ns.");
+
+    // Initialize the circuit properties.
+    CircuitData circuitData(gates, layout, cycleDuration);
+    circuitData.printProperties();
+
+    // Initialize the structure of the visualization.
+    QL_DOUT("Initializing visualization structure...");
+    Structure structure(layout, circuitData, minCycleWidths, extendedImageHeight);
+    structure.printProperties();
+
+    // Initialize image.
+    QL_DOUT("Initializing image...");
+    Image image(structure.getImageWidth(), structure.getImageHeight(), configuration.imageFormat);
+    image.fill(layout.backgroundColor);
+
+    // Draw the circuit.
+    const Int maxGateCycles = calculateMaxGateCycles(gates, circuitData.cycleDuration);
+    const Vec<QubitLines> linesPerQubit = prepareQubitLines(configuration, layout, gates, circuitData);
+    drawCircuit(image, layout, circuitData, structure, maxGateCycles, linesPerQubit, 0, circuitData.getAmountOfCycles() - 1);
 
     return {image, layout, circuitData, structure};
 }
@@ -1080,12 +1250,40 @@ void validateCircuitLayout(CircuitLayout &layout, const Str &visualizationType)
 }
 
 PulseVisualization parseWaveformMapping(const Str &waveformMappingPath) {
+
+    // Parsed waveform mappings are cached by path, along with the file
+    // contents they were parsed from, such that the (potentially very large)
+    // file only needs to be parsed again when it changes. The waveforms are
+    // shared, so returning a copy of the cached mapping is cheap.
+    static std::mutex cacheMutex;
+    static Map<Str, Pair<Str, PulseVisualization>> cache;
+
+    // Read the waveform mapping file.
+    Str contents;
+    {
+        std::ifstream ifs(waveformMappingPath);
+        if (!ifs.is_open()) {
+            QL_FATAL("Failed to load the visualization waveform mapping file:\n\tfailed to open file '" << waveformMappingPath << "'");
+        }
+        StrStrm ss;
+        ss << ifs.rdbuf();
+        contents = ss.str();
+    }
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(waveformMappingPath);
+        if (it != cache.end() && it->second.first == contents) {
+            QL_DOUT("Using cached waveform mapping...");
+            return it->second.second;
+        }
+    }
+
     QL_DOUT("Parsing waveform mapping configuration file...");
 
-    // Read the waveform mapping Json file.
+    // Parse the waveform mapping Json file.
     Json waveformMapping;
     try {
-        waveformMapping = load_json(waveformMappingPath);
+        waveformMapping = parse_json(contents);
     } catch (Json::exception &e) {
         QL_FATAL("Failed to load the visualization waveform mapping file:\n\t" << Str(e.what()));
     }
@@ -1144,13 +1342,13 @@ PulseVisualization parseWaveformMapping(const Str &waveformMappingPath) {
                 auto gatePulsesMapping = qubitMap.value();
 
                 // Read the pulses from the pulse mapping.
-                Vec<Real> microwave;
-                Vec<Real> flux;
-                Vec<Real> readout;
+                Waveform microwave;
+                Waveform flux;
+                Waveform readout;
                 try {
-                    if (gatePulsesMapping.contains("microwave")) microwave = gatePulsesMapping["microwave"].get<Vec<Real>>();
-                    if (gatePulsesMapping.contains("flux")) flux = gatePulsesMapping["flux"].get<Vec<Real>>();
-                    if (gatePulsesMapping.contains("readout")) readout = gatePulsesMapping["readout"].get<Vec<Real>>();
+                    if (gatePulsesMapping.contains("microwave")) microwave.emplace(gatePulsesMapping["microwave"].get<Vec<Real>>());
+                    if (gatePulsesMapping.contains("flux")) flux.emplace(gatePulsesMapping["flux"].get<Vec<Real>>());
+                    if (gatePulsesMapping.contains("readout")) readout.emplace(gatePulsesMapping["readout"].get<Vec<Real>>());
                 } catch (const Exception &e) {
                     QL_FATAL("Exception while parsing waveforms from waveform mapping file:\n\t" << e.what()
                          << "\n\tMake sure the waveforms are arrays of Integers!" );
@@ -1204,6 +1402,12 @@ PulseVisualization parseWaveformMapping(const Str &waveformMappingPath) {
     //     }
     // }
 
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache.erase(waveformMappingPath);
+        cache.insert({waveformMappingPath, {contents, pulseVisualization}});
+    }
+
     return pulseVisualization;
 }
 
@@ -1222,9 +1426,12 @@ Vec<QubitLines> generateQubitLines(const Vec<GateProperties> &gates,
         }
     }
 
-    // Calculate the line segments for each qubit.
+    // Calculate the line segments for each qubit. The qubits are independent,
+    // so this is done concurrently.
     Vec<QubitLines> linesPerQubit(circuitData.amountOfQubits);
-    for (Int qubitIndex = 0; qubitIndex < circuitData.amountOfQubits; qubitIndex++) {
+    parallel_for(itou(circuitData.amountOfQubits), [&](UInt qubitIndexU) {
+        const Int qubitIndex = utoi(qubitIndexU);
+
         // Find the cycles with pulses for each line.
         Line microwaveLine;
         Line fluxLine;
@@ -1235,15 +1442,15 @@ Vec<QubitLines> generateQubitLines(const Vec<GateProperties> &gates,
             if (!gate.codewords.empty()) {
                 const Int codeword = gate.codewords[0];
                 try {
-                    const GatePulses gatePulses = pulseVisualization.mapping.at(codeword).at(qubitIndex);
+                    const GatePulses &gatePulses = pulseVisualization.mapping.at(codeword).at(qubitIndex);
 
-                    if (!gatePulses.microwave.empty())
+                    if (gatePulses.microwave && !gatePulses.microwave->empty())
                         microwaveLine.segments.push_back({PULSE, gateCycles, {gatePulses.microwave, pulseVisualization.sampleRateMicrowave}});
 
-                    if (!gatePulses.flux.empty())
+                    if (gatePulses.flux && !gatePulses.flux->empty())
                         fluxLine.segments.push_back({PULSE, gateCycles, {gatePulses.flux, pulseVisualization.sampleRateFlux}});
 
-                    if (!gatePulses.readout.empty())
+                    if (gatePulses.readout && !gatePulses.readout->empty())
                         readoutLine.segments.push_back({PULSE, gateCycles, {gatePulses.readout, pulseVisualization.sampleRateReadout}});
                 } catch (const Exception &e) {
                     QL_WOUT("Missing codeword and/or qubit in waveform mapping file for gate: " << gate.name << "! Replacing pulse with flat line...\n\t" <<
@@ -1262,6 +1469,14 @@ Vec<QubitLines> generateQubitLines(const Vec<GateProperties> &gates,
         insertFlatLineSegments(fluxLine.segments, circuitData.getAmountOfCycles());
         insertFlatLineSegments(readoutLine.segments, circuitData.getAmountOfCycles());
 
+        // Sort the segments by start cycle, so drawLine() can find the ones
+        // that are in view without going over all of them.
+        for (Line *line : {&microwaveLine, &fluxLine, &readoutLine}) {
+            std::sort(line->segments.begin(), line->segments.end(), [](const LineSegment &lhs, const LineSegment &rhs) {
+                return lhs.range.start < rhs.range.start;
+            });
+        }
+
         // Construct the QubitLines object at the specified qubit index.
         linesPerQubit[qubitIndex] = { microwaveLine, fluxLine, readoutLine };
 
@@ -1307,7 +1522,7 @@ Vec<QubitLines> generateQubitLines(const Vec<GateProperties> &gates,
         //     readoutOutput += " [" + type + " (" + to_string(segment.range.start) + "," + to_string(segment.range.end) + ")]";
         // }
         // QL_DOUT(readoutOutput);
-    }
+    }, com::options::global["num_threads"].as_uint());
 
     return linesPerQubit;
 }
@@ -1316,58 +1531,49 @@ Real calculateMaxAmplitude(const Vec<LineSegment> &lineSegments) {
     Real maxAmplitude = 0;
 
     for (const LineSegment &segment : lineSegments) {
-        const Vec<Real> waveform = segment.pulse.waveform;
-        Real maxAmplitudeInSegment = 0;
-        for (const Real amplitude : waveform) {
-            const Real absAmplitude = abs(amplitude);
-            if (absAmplitude > maxAmplitudeInSegment)
-                maxAmplitudeInSegment = absAmplitude;
+        if (!segment.pulse.waveform) continue;
+        for (const Real amplitude : *segment.pulse.waveform) {
+            maxAmplitude = max(maxAmplitude, abs(amplitude));
         }
-        if (maxAmplitudeInSegment > maxAmplitude)
-            maxAmplitude = maxAmplitudeInSegment;
     }
 
     return maxAmplitude;
 }
 
 void insertFlatLineSegments(Vec<LineSegment> &existingLineSegments, const Int amountOfCycles) {
-    const Int minCycle = 0;
-    const Int maxCycle = amountOfCycles - 1;
-    for (Int i = minCycle; i <= maxCycle; i++) {
-        for (Int j = i; j <= maxCycle; j++) {    
-            if (j == maxCycle) {
-                existingLineSegments.push_back( { FLAT, {i, j}, {{}, 0} } );
-                i = maxCycle + 1;
-                break;
-            }
-
-            Bool foundEndOfEmptyRange = false;
-            for (const LineSegment &segment : existingLineSegments) {
-                if (j == segment.range.start) {
-                    foundEndOfEmptyRange = true;
-                    // If the start of the new search for an empty range is also
-                    // the start of a new non-empty range, skip adding a
-                    // segment.
-                    if (j != i) {
-                        existingLineSegments.push_back( { FLAT, {i, j - 1}, {{}, 0} } );
-                    }
-                    i = segment.range.end;
-                    break;
-                }
-            }
-
-            if (foundEndOfEmptyRange) break;
+    // Sort the ranges of the existing segments by their start cycle, so the
+    // empty ranges can be found in a single pass.
+    Vec<EndPoints> ranges;
+    for (const LineSegment &segment : existingLineSegments) {
+        ranges.push_back(segment.range);
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const EndPoints &lhs, const EndPoints &rhs) {
+        return lhs.start < rhs.start;
+    });
+
+    // Insert a flat segment in front of each range that does not immediately
+    // follow the previous one, and at the end if needed.
+    Int firstEmptyCycle = 0;
+    for (const EndPoints &range : ranges) {
+        if (range.start > firstEmptyCycle) {
+            existingLineSegments.push_back( { FLAT, {firstEmptyCycle, range.start - 1}, {{}, 0} } );
         }
+        firstEmptyCycle = max(firstEmptyCycle, range.end + 1);
+    }
+    if (firstEmptyCycle < amountOfCycles) {
+        existingLineSegments.push_back( { FLAT, {firstEmptyCycle, amountOfCycles - 1}, {{}, 0} } );
     }
 }
 
 void drawCycleLabels(Image &image,
                      const CircuitLayout &layout,
                      const CircuitData &circuitData,
-                     const Structure &structure) {
+                     const Structure &structure,
+                     const Int firstCycle,
+                     const Int lastCycle) {
     QL_DOUT("Drawing cycle labels...");
 
-    for (Int i = 0; i < circuitData.getAmountOfCycles(); i++) {
+    for (Int i = firstCycle; i <= lastCycle; i++) {
         Str cycleLabel = "";
         Int cellWidth = 0;
         if (circuitData.isCycleCut(i)) {
@@ -1400,10 +1606,12 @@ void drawCycleLabels(Image &image,
 void drawCycleEdges(Image &image,
                     const CircuitLayout &layout,
                     const CircuitData &circuitData,
-                    const Structure &structure) {
+                    const Structure &structure,
+                    const Int firstCycle,
+                    const Int lastCycle) {
     QL_DOUT("Drawing cycle edges...");
 
-    for (Int i = 0; i < circuitData.getAmountOfCycles(); i++) {
+    for (Int i = firstCycle; i <= lastCycle; i++) {
         if (i == 0) continue;
         if (circuitData.isCycleCut(i) && circuitData.isCycleCut(i - 1)) continue;
 
@@ -1592,10 +1800,25 @@ void drawLine(Image &image,
               const Int cycleDuration,
               const Line &line,
               const Int qubitIndex,
+              const Int firstCycle,
+              const Int lastCycle,
               const Int y,
               const Int maxLineHeight,
               const Color color) {
-    for (const LineSegment &segment : line.segments) {
+    // Only draw the segments that overlap the given range. The segments are
+    // sorted by start cycle, and firstCycle already accounts for the longest
+    // gate duration, so the only earlier segment that can reach into the
+    // range is a flat one covering firstCycle. Flat segments never overlap
+    // pulses, so that is the segment just before the first one starting in
+    // the range.
+    auto first = std::lower_bound(line.segments.begin(), line.segments.end(), firstCycle, [](const LineSegment &segment, const Int cycle) {
+        return segment.range.start < cycle;
+    });
+    if (first != line.segments.begin()) {
+        --first;
+    }
+    for (auto it = first; it != line.segments.end() && it->range.start <= lastCycle; ++it) {
+        const LineSegment &segment = *it;
         const Int x0 = structure.getCellPosition(segment.range.start, qubitIndex, QUANTUM).x0;
         const Int x1 = structure.getCellPosition(segment.range.end, qubitIndex, QUANTUM).x1;
         const Int yMiddle = y + maxLineHeight / 2;
@@ -1619,36 +1842,67 @@ void drawLine(Image &image,
                 QL_DOUT("\tsegment length in cycles: " << segmentLengthInCycles);
                 QL_DOUT("\tsegment length in nanoseconds: " << segmentLengthInNanoSeconds);
 
-                const Int amountOfSamples = utoi(segment.pulse.waveform.size());
+                const Vec<Real> &waveform = *segment.pulse.waveform;
+                const Int amountOfSamples = utoi(waveform.size());
                 const Int sampleRate = segment.pulse.sampleRate; // MHz
                 const Real samplePeriod = 1000.0f * (1.0f / (Real) sampleRate); // nanoseconds
-                const Int samplePeriodWidth = (Int) floor(samplePeriod / (Real) segmentLengthInNanoSeconds * (Real) segmentWidth); // pixels
-                const Int waveformWidthInPixels = samplePeriodWidth * amountOfSamples;
+                const Real samplePeriodWidth = samplePeriod / (Real) segmentLengthInNanoSeconds * (Real) segmentWidth; // pixels
+                const Real waveformWidthInPixels = samplePeriodWidth * (Real) amountOfSamples;
                 QL_DOUT("\tamount of samples: " << amountOfSamples);
                 QL_DOUT("\tsample period in nanoseconds: " << samplePeriod);
                 QL_DOUT("\tsample period width in segment: " << samplePeriodWidth);
                 QL_DOUT("\ttotal waveform width in pixels: " << waveformWidthInPixels);
 
-                if (waveformWidthInPixels > segmentWidth) {
+                if (waveformWidthInPixels > (Real) segmentWidth) {
                     QL_WOUT("The waveform duration in cycles " << segment.range.start << " to " << segment.range.end << " on qubit " << qubitIndex <<
                          " seems to be larger than the duration of those cycles. Please check the sample rate and amount of samples.");
                 }
 
+                // Skip the samples entirely if the segment is not visible.
+                if (!image.isInView(x0, y, x1, y + maxLineHeight)) {
+                    break;
+                }
+
                 // Calculate sample positions.
                 const Real amplitudeUnitHeight = (Real) maxLineHeight / (maxAmplitude * 2.0f);
-                Vec<Position2> samplePositions;
-                for (UInt i = 0; i < segment.pulse.waveform.size(); i++) {
-                    const Int xSample = x0 + utoi(i) * samplePeriodWidth;
-
-                    const Real amplitude = segment.pulse.waveform[i];
+                auto getSampleY = [&](const Int i) -> Int {
+                    const Real amplitude = waveform[i];
                     const Real adjustedAmplitude = amplitude + maxAmplitude;
-                    const Int ySample = max(y, y + maxLineHeight - 1 - (Int) floor(adjustedAmplitude * amplitudeUnitHeight));
-
-                    samplePositions.push_back( {xSample, ySample} );
+                    return max(y, y + maxLineHeight - 1 - (Int) floor(adjustedAmplitude * amplitudeUnitHeight));
+                };
+                Vec<Position2> samplePositions;
+                if (samplePeriodWidth >= 1.0) {
+                    for (Int i = 0; i < amountOfSamples; i++) {
+                        const Int xSample = x0 + i * (Int) floor(samplePeriodWidth);
+                        samplePositions.push_back( {xSample, getSampleY(i)} );
+                    }
+                } else {
+                    // There are multiple samples per pixel column, so decimate
+                    // them to the first, minimum, maximum, and last sample of
+                    // each column; that is all that would be visible anyway.
+                    Int i = 0;
+                    while (i < amountOfSamples) {
+                        const Int xColumn = x0 + (Int) floor((Real) i * samplePeriodWidth);
+                        const Int firstY = getSampleY(i);
+                        Int minY = firstY;
+                        Int maxY = firstY;
+                        Int lastY = firstY;
+                        for (i++; i < amountOfSamples && x0 + (Int) floor((Real) i * samplePeriodWidth) == xColumn; i++) {
+                            lastY = getSampleY(i);
+                            minY = min(minY, lastY);
+                            maxY = max(maxY, lastY);
+                        }
+                        samplePositions.push_back( {xColumn, firstY} );
+                        if (minY != maxY) {
+                            samplePositions.push_back( {xColumn, minY} );
+                            samplePositions.push_back( {xColumn, maxY} );
+                        }
+                        samplePositions.push_back( {xColumn, lastY} );
+                    }
                 }
 
                 // Draw the lines connecting the samples.
-                for (UInt i = 0; i < samplePositions.size() - 1; i++) {
+                for (UInt i = 0; i + 1 < samplePositions.size(); i++) {
                     const Position2 currentSample = samplePositions[i];
                     const Position2 nextSample = samplePositions[i + 1];
 
@@ -12,6 +12,7 @@
 #include "ql/utils/vec.h"
 #include "ql/utils/map.h"
 #include "ql/utils/json.h"
+#include "ql/utils/ptr.h"
 #include "types.h"
 #include "image.h"
 
@@ -39,8 +40,12 @@ struct Cell {
 
 enum LineSegmentType {FLAT, PULSE, CUT};
 
+// Waveforms are shared between the (cached) waveform mapping and the line
+// segments that use them, rather than copied for each gate.
+using Waveform = utils::Ptr<const utils::Vec<utils::Real>>;
+
 struct Pulse {
-    const utils::Vec<utils::Real> waveform;
+    const Waveform waveform;
     const utils::Int sampleRate;
 };
 
@@ -62,9 +67,9 @@ struct QubitLines {
 };
 
 struct GatePulses {
-    utils::Vec<utils::Real> microwave;
-    utils::Vec<utils::Real> flux;
-    utils::Vec<utils::Real> readout;
+    Waveform microwave;
+    Waveform flux;
+    Waveform readout;
 
     GatePulses() = delete;
 };
@@ -167,8 +172,8 @@ utils::Vec<QubitLines> generateQubitLines(const utils::Vec<GateProperties> &gate
 utils::Real calculateMaxAmplitude(const utils::Vec<LineSegment> &lineSegments);
 void insertFlatLineSegments(utils::Vec<LineSegment> &existingLineSegments, utils::Int amountOfCycles);
 
-void drawCycleLabels(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure);
-void drawCycleEdges(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure);
+void drawCycleLabels(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure, utils::Int firstCycle, utils::Int lastCycle);
+void drawCycleEdges(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure, utils::Int firstCycle, utils::Int lastCycle);
 void drawBitLineLabels(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure);
 void drawBitLineEdges(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure);
 
@@ -177,7 +182,7 @@ void drawGroupedClassicalBitLine(Image &image, const CircuitLayout &layout, cons
 
 void drawWiggle(Image &image, utils::Int x0, utils::Int x1, utils::Int y, utils::Int width, utils::Int height, Color color);
 
-void drawLine(Image &image, const Structure &structure, utils::Int cycleDuration, const Line &line, utils::Int qubitIndex, utils::Int y, utils::Int maxLineHeight, Color color);
+void drawLine(Image &image, const Structure &structure, utils::Int cycleDuration, const Line &line, utils::Int qubitIndex, utils::Int firstCycle, utils::Int lastCycle, utils::Int y, utils::Int maxLineHeight, Color color);
 
 void drawCycle(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const Structure &structure, const Cycle &cycle);
 void drawGate(Image &image, const CircuitLayout &layout, const CircuitData &circuitData, const GateProperties &gate, const Structure &structure, utils::Int chunkOffset);
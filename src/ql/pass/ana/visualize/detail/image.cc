@@ -1,5 +1,5 @@
 /** \file
- * Wrapper for the CImg library.
+ * Wrapper for the CImg library, with an alternative SVG backend.
  */
 
 #ifdef WITH_VISUALIZER
@@ -9,6 +9,8 @@
 #include "CImg.h"
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
+#include "ql/utils/logger.h"
+#include "ql/utils/filesystem.h"
 #include "types.h"
 
 namespace ql {
@@ -19,58 +21,205 @@ namespace detail {
 
 using namespace utils;
 
-Image::Image(const Int imageWidth, const Int imageHeight) : cimg((int) imageWidth, (int) imageHeight, 1, 3) {
-    // empty
+Str getImageExtension(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::SVG: return "svg";
+        default: return "bmp";
+    }
+}
+
+/**
+ * Returns the given text with the characters that are special in XML escaped.
+ */
+static Str escapeXml(const Str &text) {
+    Str result;
+    for (const char c : text) {
+        switch (c) {
+            case '&': result += "&amp;"; break;
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '"': result += "&quot;"; break;
+            default: result += c; break;
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the given color as an SVG color specification.
+ */
+static Str toSvgColor(const Color color) {
+    return "rgb(" + to_string((Int) color[0]) + "," + to_string((Int) color[1]) + "," + to_string((Int) color[2]) + ")";
+}
+
+Image::Image(const Int imageWidth, const Int imageHeight, const ImageFormat format) :
+    format(format),
+    width(imageWidth),
+    height(imageHeight)
+{
+    if (format == ImageFormat::SVG) {
+        svg.emplace();
+    } else {
+        cimg.emplace((int) imageWidth, (int) imageHeight, 1, 3);
+    }
+}
+
+Int Image::getWidth() const {
+    return width;
+}
+
+Int Image::getHeight() const {
+    return height;
+}
+
+ImageFormat Image::getFormat() const {
+    return format;
+}
+
+void Image::setOrigin(const Int x, const Int y) {
+    originX = x;
+    originY = y;
+}
+
+Bool Image::isInView(const Int x0, const Int y0, const Int x1, const Int y1) const {
+    return min(x0, x1) - originX < width && max(x0, x1) - originX >= 0
+        && min(y0, y1) - originY < height && max(y0, y1) - originY >= 0;
+}
+
+void Image::appendSvgStyle(const Color color, const Real alpha, const Bool filled, const LinePattern pattern) {
+    const Str rgb = toSvgColor(color);
+    if (filled) {
+        *svg << " fill=\"" << rgb << "\"";
+        if (alpha < 1) *svg << " fill-opacity=\"" << alpha << "\"";
+    } else {
+        *svg << " fill=\"none\" stroke=\"" << rgb << "\"";
+        if (alpha < 1) *svg << " stroke-opacity=\"" << alpha << "\"";
+        if (pattern == LinePattern::DASHED) *svg << " stroke-dasharray=\"4 4\"";
+    }
+    *svg << "/>\n";
 }
 
 void Image::fill(const Color color) {
+    if (format == ImageFormat::SVG) {
+        *svg << "<rect x=\"0\" y=\"0\" width=\"" << width << "\" height=\"" << height << "\"";
+        appendSvgStyle(color, 1, true, LinePattern::UNBROKEN);
+        return;
+    }
     cimg->fill(255);
-    drawFilledRectangle(0, 0, cimg->width(), cimg->height(), color, 1.0f);
+    cimg->draw_rectangle(0, 0, cimg->width(), cimg->height(), color.data(), 1.0f);
 }
 
 void Image::drawLine(const Int x0, const Int y0, const Int x1, const Int y1, const Color color, const Real alpha, const LinePattern pattern) {
-    cimg->draw_line((int) x0, (int) y0, (int) x1, (int) y1, color.data(), (float) alpha, static_cast<unsigned int>(pattern));
+    if (!isInView(x0, y0, x1, y1)) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<line x1=\"" << x0 - originX << "\" y1=\"" << y0 - originY
+             << "\" x2=\"" << x1 - originX << "\" y2=\"" << y1 - originY << "\"";
+        appendSvgStyle(color, alpha, false, pattern);
+        return;
+    }
+    cimg->draw_line((int) (x0 - originX), (int) (y0 - originY), (int) (x1 - originX), (int) (y1 - originY), color.data(), (float) alpha, static_cast<unsigned int>(pattern));
 }
 
-void Image::drawText(const Int x, const Int y, const Str &text, const Int height, const Color color) {
-    cimg->draw_text((int) x, (int) y, text.c_str(), color.data(), 0, 1, (int) height);
+void Image::drawText(const Int x, const Int y, const Str &text, const Int fontHeight, const Color color) {
+    // The width of the text is not known without rendering it, but it is
+    // never more than the font height per character.
+    if (!isInView(x, y, x + utoi(text.size()) * fontHeight, y + fontHeight)) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<text x=\"" << x - originX << "\" y=\"" << y - originY
+             << "\" font-family=\"monospace\" font-size=\"" << fontHeight
+             << "\" dominant-baseline=\"hanging\" fill=\"" << toSvgColor(color) << "\">"
+             << escapeXml(text) << "</text>\n";
+        return;
+    }
+    cimg->draw_text((int) (x - originX), (int) (y - originY), text.c_str(), color.data(), 0, 1, (int) fontHeight);
 }
 
 void Image::drawFilledCircle(const Int centerX, const Int centerY, const Int radius,
                              const Color color, const Real alpha) {
-    cimg->draw_circle((int) centerX, (int) centerY, (int) radius, color.data(), (float) alpha);
+    if (!isInView(centerX - radius, centerY - radius, centerX + radius, centerY + radius)) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<circle cx=\"" << centerX - originX << "\" cy=\"" << centerY - originY << "\" r=\"" << radius << "\"";
+        appendSvgStyle(color, alpha, true, LinePattern::UNBROKEN);
+        return;
+    }
+    cimg->draw_circle((int) (centerX - originX), (int) (centerY - originY), (int) radius, color.data(), (float) alpha);
 }
 
 void Image::drawOutlinedCircle(const Int centerX, const Int centerY, const Int radius,
                                const Color color, const Real alpha, const LinePattern pattern) {
-    cimg->draw_circle((int) centerX, (int) centerY, (int) radius, color.data(), (float) alpha, static_cast<unsigned int>(pattern));
+    if (!isInView(centerX - radius, centerY - radius, centerX + radius, centerY + radius)) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<circle cx=\"" << centerX - originX << "\" cy=\"" << centerY - originY << "\" r=\"" << radius << "\"";
+        appendSvgStyle(color, alpha, false, pattern);
+        return;
+    }
+    cimg->draw_circle((int) (centerX - originX), (int) (centerY - originY), (int) radius, color.data(), (float) alpha, static_cast<unsigned int>(pattern));
 }
 
 void Image::drawFilledTriangle(const Int x0, const Int y0, const Int x1, const Int y1, const Int x2, const Int y2,
                                const Color color, const Real alpha) {
-    cimg->draw_triangle((int) x0, (int) y0, (int) x1, (int) y1, (int) x2, (int) y2, color.data(), (float) alpha);
+    if (!isInView(min(x0, min(x1, x2)), min(y0, min(y1, y2)), max(x0, max(x1, x2)), max(y0, max(y1, y2)))) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<polygon points=\"" << x0 - originX << "," << y0 - originY << " "
+             << x1 - originX << "," << y1 - originY << " " << x2 - originX << "," << y2 - originY << "\"";
+        appendSvgStyle(color, alpha, true, LinePattern::UNBROKEN);
+        return;
+    }
+    cimg->draw_triangle((int) (x0 - originX), (int) (y0 - originY), (int) (x1 - originX), (int) (y1 - originY), (int) (x2 - originX), (int) (y2 - originY), color.data(), (float) alpha);
 }
 
 void Image::drawOutlinedTriangle(const Int x0, const Int y0, const Int x1, const Int y1, const Int x2, const Int y2,
                                  const Color color, const Real alpha, const LinePattern pattern) {
-    cimg->draw_triangle((int) x0, (int) y0, (int) x1, (int) y1, (int) x2, (int) y2, color.data(), (float) alpha, static_cast<unsigned int>(pattern));
+    if (!isInView(min(x0, min(x1, x2)), min(y0, min(y1, y2)), max(x0, max(x1, x2)), max(y0, max(y1, y2)))) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<polygon points=\"" << x0 - originX << "," << y0 - originY << " "
+             << x1 - originX << "," << y1 - originY << " " << x2 - originX << "," << y2 - originY << "\"";
+        appendSvgStyle(color, alpha, false, pattern);
+        return;
+    }
+    cimg->draw_triangle((int) (x0 - originX), (int) (y0 - originY), (int) (x1 - originX), (int) (y1 - originY), (int) (x2 - originX), (int) (y2 - originY), color.data(), (float) alpha, static_cast<unsigned int>(pattern));
 }
 
 void Image::drawFilledRectangle(const Int x0, const Int y0, const Int x1, const Int y1,
                                 const Color color, const Real alpha) {
-    cimg->draw_rectangle((int) x0, (int) y0, (int) x1, (int) y1, color.data(), (float) alpha);
+    if (!isInView(x0, y0, x1, y1)) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<rect x=\"" << min(x0, x1) - originX << "\" y=\"" << min(y0, y1) - originY
+             << "\" width=\"" << abs(x1 - x0) << "\" height=\"" << abs(y1 - y0) << "\"";
+        appendSvgStyle(color, alpha, true, LinePattern::UNBROKEN);
+        return;
+    }
+    cimg->draw_rectangle((int) (x0 - originX), (int) (y0 - originY), (int) (x1 - originX), (int) (y1 - originY), color.data(), (float) alpha);
 }
 
 void Image::drawOutlinedRectangle(const Int x0, const Int y0, const Int x1, const Int y1,
                                   const Color color, const Real alpha, const LinePattern pattern) {
-    cimg->draw_rectangle((int) x0, (int) y0, (int) x1, (int) y1, color.data(), (float) alpha, static_cast<unsigned int>(pattern));
+    if (!isInView(x0, y0, x1, y1)) return;
+    if (format == ImageFormat::SVG) {
+        *svg << "<rect x=\"" << min(x0, x1) - originX << "\" y=\"" << min(y0, y1) - originY
+             << "\" width=\"" << abs(x1 - x0) << "\" height=\"" << abs(y1 - y0) << "\"";
+        appendSvgStyle(color, alpha, false, pattern);
+        return;
+    }
+    cimg->draw_rectangle((int) (x0 - originX), (int) (y0 - originY), (int) (x1 - originX), (int) (y1 - originY), color.data(), (float) alpha, static_cast<unsigned int>(pattern));
 }
 
 void Image::save(const Str &filename) {
+    if (format == ImageFormat::SVG) {
+        OutFile file(filename);
+        file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height
+             << "\" viewBox=\"0 0 " << width << " " << height << "\">\n";
+        file << svg->str();
+        file << "</svg>\n";
+        return;
+    }
     cimg->save(static_cast<std::string>(filename).c_str());
 }
 
 void Image::display(const Str &caption) {
+    if (format == ImageFormat::SVG) {
+        QL_FATAL("SVG images cannot be displayed interactively!");
+    }
     cimg->display(static_cast<std::string>(caption).c_str());
 }
 
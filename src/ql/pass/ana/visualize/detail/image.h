@@ -1,5 +1,5 @@
 /** \file
- * Wrapper for the CImg library.
+ * Wrapper for the CImg library, with an alternative SVG backend.
  */
 
 #pragma once
@@ -37,12 +37,37 @@ enum class LinePattern : unsigned int {
     DASHED = 0xF0F0F0F0
 };
 
+/**
+ * Returns the file extension (without period) for the given image format.
+ */
+utils::Str getImageExtension(ImageFormat format);
+
 class Image {
 private:
+    ImageFormat format;
+    utils::Int width;
+    utils::Int height;
+
+    // Coordinates passed to the drawing functions are relative to this origin.
+    // This allows a large drawing to be rendered as a series of smaller
+    // images (tiles), by moving the origin over it.
+    utils::Int originX = 0;
+    utils::Int originY = 0;
+
     utils::Ptr<cimg_library::CImg<unsigned char>> cimg;
+    utils::Ptr<utils::StrStrm> svg;
+
+    void appendSvgStyle(const Color color, const utils::Real alpha, const utils::Bool filled, const LinePattern pattern);
 
 public:
-    Image(const utils::Int imageWidth, const utils::Int imageHeight);
+    Image(const utils::Int imageWidth, const utils::Int imageHeight, const ImageFormat format = ImageFormat::BMP);
+
+    utils::Int getWidth() const;
+    utils::Int getHeight() const;
+    ImageFormat getFormat() const;
+
+    void setOrigin(const utils::Int x, const utils::Int y);
+    utils::Bool isInView(const utils::Int x0, const utils::Int y0, const utils::Int x1, const utils::Int y1) const;
 
     void fill(const Color color);
 
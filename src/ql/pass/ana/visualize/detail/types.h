@@ -21,6 +21,17 @@ namespace detail {
 void assertPositive(utils::Int parameterValue, const utils::Str &parameterName);
 void assertPositive(utils::Real parameterValue, const utils::Str &parameterName);
 
+/**
+ * The output format of an image. BMP images are rendered to a raster using
+ * CImg, SVG images are accumulated as vector elements and only written out
+ * when saved, so their memory footprint scales with the number of visible
+ * elements rather than with the image area.
+ */
+enum class ImageFormat {
+    BMP,
+    SVG
+};
+
 struct VisualizerConfiguration {
     utils::Str visualizationType;
     utils::Str visualizerConfigPath;
@@ -28,6 +39,15 @@ struct VisualizerConfiguration {
     utils::Bool interactive;
     utils::Str output_prefix;
     utils::Str pass_name;
+
+    // Output format of the generated image(s). Only used by the circuit
+    // visualizer.
+    ImageFormat imageFormat;
+
+    // When nonzero, the circuit is rendered as a series of images (tiles) of
+    // at most this many cycles each, rather than as a single image. Only used
+    // by the circuit visualizer.
+    utils::UInt tileCycles;
 };
 
 typedef std::array<utils::Byte, 3> Color;
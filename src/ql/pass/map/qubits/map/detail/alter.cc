@@ -185,6 +185,48 @@ void Alter::extend(const Past &curr_past, const Past &base_past) {
     score_valid = true;
 }
 
+/**
+ * Computes the score of this alternative for the LOOKAHEAD heuristic: the sum
+ * of the distances between the real operand qubits of the given upcoming
+ * two-qubit gates after the swaps of this alternative would be added to
+ * curr_past, with the i-th gate weighted by lookahead_decay to the power i.
+ * Operands that aren't mapped yet are ignored. Neither curr_past nor this
+ * alternative is modified.
+ */
+utils::Real Alter::get_lookahead_score(
+    const Past &curr_past,
+    const utils::List<ir::compat::GateRef> &gates
+) const {
+
+    // Returns the location that the state at real qubit r moves to when the
+    // swaps of this alternative are applied, in the same order as add_swaps()
+    // does. The paths are short, so this is cheaper than copying the mapping.
+    auto apply_swaps = [this](utils::UInt r) {
+        for (const auto *path : {&from_source, &from_target}) {
+            for (utils::UInt i = 1; i < path->size(); i++) {
+                if (r == (*path)[i - 1]) {
+                    r = (*path)[i];
+                } else if (r == (*path)[i]) {
+                    r = (*path)[i - 1];
+                }
+            }
+        }
+        return r;
+    };
+
+    utils::Real result = 0.0;
+    utils::Real weight = 1.0;
+    for (const auto &gate : gates) {
+        auto r0 = curr_past.get_real(gate->operands[0]);
+        auto r1 = curr_past.get_real(gate->operands[1]);
+        if (r0 != com::map::UNDEFINED_QUBIT && r1 != com::map::UNDEFINED_QUBIT) {
+            result += weight * platform->topology->get_distance(apply_swaps(r0), apply_swaps(r1));
+        }
+        weight *= options->lookahead_decay;
+    }
+    return result;
+}
+
 /**
  * Split the path. Starting from the representation in the total attribute,
  * generate all split path variations where each path is split once at any
@@ -188,6 +188,19 @@ public:
      */
     void extend(const Past &curr_past, const Past &base_past);
 
+    /**
+     * Computes the score of this alternative for the LOOKAHEAD heuristic: the
+     * sum of the distances between the real operand qubits of the given
+     * upcoming two-qubit gates after the swaps of this alternative would be
+     * added to curr_past, with the i-th gate weighted by lookahead_decay to
+     * the power i. Operands that aren't mapped yet are ignored. Neither
+     * curr_past nor this alternative is modified.
+     */
+    utils::Real get_lookahead_score(
+        const Past &curr_past,
+        const utils::List<ir::compat::GateRef> &gates
+    ) const;
+
     /**
      * Split the path. Starting from the representation in the total attribute,
      * generate all split path variations where each path is split once at any
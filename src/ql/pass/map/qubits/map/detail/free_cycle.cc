@@ -26,6 +26,7 @@ void FreeCycle::initialize(const ir::compat::PlatformRef &p, const OptionsRef &o
     ct = platform->cycle_time;
     QL_DOUT("... FreeCycle: nq=" << nq << ", nb=" << nb << ", ct=" << ct << "), initializing to all 0 cycles");
     fcv.clear();
+    fcv_checkpoints.clear();
     fcv.resize(nq+nb, 1);   // this 1 implies that cycle of first gate will be 1 and not 0; OpenQL convention!?!?
     QL_DOUT("... about to copy FreeCycle initialize local resource_manager to FreeCycle member rm");
     rs = rm.build(rmgr::Direction::FORWARD);
@@ -69,6 +70,13 @@ utils::UInt FreeCycle::get_max() const {
     return max_free_cycle;
 }
 
+/**
+ * Returns the cycle from which the given real qubit is free.
+ */
+utils::UInt FreeCycle::get_free_cycle(utils::UInt qubit) const {
+    return fcv[qubit];
+}
+
 /**
  * Prints the state of this object along with the given string.
  */
@@ -220,6 +228,27 @@ void FreeCycle::add(const ir::compat::GateRef &g, utils::UInt start_cycle) {
     }
 }
 
+/**
+ * Starts a checkpoint, such that the gates added from now on can be undone
+ * with rollback(). This is cheaper than copying the FreeCycle object, because
+ * the resource state only logs the changes made since the checkpoint.
+ */
+void FreeCycle::checkpoint() {
+    fcv_checkpoints.push_back(fcv);
+    rs->checkpoint();
+}
+
+/**
+ * Undoes all gates added since the most recent checkpoint, and removes that
+ * checkpoint.
+ */
+void FreeCycle::rollback() {
+    QL_ASSERT(!fcv_checkpoints.empty());
+    fcv = std::move(fcv_checkpoints.back());
+    fcv_checkpoints.pop_back();
+    rs->rollback();
+}
+
 } // namespace detail
 } // namespace map
 } // namespace qubits
@@ -82,6 +82,11 @@ private:
      */
     utils::Opt<rmgr::State> rs;
 
+    /**
+     * The free cycle vector at each active checkpoint, from oldest to newest.
+     */
+    utils::Vec<utils::Vec<utils::UInt>> fcv_checkpoints;
+
 public:
 
     /**
@@ -108,6 +113,11 @@ public:
      */
     utils::UInt get_max() const;
 
+    /**
+     * Returns the cycle from which the given real qubit is free.
+     */
+    utils::UInt get_free_cycle(utils::UInt qubit) const;
+
     /**
      * Prints the state of this object along with the given string.
      */
@@ -166,6 +176,20 @@ public:
      */
     void add(const ir::compat::GateRef &g, utils::UInt start_cycle);
 
+    /**
+     * Starts a checkpoint, such that the gates added from now on can be
+     * undone with rollback(). This is cheaper than copying the FreeCycle
+     * object, because the resource state only logs the changes made since the
+     * checkpoint.
+     */
+    void checkpoint();
+
+    /**
+     * Undoes all gates added since the most recent checkpoint, and removes
+     * that checkpoint.
+     */
+    void rollback();
+
 };
 
 } // namespace detail
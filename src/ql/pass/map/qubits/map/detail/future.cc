@@ -31,6 +31,23 @@ void Future::set_kernel(const ir::compat::KernelRef &kernel, const utils::Ptr<Sc
     approx_gates_total = kernel->gates.size();
     approx_gates_remaining = approx_gates_total;
     scheduler = sched;
+    lookahead_gates.clear();
+    lookahead_index.clear();
+    lookahead_done.clear();
+    lookahead_cursor = 0;
+    if (options->heuristic == Heuristic::LOOKAHEAD) {
+        for (const auto &gate : kernel->gates) {
+            if (
+                gate->operands.size() == 2
+                && gate->type() != ir::compat::GateType::CLASSICAL
+                && gate->type() != ir::compat::GateType::WAIT
+            ) {
+                lookahead_index.set(gate) = lookahead_gates.size();
+                lookahead_gates.push_back(gate);
+            }
+        }
+        lookahead_done.resize(lookahead_gates.size(), false);
+    }
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
         input_gatepv = kernel->gates;                           // copy to free original circuit to allow outputing to
         input_gatepp = input_gatepv.begin();                    // iterator set to start of input circuit copy
@@ -99,9 +116,11 @@ utils::Bool Future::get_non_quantum_gates(utils::List<ir::compat::GateRef> &nonq
 }
 
 /**
- * Get all gates from avlist into qlg. Return whether some gate was found.
+ * Get all gates from avlist into qlg. Return whether some gate was found. When
+ * criticality is enabled, the gates are ordered by decreasing criticality given
+ * the current state of the past, using the order of the avlist to break ties.
  */
-utils::Bool Future::get_gates(utils::List<ir::compat::GateRef> &qlg) const {
+utils::Bool Future::get_gates(utils::List<ir::compat::GateRef> &qlg, const Past &past) const {
     qlg.clear();
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
         if (input_gatepp != input_gatepv.end()) {
@@ -119,6 +138,19 @@ utils::Bool Future::get_gates(utils::List<ir::compat::GateRef> &qlg) const {
             }
             qlg.push_back(gp);
         }
+
+        // The avlist is ordered by the static criticality computed when the
+        // kernel was set, which doesn't account for the swaps added since.
+        // List::sort() is stable, so ties keep the avlist order.
+        if (options->enable_criticality && qlg.size() > 1) {
+            utils::Map<ir::compat::GateRef, utils::UInt> criticality;
+            for (const auto &gate : qlg) {
+                criticality.set(gate) = get_criticality(gate, past);
+            }
+            qlg.sort([&criticality](const ir::compat::GateRef &a, const ir::compat::GateRef &b) {
+                return criticality.at(a) > criticality.at(b);
+            });
+        }
     }
     return !qlg.empty();
 }
@@ -131,6 +163,15 @@ void Future::completed_gate(const ir::compat::GateRef &gate) {
     if (approx_gates_remaining) {
         approx_gates_remaining--;
     }
+    if (!lookahead_gates.empty()) {
+        auto it = lookahead_index.find(gate);
+        if (it != lookahead_index.end()) {
+            lookahead_done[it->second] = true;
+            while (lookahead_cursor < lookahead_done.size() && lookahead_done[lookahead_cursor]) {
+                lookahead_cursor++;
+            }
+        }
+    }
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
         input_gatepp = std::next(input_gatepp);
     } else {
@@ -139,16 +180,62 @@ void Future::completed_gate(const ir::compat::GateRef &gate) {
 }
 
 /**
- * Return the most critical gate in lag (provided lookahead is enabled).
- * This is used in tiebreak, when every other option has failed to make a
- * distinction.
+ * Returns the first window two-qubit gates that haven't been mapped yet in
+ * circuit order, skipping the given gate (usually the gate that is being
+ * routed). Only available for the LOOKAHEAD heuristic.
  */
-ir::compat::GateRef Future::get_most_critical(const utils::List<ir::compat::GateRef> &lag) const {
+void Future::get_lookahead_gates(
+    utils::UInt window,
+    const ir::compat::GateRef &skip,
+    utils::List<ir::compat::GateRef> &gates
+) const {
+    gates.clear();
+    for (
+        utils::UInt i = lookahead_cursor;
+        i < lookahead_gates.size() && gates.size() < window;
+        i++
+    ) {
+        if (!lookahead_done[i] && lookahead_gates[i].get_ptr() != skip.get_ptr()) {
+            gates.push_back(lookahead_gates[i]);
+        }
+    }
+}
+
+/**
+ * Returns the criticality of the given available gate given the current state
+ * of the past, i.e. the projected length of the circuit in cycles when the gate
+ * is scheduled next. Requires lookahead to be enabled.
+ */
+utils::UInt Future::get_criticality(const ir::compat::GateRef &gate, const Past &past) const {
+    utils::UInt start = 0;
+    for (auto q : gate->operands) {
+        start = utils::max(start, past.get_free_cycle(q));
+    }
+    return start + scheduler->remaining.at(scheduler->node.at(gate));
+}
+
+/**
+ * Return the most critical gate in lag (provided lookahead is enabled), given
+ * the current state of the past. This is used in tiebreak, when every other
+ * option has failed to make a distinction.
+ */
+ir::compat::GateRef Future::get_most_critical(
+    const utils::List<ir::compat::GateRef> &lag,
+    const Past &past
+) const {
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
         return lag.front();
-    } else {
-        return scheduler->find_mostcritical(lag);
     }
+    ir::compat::GateRef most_critical = lag.front();
+    utils::UInt max_criticality = get_criticality(most_critical, past);
+    for (const auto &gate : lag) {
+        auto criticality = get_criticality(gate, past);
+        if (criticality > max_criticality) {
+            most_critical = gate;
+            max_criticality = criticality;
+        }
+    }
+    return most_critical;
 }
 
 } // namespace detail
@@ -59,6 +59,16 @@ using Scheduler = pass::sch::schedule::detail::Scheduler;
  * increasing circuit depth than taking a non-critical gate as first one to map.
  * Later implementations may become more sophisticated.
  *
+ * The criticality of an available gate is the projected length of the circuit
+ * when that gate is scheduled next: the cycle from which its operand qubits are
+ * free in the past, plus the length of the critical path from the gate to the
+ * end of the circuit (the scheduler's remaining value). The latter only depends
+ * on the gates that still have to be mapped, so it is computed once per kernel;
+ * the former reflects the gates and swaps already added to the past, and is
+ * maintained incrementally by the past's free cycle map as gates are
+ * scheduled. Thus, criticality stays accurate as swaps are inserted, without
+ * recomputing anything for the whole dependency graph.
+ *
  * With the lookahead_mode option disabled, the future window's dependency
  * graphs (scheduled and avlist) are not used. Instead, a copy of the input
  * circuit (input_gatepv) is created and iterated over (input_gatepp).
@@ -111,6 +121,29 @@ public:
      */
     utils::UInt approx_gates_remaining;
 
+    /**
+     * The two-qubit gates of the circuit in circuit order, used by the
+     * LOOKAHEAD heuristic. Only maintained for that heuristic.
+     */
+    utils::Vec<ir::compat::GateRef> lookahead_gates;
+
+    /**
+     * Index of each gate in lookahead_gates.
+     */
+    utils::Map<ir::compat::GateRef, utils::UInt> lookahead_index;
+
+    /**
+     * Whether each gate in lookahead_gates has been mapped.
+     */
+    utils::Vec<utils::Bool> lookahead_done;
+
+    /**
+     * Index of the first gate in lookahead_gates that hasn't been mapped yet.
+     * Gates are mapped roughly in circuit order, so advancing this past the
+     * mapped gates keeps finding the lookahead window cheap.
+     */
+    utils::UInt lookahead_cursor = 0;
+
     /**
      * Program-wide initialization function.
      */
@@ -130,8 +163,11 @@ public:
 
     /**
      * Get all gates from avlist into qlg. Return whether some gate was found.
+     * When criticality is enabled, the gates are ordered by decreasing
+     * criticality given the current state of the past, using the order of the
+     * avlist to break ties.
      */
-    utils::Bool get_gates(utils::List<ir::compat::GateRef> &qlg) const;
+    utils::Bool get_gates(utils::List<ir::compat::GateRef> &qlg, const Past &past) const;
 
     /**
      * Indicates that a gate currently in avlist has been mapped, can be
@@ -140,11 +176,32 @@ public:
     void completed_gate(const ir::compat::GateRef &gate);
 
     /**
-     * Return the most critical gate in lag (provided lookahead is enabled).
-     * This is used in tiebreak, when every other option has failed to make a
-     * distinction.
+     * Returns the first window two-qubit gates that haven't been mapped yet in
+     * circuit order, skipping the given gate (usually the gate that is being
+     * routed). Only available for the LOOKAHEAD heuristic.
+     */
+    void get_lookahead_gates(
+        utils::UInt window,
+        const ir::compat::GateRef &skip,
+        utils::List<ir::compat::GateRef> &gates
+    ) const;
+
+    /**
+     * Returns the criticality of the given available gate given the current
+     * state of the past, i.e. the projected length of the circuit in cycles
+     * when the gate is scheduled next. Requires lookahead to be enabled.
+     */
+    utils::UInt get_criticality(const ir::compat::GateRef &gate, const Past &past) const;
+
+    /**
+     * Return the most critical gate in lag (provided lookahead is enabled),
+     * given the current state of the past. This is used in tiebreak, when
+     * every other option has failed to make a distinction.
      */
-    ir::compat::GateRef get_most_critical(const utils::List<ir::compat::GateRef> &lag) const;
+    ir::compat::GateRef get_most_critical(
+        const utils::List<ir::compat::GateRef> &lag,
+        const Past &past
+    ) const;
 
 };
 
@@ -6,8 +6,11 @@
 
 #include <chrono>
 #include "ql/utils/filesystem.h"
+#include "ql/utils/parallel.h"
+#include "ql/com/options.h"
 #include "ql/pass/ana/statistics/annotations.h"
 #include "ql/pass/map/qubits/place_mip/detail/algorithm.h"
+#include "ql/pass/map/qubits/place_graph/detail/algorithm.h"
 
 namespace ql {
 namespace pass {
@@ -272,6 +275,7 @@ void Mapper::gen_alters(
     List<Alter> &alters,
     Past &past
 ) {
+    ScopedTimer timer(statistics.path_generation_time);
     if (options->lookahead_mode == LookaheadMode::ALL) {
 
         // Create alternatives for each gate.
@@ -297,25 +301,31 @@ void Mapper::gen_alters(
         gen_alters_gate(gate, alters, past);
 
     }
+    statistics.record_alternatives(alters.size());
 }
 
 /**
- * Seeds the random number generator with the current time in microseconds.
+ * Seeds the random number generator with the given seed, or with the current
+ * time in microseconds if the given seed is 0.
  */
-void Mapper::random_init() {
-    auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
-    // QL_DOUT("Seeding random generator with " << ts );
-    rng.seed(ts);
+void Mapper::random_init(UInt new_seed) {
+    if (!new_seed) {
+        new_seed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+    // QL_DOUT("Seeding random generator with " << new_seed );
+    seed = new_seed;
+    rng.seed(seed);
 }
 
 /**
  * Chooses an Alter from the list based on the configured tie-breaking
  * strategy.
  */
-Alter Mapper::tie_break_alter(List<Alter> &alters, Future &future) {
+Alter Mapper::tie_break_alter(List<Alter> &alters, Future &future, const Past &past) {
     QL_ASSERT(!alters.empty());
+    ScopedTimer timer(statistics.tie_breaking_time);
 
     if (alters.size() == 1) {
         return alters.front();
@@ -327,7 +337,7 @@ Alter Mapper::tie_break_alter(List<Alter> &alters, Future &future) {
             for (auto &a : alters) {
                 lag.push_back(a.target_gate);
             }
-            ir::compat::GateRef gate = future.get_most_critical(lag);
+            ir::compat::GateRef gate = future.get_most_critical(lag, past);
             QL_ASSERT(!gate.empty());
             for (auto &a : alters) {
                 if (a.target_gate.get_ptr() == gate.get_ptr()) {
@@ -393,6 +403,7 @@ void Mapper::map_routed_gate(const ir::compat::GateRef &gate, Past &past) {
  * to past, but future is not updated.
  */
 void Mapper::commit_alter(Alter &alter, Future &future, Past &past) {
+    ScopedTimer timer(statistics.commit_time);
 
     // The target two-qubit-gate, now not yet nearest-neighbor.
     ir::compat::GateRef target = alter.target_gate;
@@ -492,7 +503,7 @@ Bool Mapper::map_mappable_gates(
         }
 
         // Get available gates.
-        if (!future.get_gates(av_gates)) {
+        if (!future.get_gates(av_gates, past)) {
 
             // No more gates available for scheduling.
             QL_DOUT("map_mappable_gates, no gates anymore, return");
@@ -591,6 +602,9 @@ Bool Mapper::map_mappable_gates(
  *    of the given past (or some factor of that amount, ordered by
  *    increasing cycle extension) and recurse. When the recursion depth
  *    limit is reached, apply the tie-breaking strategy.
+ *  - If LOOKAHEAD, score the Alters by the distances between the operands
+ *    of the next two-qubit gates after their swaps, and apply the
+ *    tie-breaking strategy to the best-scoring ones without recursing.
  *
  * For recursion, past is the speculative past, and base_past is the past
  * we've already committed to, and should thus measure fitness against.
@@ -607,18 +621,45 @@ void Mapper::select_alter(
     QL_ASSERT(!alters.empty());
 
     QL_DOUT("select_alter ENTRY level=" << recursion_depth << " from " << alters.size() << " alternatives");
+    statistics.record_recursion_node(recursion_depth);
 
     // Handle the basic strategy, where we just tie-break on all alters without
     // recusing.
     if (options->heuristic == Heuristic::BASE || options->heuristic == Heuristic::BASE_RC) {
         Alter::debug_print(
             "... select_alter base (equally good/best) alternatives:", alters);
-        result = tie_break_alter(alters, future);
+        result = tie_break_alter(alters, future, past);
         result.debug_print("... the selected Alter is");
         // QL_DOUT("SelectAlter DONE level=" << level << " from " << la.size() << " alternatives");
         return;
     }
 
+    // Handle the windowed lookahead strategy, where alternatives are scored
+    // by how close they bring the operands of the next two-qubit gates
+    // together, computed directly from the distance table.
+    if (options->heuristic == Heuristic::LOOKAHEAD) {
+        {
+            ScopedTimer timer(statistics.scoring_time);
+            List<ir::compat::GateRef> window;
+            future.get_lookahead_gates(options->lookahead_window, alters.front().target_gate, window);
+            for (auto &a : alters) {
+                a.score = a.get_lookahead_score(past, window);
+                a.score_valid = true;
+                statistics.alternatives_scored++;
+            }
+        }
+        Real best_score = alters.front().score;
+        for (const auto &a : alters) {
+            best_score = min(best_score, a.score);
+        }
+        List<Alter> best_alters = alters;
+        best_alters.remove_if([best_score](const Alter &a) { return a.score != best_score; });
+        Alter::debug_print("... select_alter best lookahead alternatives:", best_alters);
+        result = tie_break_alter(best_alters, future, past);
+        result.debug_print("... the selected Alter is");
+        return;
+    }
+
     QL_ASSERT(
         options->heuristic == Heuristic::MIN_EXTEND ||
         options->heuristic == Heuristic::MIN_EXTEND_RC ||
@@ -627,10 +668,16 @@ void Mapper::select_alter(
 
     // Compute a score for each alternative relative to base_past, and sort the
     // alternatives based on it, minimum first.
-    for (auto &a : alters) {
-        a.debug_print("Considering extension by alternative: ...");
-        a.extend(past, base_past);           // locally here, past will be cloned and kept in alter
-        // and the extension stored into the a.score
+    {
+        ScopedTimer timer(statistics.scoring_time);
+        UInt past_size = past.get_approx_size();
+        for (auto &a : alters) {
+            a.debug_print("Considering extension by alternative: ...");
+            a.extend(past, base_past);           // locally here, past will be cloned and kept in alter
+            // and the extension stored into the a.score
+            statistics.alternatives_scored++;
+            statistics.record_past_copy(past_size);
+        }
     }
     alters.sort([this](const Alter &a1, const Alter &a2) { return a1.score < a2.score; });
     Alter::debug_print(
@@ -674,7 +721,7 @@ void Mapper::select_alter(
         Alter::debug_print(
             "... select_alter reduced to best alternatives to choose result from:",
             best_alters);
-        result = tie_break_alter(best_alters, future);
+        result = tie_break_alter(best_alters, future, past);
         result.debug_print("... the selected Alter (STOPPING RECURSION) is");
         // QL_DOUT("SelectAlter DONE level=" << level << " from " << bla.size() << " best alternatives");
         return;
@@ -706,6 +753,8 @@ void Mapper::select_alter(
         a.debug_print("... ... considering alternative:");
         Future sub_future = future; // copy!
         Past sub_past = past;       // copy!
+        statistics.future_copies++;
+        statistics.record_past_copy(past.get_approx_size());
         commit_alter(a, sub_future, sub_past);
         a.debug_print(
             "... ... committed this alternative first before recursion:");
@@ -791,7 +840,7 @@ void Mapper::select_alter(
     List<Alter> best_alters = good_alters;
     best_alters.remove_if([this,good_alters](const Alter& a) { return a.score != good_alters.front().score; });
     Alter::debug_print("... select_alter equally best alternatives on return of RECURSION:", best_alters);
-    result = tie_break_alter(best_alters, future);
+    result = tie_break_alter(best_alters, future, past);
     result.debug_print("... the selected Alter is");
     // QL_DOUT("... SelectAlter level=" << level << " selecting from " << bla.size() << " equally good alternatives above DONE");
     QL_DOUT("select_alter DONE level=" << recursion_depth << " from " << alters.size() << " alternatives");
@@ -828,6 +877,7 @@ void Mapper::map_gates(Future &future, Past &past, Past &base_past) {
         // is that at least something is done that decreases the problem.
 
         // Generate all alternative routes.
+        statistics.routing_decisions++;
         List<Alter> alters;
         gen_alters(gates, alters, past);
 
@@ -855,6 +905,11 @@ void Mapper::map_gates(Future &future, Past &past, Past &base_past) {
  * Performs (initial) placement of the qubits.
  */
 void Mapper::place(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r) {
+    ScopedTimer timer(statistics.placement_time);
+
+    // Whether a placement algorithm computed the mapping, such that later
+    // algorithms don't need to run.
+    Bool placed = false;
 
     if (options->enable_mip_placer) {
 #ifdef INITIALPLACE
@@ -868,11 +923,38 @@ void Mapper::place(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r)
         place_mip::detail::Algorithm ip;
         auto ipok = ip.run(k, ipopt, v2r); // compute mapping (in v2r) using ip model, may fail
         QL_DOUT("InitialPlace: kernel=" << k->name << " timeout=" << options->mip_timeout << " horizon=" << options->mip_horizon << " result=" << ipok << " iptimetaken=" << ip.get_time_taken() << " seconds [DONE]");
+        placed = ipok == place_mip::detail::Result::NEW_MAP
+              || ipok == place_mip::detail::Result::CURRENT
+              || ipok == place_mip::detail::Result::ANY;
 #else // ifdef INITIALPLACE
         QL_DOUT("InitialPlace support disabled during OpenQL build [DONE]");
         QL_WOUT("InitialPlace support disabled during OpenQL build [DONE]");
 #endif // ifdef INITIALPLACE
     }
+
+    if (options->enable_graph_placer && !placed) {
+        QL_DOUT("GraphPlace: kernel=" << k->name << " horizon=" << options->graph_placer_horizon << " [START]");
+
+        place_graph::detail::Options gpopt;
+        gpopt.map_all = options->initialize_one_to_one;
+        gpopt.horizon = options->graph_placer_horizon;
+        gpopt.max_refinement_passes = options->graph_placer_refinement_passes;
+
+        place_graph::detail::Algorithm gp;
+        auto gpok = gp.run(k, gpopt, v2r);
+        QL_DOUT(
+            "GraphPlace: kernel=" << k->name
+            << " horizon=" << options->graph_placer_horizon
+            << " result=" << gpok
+            << " initial_cost=" << gp.get_initial_cost()
+            << " final_cost=" << gp.get_final_cost()
+            << " timetaken=" << gp.get_time_taken() << " seconds [DONE]"
+        );
+        if (gpok == place_graph::detail::Result::FAILED) {
+            QL_WOUT("GraphPlace: kernel=" << k->name << " uses more interacting qubits than the platform has; falling back to the initial mapping");
+        }
+    }
+
     QL_IF_LOG_DEBUG {
         QL_DOUT("After InitialPlace");
         v2r.dump_state();
@@ -885,6 +967,7 @@ void Mapper::place(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r)
  * updating circuit and v2r maps.
  */
 void Mapper::route(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r) {
+    ScopedTimer timer(statistics.routing_time);
 
     // Future window, presents input in available list.
     Future future;
@@ -934,12 +1017,88 @@ void Mapper::route(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r)
 
 }
 
+/**
+ * Routes a copy of the given kernel, either as is or with its gates in reverse
+ * order, starting from and updating the given qubit map. The kernel itself is
+ * not modified. Returns the number of swaps added.
+ */
+UInt Mapper::route_copy(
+    const ir::compat::KernelRef &k,
+    com::map::QubitMapping &v2r,
+    Bool reverse
+) {
+    auto copy = utils::make<ir::compat::Kernel>(*k);
+    if (reverse) {
+        copy->gates.reset();
+        for (UInt i = k->gates.size(); i > 0; i--) {
+            copy->gates.add(k->gates[i - 1]);
+        }
+    }
+    route(copy, v2r);
+    return num_swaps_added;
+}
+
+/**
+ * Refines the initial placement in v2r by SABRE-style bidirectional routing:
+ * starting from the mapping at the end of a forward routing run, the reversed
+ * kernel is routed to find a mapping for the start of the kernel that suits its
+ * first gates, which is then evaluated by another forward run. This is
+ * repeated bidirectional_passes times, after which v2r is set to the mapping
+ * that needed the fewest swaps.
+ */
+void Mapper::refine_placement(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r) {
+
+    // The routing runs done here are not part of the actual routing of the
+    // kernel, so keep them out of its routing statistics.
+    Statistics saved_statistics = statistics;
+    {
+        ScopedTimer timer(saved_statistics.refinement_time);
+
+        // Route forward from the current placement to evaluate it and to get
+        // the mapping at the end of the kernel.
+        com::map::QubitMapping mapping = v2r;
+        UInt best_swaps = route_copy(k, mapping, false);
+        Vec<UInt> best_placement = v2r.get_virt_to_real();
+        QL_DOUT("Bidirectional refinement: kernel=" << k->name << " initial swaps=" << best_swaps);
+
+        for (UInt pass = 0; pass < options->bidirectional_passes && best_swaps > 0; pass++) {
+
+            // Route backward from the mapping at the end of the kernel. The
+            // mapping we end up with is a candidate placement for the start.
+            route_copy(k, mapping, true);
+            Vec<UInt> candidate = mapping.get_virt_to_real();
+
+            // Evaluate it by routing forward.
+            UInt swaps = route_copy(k, mapping, false);
+            QL_DOUT("Bidirectional refinement: kernel=" << k->name << " pass=" << pass << " swaps=" << swaps);
+            if (swaps < best_swaps) {
+                best_swaps = swaps;
+                best_placement = candidate;
+                saved_statistics.refinement_improvements++;
+            }
+
+        }
+
+        // Apply the best placement. Only the virtual-to-real map is taken
+        // over; the state of the real qubits is that at the start of the
+        // kernel, which placement doesn't change.
+        for (UInt v = 0; v < best_placement.size(); v++) {
+            v2r[v] = best_placement[v];
+        }
+        QL_DOUT("Bidirectional refinement: kernel=" << k->name << " best swaps=" << best_swaps << " [DONE]");
+
+    }
+    statistics = saved_statistics;
+
+}
+
 /**
  * Decomposes all gates in the circuit that have a definition with _prim
  * appended to its name. The mapper does this after routing.
  */
 void Mapper::decompose_to_primitives(const ir::compat::KernelRef &k) {
     QL_DOUT("decompose_to_primitives circuit ...");
+    ScopedTimer timer(statistics.decomposition_time);
 
     // Copy to allow kernel.c use by Past.new_gate.
     ir::compat::GateRefs circuit = k->gates;
@@ -983,7 +1142,7 @@ void Mapper::initialize(const ir::compat::PlatformRef &p, const OptionsRef &opt)
     nq = p->qubit_count;
     nc = p->creg_count;
     nb = p->breg_count;
-    random_init();
+    random_init(opt->trial_seed);
     // QL_DOUT("... platform/real number of qubits=" << nq << ");
     cycle_time = p->cycle_time;
 
@@ -1011,6 +1170,7 @@ void Mapper::map_kernel(const ir::compat::KernelRef &k) {
     QL_DOUT("Mapping kernel " << k->name << " [START]");
     QL_DOUT("... kernel original virtual number of qubits=" << k->qubit_count);
     kernel.reset();            // no new_gates until kernel.c has been copied
+    statistics = Statistics();
 
     QL_DOUT("Mapper::Map before v2r.initialize: assume_initialized=" << options->assume_initialized);
 
@@ -1033,6 +1193,15 @@ void Mapper::map_kernel(const ir::compat::KernelRef &k) {
     // Perform placement.
     place(k, v2r);
 
+    // Refine the placement by routing back and forth, if enabled.
+    if (options->bidirectional_passes > 0) {
+        refine_placement(k, v2r);
+        QL_IF_LOG_DEBUG {
+            QL_DOUT("After bidirectional refinement");
+            v2r.dump_state();
+        }
+    }
+
     // Save the placed qubit map for reporting. This is the resulting qubit map
     // at the *start* of the kernel.
     v2r_ip = v2r;
@@ -1059,6 +1228,155 @@ void Mapper::map_kernel(const ir::compat::KernelRef &k) {
     QL_DOUT("Mapping kernel " << k->name << " [DONE]");
 }
 
+/**
+ * Returns the number of cycles spanned by the scheduled gates of the given
+ * kernel, used to compare the results of mapping trials.
+ */
+static UInt get_kernel_depth(const ir::compat::KernelRef &k, UInt cycle_time) {
+    UInt start = ir::compat::MAX_CYCLE;
+    UInt end = 0;
+    for (const auto &gate : k->gates) {
+        if (gate->cycle == ir::compat::MAX_CYCLE) {
+            continue;
+        }
+        start = min(start, gate->cycle);
+        end = max(end, gate->cycle + (gate->duration + cycle_time - 1) / cycle_time);
+    }
+    return start < end ? end - start : 0;
+}
+
+/**
+ * Like map_kernel(), but runs num_trials independent mapping trials
+ * concurrently, each using its own Mapper, seed, and copy of the kernel, and
+ * keeps the best result according to the trial_selection option. The results
+ * of the winning trial are copied into this Mapper for reporting, and the
+ * per-trial results are pushed into the kernel's statistics and stored in
+ * trial_results.
+ */
+void Mapper::map_kernel_trials(const ir::compat::KernelRef &k) {
+    using pass::ana::statistics::AdditionalStats;
+    UInt num_trials = options->num_trials;
+    QL_DOUT("Mapping kernel " << k->name << " using " << num_trials << " trials [START]");
+
+    // Trials only differ if something is randomized, so fall back to random
+    // tie-breaking for all but the first trial if nothing is.
+    Bool randomized = options->tie_break_method == TieBreakMethod::RANDOM
+                   || options->path_selection_mode == PathSelectionMode::RANDOM;
+
+    // Heuristics to cycle through for vary_trial_heuristic.
+    static const Heuristic HEURISTICS[] = {
+        Heuristic::BASE,
+        Heuristic::BASE_RC,
+        Heuristic::MIN_EXTEND,
+        Heuristic::MIN_EXTEND_RC,
+        Heuristic::LOOKAHEAD
+    };
+    static const UInt NUM_HEURISTICS = sizeof(HEURISTICS) / sizeof(HEURISTICS[0]);
+    UInt heuristic_index = NUM_HEURISTICS;
+    for (UInt i = 0; i < NUM_HEURISTICS; i++) {
+        if (HEURISTICS[i] == options->heuristic) {
+            heuristic_index = i;
+        }
+    }
+
+    // Set up the trials. Each trial gets a shallow copy of the kernel, so the
+    // trials share the incoming gates. That's safe because the mapper only
+    // reads them and replaces the gate list with newly created gates; the only
+    // exception is the cycle numbering done when writing the dependency graph,
+    // which is why only the first trial may do that.
+    Vec<Mapper> mappers(num_trials);
+    Vec<ir::compat::KernelRef> kernels;
+    for (UInt i = 0; i < num_trials; i++) {
+        Ptr<Options> trial_options;
+        trial_options.emplace(*options);
+        trial_options->num_trials = 1;
+        if (i > 0) {
+            trial_options->write_dot_graphs = false;
+            if (!randomized) {
+                trial_options->tie_break_method = TieBreakMethod::RANDOM;
+            }
+            if (options->vary_trial_heuristic && heuristic_index < NUM_HEURISTICS) {
+                trial_options->heuristic = HEURISTICS[(heuristic_index + i) % NUM_HEURISTICS];
+            }
+        }
+        mappers[i].initialize(platform, trial_options.as_const());
+        mappers[i].random_init(seed + i);
+        kernels.push_back(utils::make<ir::compat::Kernel>(*k));
+    }
+
+    // Run them.
+    utils::parallel_for(num_trials, [&mappers, &kernels](UInt i) {
+        mappers[i].map_kernel(kernels[i]);
+    }, com::options::global["num_threads"].as_uint());
+
+    // Select the best one.
+    Vec<UInt> depths;
+    UInt best = 0;
+    for (UInt i = 0; i < num_trials; i++) {
+        depths.push_back(get_kernel_depth(kernels[i], cycle_time));
+        if (i == 0) continue;
+        auto swaps = mappers[i].num_swaps_added;
+        auto best_swaps = mappers[best].num_swaps_added;
+        Bool better;
+        if (options->trial_selection == TrialSelection::DEPTH) {
+            better = depths[i] < depths[best] || (depths[i] == depths[best] && swaps < best_swaps);
+        } else {
+            better = swaps < best_swaps || (swaps == best_swaps && depths[i] < depths[best]);
+        }
+        if (better) {
+            best = i;
+        }
+    }
+
+    // Report the results of all trials.
+    trial_results = Json::array();
+    for (UInt i = 0; i < num_trials; i++) {
+        const auto &mapper = mappers[i];
+        AdditionalStats::push(
+            k,
+            "trial " + to_string(i) +
+            ": seed=" + to_string(mapper.seed) +
+            " heuristic=" + to_string(mapper.options->heuristic) +
+            " tie_break_method=" + to_string(mapper.options->tie_break_method) +
+            " swaps added=" + to_string(mapper.num_swaps_added) +
+            " moves added=" + to_string(mapper.num_moves_added) +
+            " depth=" + to_string(depths[i])
+        );
+        Json trial;
+        trial["seed"] = mapper.seed;
+        trial["heuristic"] = to_string(mapper.options->heuristic);
+        trial["tie_break_method"] = to_string(mapper.options->tie_break_method);
+        trial["swaps_added"] = mapper.num_swaps_added;
+        trial["moves_added"] = mapper.num_moves_added;
+        trial["depth"] = depths[i];
+        trial["selected"] = i == best;
+        trial_results.push_back(trial);
+    }
+    AdditionalStats::push(k, "selected trial: " + to_string(best) + " (seed " + to_string(mappers[best].seed) + ")");
+    QL_IOUT(
+        "Mapping kernel " << k->name << ": selected trial " << best
+        << " of " << num_trials << " (seed " << mappers[best].seed
+        << ", " << mappers[best].num_swaps_added << " swaps, depth "
+        << depths[best] << ")"
+    );
+
+    // Adopt the result of the winning trial.
+    const auto &winner = kernels[best];
+    k->gates = winner->gates;
+    k->cycles_valid = winner->cycles_valid;
+    k->qubit_count = winner->qubit_count;
+    k->creg_count = winner->creg_count;
+    k->breg_count = winner->breg_count;
+    num_swaps_added = mappers[best].num_swaps_added;
+    num_moves_added = mappers[best].num_moves_added;
+    statistics = mappers[best].statistics;
+    v2r_in = mappers[best].v2r_in;
+    v2r_ip = mappers[best].v2r_ip;
+    v2r_out = mappers[best].v2r_out;
+
+    QL_DOUT("Mapping kernel " << k->name << " using " << num_trials << " trials [DONE]");
+}
+
 /**
  * Runs mapping for the given program.
  *
@@ -1074,40 +1392,89 @@ void Mapper::map(const ir::compat::ProgramRef &prog, const OptionsRef &opt) {
     // Perform program-wide initialization.
     initialize(prog->platform, opt);
 
-    // Map kernel by kernel, adding statistics all the while.
-    UInt total_swaps = 0;
-    UInt total_moves = 0;
-    Real total_time_taken = 0.0;
-    for (const auto &k : prog->kernels) {
+    // Map the kernels. Each kernel is mapped by its own mapper, starting from
+    // the program's initial mapping, so the kernels are independent and can
+    // be mapped concurrently if requested. When mapped sequentially, the state
+    // of the random number generator carries over from kernel to kernel, as
+    // if a single mapper were used. That can't be done for concurrent mapping,
+    // so each kernel then starts from the program's initial generator state.
+    // Either way, the reported seed suffices to reproduce the result.
+    UInt num_kernels = prog->kernels.size();
+    Vec<Mapper> mappers(num_kernels);
+    Vec<Real> times_taken(num_kernels, 0.0);
+    Bool parallel_kernels = options->parallel_kernels;
+    utils::parallel_for(num_kernels, [this, &prog, &mappers, &times_taken, parallel_kernels](UInt i) {
+        const auto &k = prog->kernels[i];
+        auto &mapper = mappers[i];
         QL_IOUT("Mapping kernel: " << k->name);
 
         // Start interval timer for measuring time taken for this kernel.
-        Real time_taken = 0.0;
         using namespace std::chrono;
         high_resolution_clock::time_point t1 = high_resolution_clock::now();
 
         // Actually do the mapping.
-        map_kernel(k);
+        mapper.initialize(platform, options);
+        mapper.rng = rng;
+        mapper.seed = seed;
+        if (options->num_trials > 1) {
+            mapper.map_kernel_trials(k);
+        } else {
+            mapper.map_kernel(k);
+        }
+        if (!parallel_kernels) {
+            rng = mapper.rng;
+        }
 
         // Stop the interval timer.
         high_resolution_clock::time_point t2 = high_resolution_clock::now();
         duration<Real> time_span = t2 - t1;
-        time_taken = time_span.count();
+        times_taken[i] = time_span.count();
+    }, parallel_kernels ? com::options::global["num_threads"].as_uint() : 1);
+
+    // Add statistics kernel by kernel, in program order regardless of the
+    // order in which the kernels were mapped.
+    UInt total_swaps = 0;
+    UInt total_moves = 0;
+    Real total_time_taken = 0.0;
+    Statistics total_statistics;
+    Json json_kernels = Json::object();
+    for (UInt i = 0; i < num_kernels; i++) {
+        const auto &k = prog->kernels[i];
+        const auto &mapper = mappers[i];
+        auto time_taken = times_taken[i];
 
         // Push mapping statistics into the kernel.
-        AdditionalStats::push(k, "swaps added: " + to_string(num_swaps_added));
-        AdditionalStats::push(k, "of which moves added: " + to_string(num_moves_added));
-        AdditionalStats::push(k, "virt2real map before mapper:" + to_string(v2r_in.get_virt_to_real()));
-        AdditionalStats::push(k, "virt2real map after initial placement:" + to_string(v2r_ip.get_virt_to_real()));
-        AdditionalStats::push(k, "virt2real map after mapper:" + to_string(v2r_out.get_virt_to_real()));
-        AdditionalStats::push(k, "realqubit states before mapper:" + to_string(v2r_in.get_state()));
-        AdditionalStats::push(k, "realqubit states after mapper:" + to_string(v2r_out.get_state()));
+        AdditionalStats::push(k, "swaps added: " + to_string(mapper.num_swaps_added));
+        AdditionalStats::push(k, "of which moves added: " + to_string(mapper.num_moves_added));
+        AdditionalStats::push(k, "virt2real map before mapper:" + to_string(mapper.v2r_in.get_virt_to_real()));
+        AdditionalStats::push(k, "virt2real map after initial placement:" + to_string(mapper.v2r_ip.get_virt_to_real()));
+        AdditionalStats::push(k, "virt2real map after mapper:" + to_string(mapper.v2r_out.get_virt_to_real()));
+        AdditionalStats::push(k, "realqubit states before mapper:" + to_string(mapper.v2r_in.get_state()));
+        AdditionalStats::push(k, "realqubit states after mapper:" + to_string(mapper.v2r_out.get_state()));
+        if (options->num_trials <= 1) {
+            AdditionalStats::push(k, "random seed: " + to_string(mapper.seed));
+        }
         AdditionalStats::push(k, "time taken: " + to_string(time_taken));
+        for (const auto &line : mapper.statistics.to_lines()) {
+            AdditionalStats::push(k, line);
+        }
 
         // Update total statistical counters.
-        total_swaps += num_swaps_added;
-        total_moves += num_moves_added;
+        total_swaps += mapper.num_swaps_added;
+        total_moves += mapper.num_moves_added;
         total_time_taken += time_taken;
+        total_statistics.merge(mapper.statistics);
+        if (options->write_statistics_json) {
+            json_kernels[k->name] = mapper.statistics.to_json();
+            json_kernels[k->name]["swaps_added"] = mapper.num_swaps_added;
+            json_kernels[k->name]["moves_added"] = mapper.num_moves_added;
+            json_kernels[k->name]["time_taken"] = time_taken;
+            if (mapper.trial_results.is_null()) {
+                json_kernels[k->name]["seed"] = mapper.seed;
+            } else {
+                json_kernels[k->name]["trials"] = mapper.trial_results;
+            }
+        }
 
     }
 
@@ -1115,6 +1482,22 @@ void Mapper::map(const ir::compat::ProgramRef &prog, const OptionsRef &opt) {
     AdditionalStats::push(prog, "Total no. of swaps: " + to_string(total_swaps));
     AdditionalStats::push(prog, "Total no. of moves of swaps: " + to_string(total_moves));
     AdditionalStats::push(prog, "Total time taken: " + to_string(total_time_taken));
+    for (const auto &line : total_statistics.to_lines()) {
+        AdditionalStats::push(prog, line);
+    }
+
+    // Write the statistics as JSON if requested.
+    if (options->write_statistics_json) {
+        Json json;
+        json["kernels"] = json_kernels;
+        json["total"] = total_statistics.to_json();
+        json["total"]["swaps_added"] = total_swaps;
+        json["total"]["moves_added"] = total_moves;
+        json["total"]["time_taken"] = total_time_taken;
+        Str fname = options->output_prefix + "_statistics.json";
+        QL_IOUT("writing mapper statistics to '" << fname << "' ...");
+        OutFile(fname) << json.dump(4) << "\n";
+    }
 
     // Kernel qubit/creg/breg counts will have been updated to the platform
     // counts, so we need to do the same for the program.
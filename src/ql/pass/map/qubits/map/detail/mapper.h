@@ -11,6 +11,7 @@
 #include "ql/utils/list.h"
 #include "ql/utils/map.h"
 #include "ql/utils/progress.h"
+#include "ql/utils/json.h"
 #include "ql/ir/compat/compat.h"
 #include "ql/com/map/qubit_mapping.h"
 #include "options.h"
@@ -18,6 +19,7 @@
 #include "past.h"
 #include "alter.h"
 #include "future.h"
+#include "statistics.h"
 
 namespace ql {
 namespace pass {
@@ -256,6 +258,12 @@ private:
      */
     std::mt19937 rng;
 
+    /**
+     * The seed that rng was last seeded with, reported in the statistics so
+     * results can be reproduced.
+     */
+    utils::UInt seed = 0;
+
     /**
      * Routing progress tracker.
      */
@@ -273,6 +281,12 @@ private:
      */
     utils::UInt num_moves_added;
 
+    /**
+     * Instrumentation counters and timers for the most recently mapped kernel,
+     * reset by map_kernel().
+     */
+    Statistics statistics;
+
     /**
      * Qubit mapping before mapping, set by map_kernel().
      */
@@ -375,15 +389,16 @@ private:
     );
 
     /**
-     * Seeds the random number generator with the current time in microseconds.
+     * Seeds the random number generator with the given seed, or with the
+     * current time in microseconds if the given seed is 0.
      */
-    void random_init();
+    void random_init(utils::UInt new_seed = 0);
 
     /**
      * Chooses an Alter from the list based on the configured tie-breaking
      * strategy.
      */
-    Alter tie_break_alter(utils::List<Alter> &alters, Future &future);
+    Alter tie_break_alter(utils::List<Alter> &alters, Future &future, const Past &past);
 
     /**
      * Map the gate/operands of a gate that has been routed or doesn't require
@@ -443,6 +458,9 @@ private:
      *    of the given past (or some factor of that amount, ordered by
      *    increasing cycle extension) and recurse. When the recursion depth
      *    limit is reached, apply the tie-breaking strategy.
+     *  - If LOOKAHEAD, score the Alters by the distances between the operands
+     *    of the next two-qubit gates after their swaps, and apply the
+     *    tie-breaking strategy to the best-scoring ones without recursing.
      *
      * For recursion, past is the speculative past, and base_past is the past
      * we've already committed to, and should thus measure fitness against.
@@ -476,6 +494,27 @@ private:
      */
     void route(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r);
 
+    /**
+     * Routes a copy of the given kernel, either as is or with its gates in
+     * reverse order, starting from and updating the given qubit map. The
+     * kernel itself is not modified. Returns the number of swaps added.
+     */
+    utils::UInt route_copy(
+        const ir::compat::KernelRef &k,
+        com::map::QubitMapping &v2r,
+        utils::Bool reverse
+    );
+
+    /**
+     * Refines the initial placement in v2r by SABRE-style bidirectional
+     * routing: starting from the mapping at the end of a forward routing run,
+     * the reversed kernel is routed to find a mapping for the start of the
+     * kernel that suits its first gates, which is then evaluated by another
+     * forward run. This is repeated bidirectional_passes times, after which v2r
+     * is set to the mapping that needed the fewest swaps.
+     */
+    void refine_placement(const ir::compat::KernelRef &k, com::map::QubitMapping &v2r);
+
     /**
      * Decomposes all gates in the circuit that have a definition with _prim
      * appended to its name. The mapper does this after routing.
@@ -507,6 +546,22 @@ private:
      */
     void map_kernel(const ir::compat::KernelRef &k);
 
+    /**
+     * Like map_kernel(), but runs num_trials independent mapping trials
+     * concurrently, each using its own Mapper, seed, and copy of the kernel,
+     * and keeps the best result according to the trial_selection option. The
+     * results of the winning trial are copied into this Mapper for reporting,
+     * and the per-trial results are pushed into the kernel's statistics and
+     * stored in trial_results.
+     */
+    void map_kernel_trials(const ir::compat::KernelRef &k);
+
+    /**
+     * Per-trial results for the most recently mapped kernel, set by
+     * map_kernel_trials() and cleared by map(), for the JSON statistics.
+     */
+    utils::Json trial_results;
+
 public:
 
     /**
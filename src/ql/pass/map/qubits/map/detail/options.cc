@@ -21,6 +21,7 @@ std::ostream &operator<<(std::ostream &os, Heuristic h) {
         case Heuristic::MIN_EXTEND:    os << "min_extend";    break;
         case Heuristic::MIN_EXTEND_RC: os << "min_extend_rc"; break;
         case Heuristic::MAX_FIDELITY:  os << "max_fidelity";  break;
+        case Heuristic::LOOKAHEAD:     os << "lookahead";     break;
     }
     return os;
 }
@@ -75,6 +76,17 @@ std::ostream &operator<<(std::ostream &os, TieBreakMethod tbm) {
     return os;
 }
 
+/**
+ * String conversion for TrialSelection.
+ */
+std::ostream &operator<<(std::ostream &os, TrialSelection ts) {
+    switch (ts) {
+        case TrialSelection::SWAPS: os << "swaps"; break;
+        case TrialSelection::DEPTH: os << "depth"; break;
+    }
+    return os;
+}
+
 } // namespace detail
 } // namespace map
 } // namespace qubits
@@ -52,7 +52,19 @@ enum class Heuristic {
     /**
      * No longer supported?
      */
-    MAX_FIDELITY
+    MAX_FIDELITY,
+
+    /**
+     * Favor alternatives that bring the operands of the next few two-qubit
+     * gates closest together. Each alternative is scored by the distances
+     * between the operands of the next lookahead_window unmapped two-qubit
+     * gates, as they would be after its swaps, weighted by powers of
+     * lookahead_decay. This is computed directly from the distance table of
+     * the topology, without copying the past or recursing, so its cost is
+     * close to that of BASE. The tie-breaking strategy is applied to the
+     * best-scoring alternatives.
+     */
+    LOOKAHEAD
 
 };
 
@@ -171,6 +183,31 @@ enum class TieBreakMethod {
  */
 std::ostream &operator<<(std::ostream &os, TieBreakMethod tbm);
 
+/**
+ * Criteria for selecting the best result when multiple mapping trials are run
+ * for a kernel.
+ */
+enum class TrialSelection {
+
+    /**
+     * Select the trial that added the fewest swaps (including moves), using
+     * the circuit depth to break ties.
+     */
+    SWAPS,
+
+    /**
+     * Select the trial that resulted in the shortest schedule, using the
+     * number of added swaps to break ties.
+     */
+    DEPTH
+
+};
+
+/**
+ * String conversion for TrialSelection.
+ */
+std::ostream &operator<<(std::ostream &os, TrialSelection ts);
+
 /**
  * Main options structure.
  */
@@ -220,6 +257,32 @@ struct Options {
      */
     utils::UInt mip_horizon = 0;
 
+    /**
+     * Controls whether the interaction-graph-based placement algorithm should
+     * be run before resorting to heuristic mapping. If the MIP-based placer is
+     * also enabled, this is only used when the MIP-based placer doesn't find a
+     * mapping.
+     */
+    utils::Bool enable_graph_placer = false;
+
+    /**
+     * The graph-based placement algorithm will only consider the first horizon
+     * two-qubit gates of a kernel. 0 means that all gates should be considered.
+     */
+    utils::UInt graph_placer_horizon = 0;
+
+    /**
+     * Maximum number of refinement passes done by the graph-based placement
+     * algorithm.
+     */
+    utils::UInt graph_placer_refinement_passes = 10;
+
+    /**
+     * Number of forward/backward routing passes used to refine the initial
+     * placement before the actual routing pass. 0 disables refinement.
+     */
+    utils::UInt bidirectional_passes = 0;
+
     /**
      * Controls which heuristic the heuristic mapper is to use.
      */
@@ -231,6 +294,18 @@ struct Options {
      */
     utils::UInt max_alters = 0;
 
+    /**
+     * Number of unmapped two-qubit gates considered by the LOOKAHEAD
+     * heuristic.
+     */
+    utils::UInt lookahead_window = 20;
+
+    /**
+     * Weight factor applied for each next two-qubit gate in the lookahead
+     * window of the LOOKAHEAD heuristic.
+     */
+    utils::Real lookahead_decay = 0.8;
+
     /**
      * Controls how to tie-break equally-scoring alternative mapping solutions.
      */
@@ -315,6 +390,42 @@ struct Options {
      */
     utils::Bool write_dot_graphs = false;
 
+    /**
+     * Whether to write the mapper's instrumentation counters and phase timers
+     * to a JSON file, in addition to the statistics report.
+     */
+    utils::Bool write_statistics_json = false;
+
+    /**
+     * Number of independent mapping trials to run for each kernel. When more
+     * than one, the trials are run concurrently on copies of the kernel, each
+     * with its own random seed, and the best result is kept.
+     */
+    utils::UInt num_trials = 1;
+
+    /**
+     * Criterion for selecting the best trial.
+     */
+    TrialSelection trial_selection = TrialSelection::SWAPS;
+
+    /**
+     * Seed for the random number generator, or 0 to seed based on the current
+     * time. Trial i of a kernel uses this seed plus i.
+     */
+    utils::UInt trial_seed = 0;
+
+    /**
+     * Whether the trials should cycle through the routing heuristics, starting
+     * with the configured one, rather than all using the configured one.
+     */
+    utils::Bool vary_trial_heuristic = false;
+
+    /**
+     * Whether kernels should be mapped concurrently. This is possible because
+     * each kernel starts from the program's initial mapping.
+     */
+    utils::Bool parallel_kernels = false;
+
 };
 
 /**
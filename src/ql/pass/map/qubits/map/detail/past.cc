@@ -110,23 +110,26 @@ void Past::schedule() {
         // the earliest start cycle per qubit, and so dependencies are
         // respected, so we can find the gate that can start first...
         //
-        // Note that tryfc includes the free cycle vector AND the resource map,
-        // so using tryfc.StartCycle/tryfc.Add we get a realistic ASAP rc
-        // schedule. We use a copy of fc and not fc itself, since the latter
+        // Note that fc includes the free cycle vector AND the resource map,
+        // so using fc.get_start_cycle/fc.add we get a realistic ASAP rc
+        // schedule. These trial additions are rolled back afterwards, since fc
         // reflects the really scheduled gates and that shouldn't be changed.
+        // This used to be done with a copy of fc, but that copies the complete
+        // resource state for every scheduled gate.
         //
         // This search is really a hack to avoid the construction of a
         // dependency graph and a set of schedulable gates.
-        FreeCycle tryfc = fc;
+        fc.checkpoint();
         for (auto try_gate_it = waiting_gates.begin(); try_gate_it != waiting_gates.end(); ++try_gate_it) {
-            utils::UInt try_start_cycle = tryfc.get_start_cycle(*try_gate_it);
-            tryfc.add(*try_gate_it, try_start_cycle);
+            utils::UInt try_start_cycle = fc.get_start_cycle(*try_gate_it);
+            fc.add(*try_gate_it, try_start_cycle);
 
             if (try_start_cycle < start_cycle) {
                 start_cycle = try_start_cycle;
                 gate_it = try_gate_it;
             }
         }
+        fc.rollback();
 
         auto gate = *gate_it;
 
@@ -269,6 +272,26 @@ utils::UInt Past::get_num_moves_added() const {
     return num_moves_added;
 }
 
+/**
+ * Returns an estimate of the number of bytes of heap and object memory that a
+ * copy of this past occupies, for instrumentation purposes. The state of the
+ * resource manager is not included.
+ */
+utils::UInt Past::get_approx_size() const {
+
+    // List nodes have a previous and next pointer in addition to the value,
+    // map nodes have parent, left, and right pointers and a color.
+    static const utils::UInt LIST_NODE = sizeof(ir::compat::GateRef) + 2 * sizeof(void*);
+    static const utils::UInt MAP_NODE = sizeof(ir::compat::GateRef) + sizeof(utils::UInt) + 4 * sizeof(void*);
+
+    utils::UInt size = sizeof(Past);
+    size += (waiting_gates.size() + gates.size() + output_gates.size()) * LIST_NODE;
+    size += cycle.size() * MAP_NODE;
+    size += (nq + nb) * sizeof(utils::UInt);
+    size += nq * (sizeof(utils::UInt) + sizeof(com::map::QubitState));
+    return size;
+}
+
 /**
  * Shorthand for throwing an exception for a non-existant gate.
  */
@@ -519,6 +542,14 @@ utils::UInt Past::map_qubit(utils::UInt virt) {
     return r;
 }
 
+/**
+ * Returns the real qubit index implementing virtual qubit index, or
+ * com::map::UNDEFINED_QUBIT if the virtual qubit is not yet mapped.
+ */
+utils::UInt Past::get_real(utils::UInt virt) const {
+    return v2r[virt];
+}
+
 /**
  * Strips the fixed qubit operands (if any) from the given gate name.
  */
@@ -651,6 +682,18 @@ utils::UInt Past::get_max_free_cycle() const {
     return fc.get_max();
 }
 
+/**
+ * Returns the cycle from which the real qubit implementing the given virtual
+ * qubit is free, or 0 if the virtual qubit is not yet mapped.
+ */
+utils::UInt Past::get_free_cycle(utils::UInt virt) const {
+    utils::UInt real = get_real(virt);
+    if (real == com::map::UNDEFINED_QUBIT) {
+        return 0;
+    }
+    return fc.get_free_cycle(real);
+}
+
 /**
  * Non-quantum and quantum gates follow separate flows through Past:
  *
@@ -243,6 +243,13 @@ public:
      */
     utils::UInt get_num_moves_added() const;
 
+    /**
+     * Returns an estimate of the number of bytes of heap and object memory
+     * that a copy of this past occupies, for instrumentation purposes. The
+     * state of the resource manager is not included.
+     */
+    utils::UInt get_approx_size() const;
+
     /**
      * Returns whether swap(fr0,fr1) starts earlier than swap(sr0,sr1). This is
      * really a short-cut ignoring config file and perhaps several other
@@ -293,6 +300,12 @@ public:
      */
     utils::UInt map_qubit(utils::UInt virt);
 
+    /**
+     * Returns the real qubit index implementing virtual qubit index, or
+     * com::map::UNDEFINED_QUBIT if the virtual qubit is not yet mapped.
+     */
+    utils::UInt get_real(utils::UInt virt) const;
+
     /**
      * Turns the given gate into a "real" gate.
      *
@@ -349,6 +362,12 @@ public:
      */
     utils::UInt get_max_free_cycle() const;
 
+    /**
+     * Returns the cycle from which the real qubit implementing the given
+     * virtual qubit is free, or 0 if the virtual qubit is not yet mapped.
+     */
+    utils::UInt get_free_cycle(utils::UInt virt) const;
+
     /**
      * Non-quantum and quantum gates follow separate flows through Past:
      *
@@ -0,0 +1,125 @@
+/** \file
+ * Defines the instrumentation counters and timers of the mapper.
+ */
+
+#include "statistics.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+using namespace utils;
+
+/**
+ * Records that the given number of alternatives was generated for a single set
+ * of gates.
+ */
+void Statistics::record_alternatives(UInt count) {
+    alternatives_generated += count;
+    max_alternatives_generated = max(max_alternatives_generated, count);
+}
+
+/**
+ * Records a visit to a node of the recursion tree at the given depth.
+ */
+void Statistics::record_recursion_node(UInt depth) {
+    recursion_nodes++;
+    max_recursion_depth = max(max_recursion_depth, depth);
+}
+
+/**
+ * Records a copy of a past of the given approximate size.
+ */
+void Statistics::record_past_copy(UInt bytes) {
+    past_copies++;
+    past_bytes_copied += bytes;
+}
+
+/**
+ * Adds the counters and timers of the given statistics to this one.
+ */
+void Statistics::merge(const Statistics &other) {
+    routing_decisions += other.routing_decisions;
+    alternatives_generated += other.alternatives_generated;
+    max_alternatives_generated = max(max_alternatives_generated, other.max_alternatives_generated);
+    alternatives_scored += other.alternatives_scored;
+    recursion_nodes += other.recursion_nodes;
+    max_recursion_depth = max(max_recursion_depth, other.max_recursion_depth);
+    past_copies += other.past_copies;
+    past_bytes_copied += other.past_bytes_copied;
+    future_copies += other.future_copies;
+    refinement_improvements += other.refinement_improvements;
+    placement_time.merge(other.placement_time);
+    refinement_time.merge(other.refinement_time);
+    routing_time.merge(other.routing_time);
+    path_generation_time.merge(other.path_generation_time);
+    scoring_time.merge(other.scoring_time);
+    tie_breaking_time.merge(other.tie_breaking_time);
+    commit_time.merge(other.commit_time);
+    decomposition_time.merge(other.decomposition_time);
+}
+
+/**
+ * Returns the statistics as a list of human-readable lines, suitable for
+ * pass::ana::statistics::AdditionalStats.
+ */
+List<Str> Statistics::to_lines() const {
+    auto per_decision = [this](UInt count) -> Str {
+        if (!routing_decisions) return "n/a";
+        return to_string((Real)count / (Real)routing_decisions);
+    };
+    List<Str> lines;
+    lines.push_back("routing decisions: " + to_string(routing_decisions));
+    lines.push_back("alternatives generated: " + to_string(alternatives_generated) + " (avg per decision: " + per_decision(alternatives_generated) + ", max: " + to_string(max_alternatives_generated) + ")");
+    lines.push_back("alternatives scored: " + to_string(alternatives_scored) + " (avg per decision: " + per_decision(alternatives_scored) + ")");
+    lines.push_back("recursion nodes visited: " + to_string(recursion_nodes) + " (max depth: " + to_string(max_recursion_depth) + ")");
+    lines.push_back("past copies: " + to_string(past_copies) + " (approx. bytes copied: " + to_string(past_bytes_copied) + ")");
+    lines.push_back("future copies: " + to_string(future_copies));
+    lines.push_back("time taken by placement: " + to_string(placement_time.get_seconds()));
+    lines.push_back("time taken by placement refinement: " + to_string(refinement_time.get_seconds()) + " (improvements: " + to_string(refinement_improvements) + ")");
+    lines.push_back("time taken by routing: " + to_string(routing_time.get_seconds()));
+    lines.push_back("... of which path generation: " + to_string(path_generation_time.get_seconds()));
+    lines.push_back("... of which scoring: " + to_string(scoring_time.get_seconds()));
+    lines.push_back("... of which tie breaking: " + to_string(tie_breaking_time.get_seconds()));
+    lines.push_back("... of which committing: " + to_string(commit_time.get_seconds()));
+    lines.push_back("time taken by decomposition: " + to_string(decomposition_time.get_seconds()));
+    return lines;
+}
+
+/**
+ * Returns the statistics as a JSON object.
+ */
+Json Statistics::to_json() const {
+    Json json;
+    json["routing_decisions"] = routing_decisions;
+    json["alternatives_generated"] = alternatives_generated;
+    json["max_alternatives_generated"] = max_alternatives_generated;
+    json["alternatives_scored"] = alternatives_scored;
+    json["recursion_nodes"] = recursion_nodes;
+    json["max_recursion_depth"] = max_recursion_depth;
+    json["past_copies"] = past_copies;
+    json["past_bytes_copied"] = past_bytes_copied;
+    json["future_copies"] = future_copies;
+    json["refinement_improvements"] = refinement_improvements;
+    json["time"] = {
+        {"placement", placement_time.get_seconds()},
+        {"refinement", refinement_time.get_seconds()},
+        {"routing", routing_time.get_seconds()},
+        {"path_generation", path_generation_time.get_seconds()},
+        {"scoring", scoring_time.get_seconds()},
+        {"tie_breaking", tie_breaking_time.get_seconds()},
+        {"commit", commit_time.get_seconds()},
+        {"decomposition", decomposition_time.get_seconds()}
+    };
+    return json;
+}
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
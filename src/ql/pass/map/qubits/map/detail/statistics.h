@@ -0,0 +1,167 @@
+/** \file
+ * Defines the instrumentation counters and timers of the mapper.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/list.h"
+#include "ql/utils/json.h"
+#include "ql/utils/profile.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * Low-overhead counters and phase timers for the mapper, used to figure out
+ * where the time goes when mapping is slow. One of these is maintained per
+ * kernel, and they are merged to form the program-wide totals.
+ */
+struct Statistics {
+
+    /**
+     * Number of routing decisions made at the top level, i.e. the number of
+     * times that a set of non-nearest-neighbor two-qubit gates was handed to
+     * the alternative generation and selection logic.
+     */
+    utils::UInt routing_decisions = 0;
+
+    /**
+     * Total number of routing alternatives generated, including those
+     * generated during recursion.
+     */
+    utils::UInt alternatives_generated = 0;
+
+    /**
+     * Maximum number of alternatives generated for a single set of gates.
+     */
+    utils::UInt max_alternatives_generated = 0;
+
+    /**
+     * Total number of alternatives scored by extending a copy of the past with
+     * their swaps.
+     */
+    utils::UInt alternatives_scored = 0;
+
+    /**
+     * Number of select_alter() invocations, i.e. the number of nodes visited
+     * in the recursion tree, including the top-level nodes.
+     */
+    utils::UInt recursion_nodes = 0;
+
+    /**
+     * Deepest recursion level reached.
+     */
+    utils::UInt max_recursion_depth = 0;
+
+    /**
+     * Number of times a Past was copied, either for scoring an alternative or
+     * for speculation during recursion.
+     */
+    utils::UInt past_copies = 0;
+
+    /**
+     * Estimated number of bytes copied for the above; see
+     * Past::get_approx_size().
+     */
+    utils::UInt past_bytes_copied = 0;
+
+    /**
+     * Number of times a Future was copied for speculation during recursion.
+     */
+    utils::UInt future_copies = 0;
+
+    /**
+     * Number of bidirectional refinement passes that improved the initial
+     * placement, i.e. resulted in fewer swaps during forward routing.
+     */
+    utils::UInt refinement_improvements = 0;
+
+    /**
+     * Time spent on initial placement.
+     */
+    utils::Stopwatch placement_time;
+
+    /**
+     * Time spent on bidirectional refinement of the initial placement. The
+     * routing done for this is not included in the routing counters and
+     * timers.
+     */
+    utils::Stopwatch refinement_time;
+
+    /**
+     * Time spent on routing, including all the phases below save for
+     * decomposition.
+     */
+    utils::Stopwatch routing_time;
+
+    /**
+     * Time spent generating alternative routing paths.
+     */
+    utils::Stopwatch path_generation_time;
+
+    /**
+     * Time spent scoring alternatives via Alter::extend().
+     */
+    utils::Stopwatch scoring_time;
+
+    /**
+     * Time spent breaking ties between equally-scored alternatives.
+     */
+    utils::Stopwatch tie_breaking_time;
+
+    /**
+     * Time spent committing alternatives, both speculatively and for real.
+     */
+    utils::Stopwatch commit_time;
+
+    /**
+     * Time spent decomposing the routed circuit into primitives.
+     */
+    utils::Stopwatch decomposition_time;
+
+    /**
+     * Records that the given number of alternatives was generated for a single
+     * set of gates.
+     */
+    void record_alternatives(utils::UInt count);
+
+    /**
+     * Records a visit to a node of the recursion tree at the given depth.
+     */
+    void record_recursion_node(utils::UInt depth);
+
+    /**
+     * Records a copy of a past of the given approximate size.
+     */
+    void record_past_copy(utils::UInt bytes);
+
+    /**
+     * Adds the counters and timers of the given statistics to this one.
+     */
+    void merge(const Statistics &other);
+
+    /**
+     * Returns the statistics as a list of human-readable lines, suitable for
+     * pass::ana::statistics::AdditionalStats.
+     */
+    utils::List<utils::Str> to_lines() const;
+
+    /**
+     * Returns the statistics as a JSON object.
+     */
+    utils::Json to_json() const;
+
+};
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
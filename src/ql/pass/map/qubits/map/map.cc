@@ -187,6 +187,57 @@ MapQubitsPass::MapQubitsPass(
         "0", 0, utils::MAX
     );
 
+    //========================================================================//
+    // Options for the interaction-graph-based initial placement engine       //
+    //========================================================================//
+
+    options.add_bool(
+        "enable_graph_placer",
+        "Controls whether the interaction-graph-based initial placement "
+        "algorithm should be run before resorting to heuristic mapping. Unlike "
+        "the MIP-based placer, this does not look for an optimal placement, "
+        "but it scales to devices with thousands of qubits. It places qubits "
+        "that interact a lot close to each other, partitioning them over the "
+        "cores of multi-core platforms first. If the MIP-based placer is also "
+        "enabled, this is only used when it fails to find a mapping.",
+        false
+    );
+
+    options.add_int(
+        "graph_placer_horizon",
+        "This controls how many two-qubit gates the interaction-graph-based "
+        "initial placement algorithm considers for each kernel (if enabled). "
+        "If 0 or unspecified, all gates are considered.",
+        "0", 0, utils::MAX
+    );
+
+    options.add_int(
+        "graph_placer_refinement_passes",
+        "Maximum number of local refinement passes done by the "
+        "interaction-graph-based initial placement algorithm (if enabled). "
+        "Each pass tries to move each qubit to a neighboring location, "
+        "swapping with the qubit there, if this reduces the distance between "
+        "interacting qubits. 0 disables refinement.",
+        "10", 0, utils::MAX
+    );
+
+    //========================================================================//
+    // Options for bidirectional placement refinement                         //
+    //========================================================================//
+
+    options.add_int(
+        "bidirectional_passes",
+        "The number of SABRE-style forward/backward routing passes used to "
+        "refine the initial placement before the kernel is actually routed. "
+        "Each pass routes a copy of the kernel in reverse, starting from the "
+        "mapping at the end of the previous forward routing, and then routes "
+        "it forward again from the resulting mapping to evaluate it. The "
+        "mapping that required the fewest swaps is used as the initial "
+        "placement. Each pass costs roughly two routing runs; 0 disables "
+        "refinement.",
+        "0", 0, 1000
+    );
+
     //========================================================================//
     // Options controlling the heuristic routing algorithm                    //
     //========================================================================//
@@ -203,10 +254,31 @@ MapQubitsPass::MapQubitsPass(
         "the best alternatives in terms of circuit duration within some"
         "lookahead window. The existence of the `rc` suffix specifies whether "
         "the internal scheduling for fitness determination should be done with "
-        "or without resource constraints. `maxfidelity` is not supported "
-        "in this build of OpenQL.",
+        "or without resource constraints. `lookahead` is a cheap middle "
+        "ground: it favors the routes that bring the operands of the next "
+        "`lookahead_window` two-qubit gates closest together, weighting each "
+        "next gate by another factor `lookahead_decay`, without speculative "
+        "scheduling or recursion. `maxfidelity` is not supported in this build "
+        "of OpenQL.",
         "base",
-        {"base", "baserc", "minextend", "minextendrc", "maxfidelity"}
+        {"base", "baserc", "minextend", "minextendrc", "maxfidelity", "lookahead"}
+    );
+
+    options.add_int(
+        "lookahead_window",
+        "The number of upcoming unmapped two-qubit gates considered by the "
+        "`lookahead` routing heuristic.",
+        "20", 1, utils::MAX
+    );
+
+    options.add_real(
+        "lookahead_decay",
+        "Weight factor applied to each next two-qubit gate in the lookahead "
+        "window of the `lookahead` routing heuristic: the distance between the "
+        "operands of the i-th gate is weighted by this factor to the power i. "
+        "Lower values favor the nearest gates.",
+        "0.8",
+        0.0, 1.0
     );
 
     options.add_int(
@@ -383,6 +455,86 @@ MapQubitsPass::MapQubitsPass(
         false
     );
 
+    options.add_bool(
+        "write_statistics_json",
+        "Whether to write the mapper's internal counters (alternatives "
+        "generated and scored, recursion nodes visited, Past copies) and the "
+        "time spent in each mapping phase to <output_prefix>_statistics.json. "
+        "The same information is always added to the statistics report.",
+        false
+    );
+
+    //========================================================================//
+    // Options for multi-trial mapping                                        //
+    //========================================================================//
+
+    options.add_int(
+        "num_trials",
+        "The number of independent mapping trials to run for each kernel. When "
+        "more than one, the trials are run concurrently (limited by the "
+        "`num_threads` global option) on copies of the kernel, each with its "
+        "own random seed, and the result selected by `trial_selection` is "
+        "kept. The seeds and results of all trials are added to the statistics "
+        "report. Trials only differ when randomness is involved; if neither "
+        "`tie_break_method` nor `path_selection_mode` is `random`, all trials "
+        "but the first use random tie-breaking.",
+        "1", 1, 1024
+    );
+
+    options.add_enum(
+        "trial_selection",
+        "Controls which trial result is kept when `num_trials` is more than "
+        "one. `swaps` keeps the result with the fewest added swaps (including "
+        "moves), `depth` keeps the result with the shortest schedule. The "
+        "other metric is used to break ties, and after that the trial with "
+        "the lowest index wins.",
+        "swaps",
+        {"swaps", "depth"}
+    );
+
+    options.add_int(
+        "trial_seed",
+        "Seed for the random number generator used for random tie-breaking "
+        "and path selection, or 0 to seed based on the current time. The "
+        "generator is seeded once for the program; when kernels are mapped "
+        "sequentially, its state carries over from one kernel to the next. "
+        "When `num_trials` is more than 1, trial i of each kernel is instead "
+        "seeded with this value plus i. To reproduce the "
+        "result of a trial, set this option to the seed reported for it in "
+        "the statistics report (along with the reported heuristic and "
+        "tie-breaking method) and `num_trials` to 1.",
+        "0", 0, utils::MAX
+    );
+
+    options.add_bool(
+        "vary_trial_heuristic",
+        "When set, trial i uses the i-th routing heuristic after the "
+        "configured one, cycling through `base`, `baserc`, `minextend`, "
+        "`minextendrc`, and `lookahead`, rather than all trials using the "
+        "configured heuristic. Ignored for the `maxfidelity` heuristic.",
+        false
+    );
+
+    //========================================================================//
+    // Options for kernel-level parallelism                                   //
+    //========================================================================//
+
+    options.add_bool(
+        "parallel_kernels",
+        "When set, the kernels of the program are mapped concurrently, limited "
+        "by the `num_threads` global option. This is possible because every "
+        "kernel starts from the same fixed qubit mapping, i.e. the program's "
+        "initial mapping; the mapping at the end of a kernel is not carried "
+        "over to the next. The statistics report is still generated in kernel "
+        "order. Note however that each kernel then starts from the initial "
+        "state of the random number generator, rather than continuing from "
+        "the state the previous kernel left it in, so when random "
+        "tie-breaking or path selection is used (and `num_trials` is 1), the "
+        "result may differ from that of sequential mapping with the same "
+        "`trial_seed`.",
+        false
+    );
+
 }
 
 /**
@@ -405,6 +557,10 @@ pmgr::pass_types::NodeType MapQubitsPass::on_construct(
     parsed_options->assume_prep_only_initializes = options["assume_prep_only_initializes"].as_bool();
     parsed_options->enable_mip_placer = options["enable_mip_placer"].as_bool();
     parsed_options->mip_horizon = options["mip_horizon"].as_uint();
+    parsed_options->enable_graph_placer = options["enable_graph_placer"].as_bool();
+    parsed_options->graph_placer_horizon = options["graph_placer_horizon"].as_uint();
+    parsed_options->graph_placer_refinement_passes = options["graph_placer_refinement_passes"].as_uint();
+    parsed_options->bidirectional_passes = options["bidirectional_passes"].as_uint();
 
     auto route_heuristic = options["route_heuristic"].as_str();
     if (route_heuristic == "base") {
@@ -417,9 +573,13 @@ pmgr::pass_types::NodeType MapQubitsPass::on_construct(
         parsed_options->heuristic = detail::Heuristic::MIN_EXTEND_RC;
     } else if (route_heuristic == "maxfidelity") {
         parsed_options->heuristic = detail::Heuristic::MAX_FIDELITY;
+    } else if (route_heuristic == "lookahead") {
+        parsed_options->heuristic = detail::Heuristic::LOOKAHEAD;
     } else {
         QL_ASSERT(false);
     }
+    parsed_options->lookahead_window = options["lookahead_window"].as_uint();
+    parsed_options->lookahead_decay = options["lookahead_decay"].as_real();
 
     parsed_options->max_alters = options["max_alternative_routes"].as_uint();
 
@@ -498,6 +658,17 @@ pmgr::pass_types::NodeType MapQubitsPass::on_construct(
     parsed_options->commute_single_qubit = options["commute_single_qubit"].as_bool();
     parsed_options->enable_criticality = options["scheduler_heuristic"].as_str() == "path_length";
     parsed_options->write_dot_graphs = options["write_dot_graphs"].as_bool();
+    parsed_options->write_statistics_json = options["write_statistics_json"].as_bool();
+
+    parsed_options->num_trials = options["num_trials"].as_uint();
+    if (options["trial_selection"].as_str() == "depth") {
+        parsed_options->trial_selection = detail::TrialSelection::DEPTH;
+    } else {
+        parsed_options->trial_selection = detail::TrialSelection::SWAPS;
+    }
+    parsed_options->trial_seed = options["trial_seed"].as_uint();
+    parsed_options->vary_trial_heuristic = options["vary_trial_heuristic"].as_bool();
+    parsed_options->parallel_kernels = options["parallel_kernels"].as_bool();
 
     return pmgr::pass_types::NodeType::NORMAL;
 }
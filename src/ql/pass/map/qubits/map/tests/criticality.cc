@@ -0,0 +1,97 @@
+#include <algorithm>
+
+#include "ql/ir/compat/compat.h"
+#include "../detail/mapper.h"
+
+using namespace ql;
+using namespace ql::pass::map::qubits::map::detail;
+
+/**
+ * Returns the gates in the given list as a vector, for easy comparison.
+ */
+static utils::Vec<ir::compat::GateRef> to_vec(const utils::List<ir::compat::GateRef> &gates) {
+    return utils::Vec<ir::compat::GateRef>(gates.begin(), gates.end());
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+
+    // Three independent chains of single-qubit gates of the same duration: a
+    // long one on qubit 0, a short one on qubit 1, and one in between on
+    // qubit 2. The first gate of each chain is available from the start.
+    auto kernel = utils::make<ir::compat::Kernel>("chains", plat, 7, 32, 10);
+    kernel->x(1);
+    kernel->x(2);
+    kernel->x(0);
+    kernel->x(2);
+    kernel->x(0);
+    kernel->x(0);
+    auto first_b = kernel->gates[0];
+    auto first_c = kernel->gates[1];
+    auto first_a = kernel->gates[2];
+    auto duration = (first_a->duration + plat->cycle_time - 1) / plat->cycle_time;
+    QL_ASSERT(duration > 0);
+
+    utils::Ptr<Options> options;
+    options.emplace();
+    options->enable_criticality = true;
+
+    Past past;
+    past.initialize(kernel, options.as_const());
+    past.import_mapping(com::map::QubitMapping(7, true));
+
+    utils::Ptr<Scheduler> sched;
+    sched.emplace();
+    Future future;
+    future.initialize(plat, options.as_const());
+    future.set_kernel(kernel, sched);
+
+    // Take the source node, making the first gate of each chain available.
+    utils::List<ir::compat::GateRef> gates;
+    QL_ASSERT(future.get_non_quantum_gates(gates));
+    QL_ASSERT_EQ(gates.size(), 1);
+    future.completed_gate(gates.front());
+
+    // With an empty past, criticality is just the length of the rest of the
+    // chain, so the longest chain comes first.
+    auto crit_a = future.get_criticality(first_a, past);
+    auto crit_b = future.get_criticality(first_b, past);
+    auto crit_c = future.get_criticality(first_c, past);
+    QL_ASSERT_EQ(crit_a, crit_c + duration);
+    QL_ASSERT_EQ(crit_c, crit_b + duration);
+    QL_ASSERT(future.get_gates(gates, past));
+    QL_ASSERT(to_vec(gates) == utils::Vec<ir::compat::GateRef>({first_a, first_c, first_b}));
+    QL_ASSERT(future.get_most_critical(gates, past) == first_a);
+
+    // Occupy qubit 1 for a while, as swaps through it would. The gate on it
+    // now ends up at the end of the circuit, so it becomes the most critical
+    // one, while the criticality of the others doesn't change.
+    auto busy = utils::make<ir::compat::Kernel>("busy", plat, 7, 32, 10);
+    for (utils::UInt i = 0; i < 6; i++) {
+        busy->y(1);
+    }
+    auto free_before = past.get_free_cycle(1);
+    for (const auto &gate : busy->gates) {
+        past.add_and_schedule(gate);
+    }
+    auto free_after = past.get_free_cycle(1);
+    QL_ASSERT(free_after >= free_before + 6 * duration);
+    QL_ASSERT_EQ(future.get_criticality(first_b, past), crit_b + free_after - free_before);
+    QL_ASSERT_EQ(future.get_criticality(first_a, past), crit_a);
+    QL_ASSERT_EQ(future.get_criticality(first_c, past), crit_c);
+    QL_ASSERT(future.get_gates(gates, past));
+    QL_ASSERT(to_vec(gates) == utils::Vec<ir::compat::GateRef>({first_b, first_a, first_c}));
+    QL_ASSERT(future.get_most_critical(gates, past) == first_b);
+
+    // Completing a gate makes the next gate in its chain available, with the
+    // criticality of the rest of that chain.
+    auto second_a = kernel->gates[4];
+    future.completed_gate(first_a);
+    QL_ASSERT(future.get_gates(gates, past));
+    QL_ASSERT_EQ(gates.size(), 3);
+    QL_ASSERT(gates.front() == first_b);
+    QL_ASSERT(std::find(gates.begin(), gates.end(), second_a) != gates.end());
+    QL_ASSERT_EQ(future.get_criticality(second_a, past), crit_a - duration);
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "ql/ir/compat/compat.h"
+#include "../detail/mapper.h"
+
+using namespace ql;
+using namespace ql::pass::map::qubits::map::detail;
+
+/**
+ * Returns the gates in the given list as a vector, for easy comparison.
+ */
+static utils::Vec<ir::compat::GateRef> to_vec(const utils::List<ir::compat::GateRef> &gates) {
+    return utils::Vec<ir::compat::GateRef>(gates.begin(), gates.end());
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    const auto &topology = *plat->topology;
+
+    // The distances in the cc_light topology that the scores below depend on.
+    QL_ASSERT_EQ(topology.get_distance(2, 4), 4);
+    QL_ASSERT_EQ(topology.get_distance(0, 3), 1);
+    QL_ASSERT_EQ(topology.get_distance(0, 6), 2);
+    QL_ASSERT_EQ(topology.get_distance(5, 1), 2);
+
+    auto kernel = utils::make<ir::compat::Kernel>("lookahead", plat, 7, 32, 10);
+    kernel->cz(0, 6);
+    kernel->cz(2, 4);
+    kernel->x(1);
+    kernel->cz(0, 3);
+    kernel->cnot(5, 1);
+    auto g0 = kernel->gates[0];
+    auto g1 = kernel->gates[1];
+    auto g2 = kernel->gates[3];
+    auto g3 = kernel->gates[4];
+
+    utils::Ptr<Options> options;
+    options.emplace();
+    options->heuristic = Heuristic::LOOKAHEAD;
+    options->lookahead_mode = LookaheadMode::DISABLED;
+    options->lookahead_decay = 0.5;
+
+    // The lookahead window lists the unmapped two-qubit gates in circuit
+    // order, skipping the gate being routed and single-qubit gates.
+    Future future;
+    future.initialize(plat, options.as_const());
+    future.set_kernel(kernel, {});
+    utils::List<ir::compat::GateRef> window;
+    future.get_lookahead_gates(3, g0, window);
+    QL_ASSERT(to_vec(window) == utils::Vec<ir::compat::GateRef>({g1, g2, g3}));
+    future.get_lookahead_gates(2, g0, window);
+    QL_ASSERT(to_vec(window) == utils::Vec<ir::compat::GateRef>({g1, g2}));
+    future.completed_gate(g0);
+    future.completed_gate(g1);
+    future.get_lookahead_gates(3, {}, window);
+    QL_ASSERT(to_vec(window) == utils::Vec<ir::compat::GateRef>({g2, g3}));
+
+    // Score two alternatives for routing cz(0, 6) from the one-to-one
+    // mapping against the window of the remaining three two-qubit gates.
+    // Swapping 0 and 3 brings the operands of cz(0, 3) together, while
+    // swapping 6 and 3 moves them apart.
+    Past past;
+    past.initialize(kernel, options.as_const());
+    com::map::QubitMapping v2r(7, true);
+    past.import_mapping(v2r);
+    future.set_kernel(kernel, {});
+    future.get_lookahead_gates(3, g0, window);
+
+    Alter swap_source;
+    swap_source.initialize(kernel, options.as_const());
+    swap_source.target_gate = g0;
+    swap_source.from_source = {0, 3};
+    swap_source.from_target = {6};
+    QL_ASSERT_EQ(swap_source.get_lookahead_score(past, window), 4.0 + 0.5 * 1 + 0.25 * 2);
+
+    Alter swap_target;
+    swap_target.initialize(kernel, options.as_const());
+    swap_target.target_gate = g0;
+    swap_target.from_source = {0};
+    swap_target.from_target = {6, 3};
+    QL_ASSERT_EQ(swap_target.get_lookahead_score(past, window), 4.0 + 0.5 * 2 + 0.25 * 2);
+
+    // Gates with operands that aren't mapped yet don't contribute.
+    v2r[5] = com::map::UNDEFINED_QUBIT;
+    past.import_mapping(v2r);
+    QL_ASSERT_EQ(swap_source.get_lookahead_score(past, window), 4.0 + 0.5 * 1);
+
+    // Other heuristics don't maintain the window.
+    options->heuristic = Heuristic::BASE;
+    future.set_kernel(kernel, {});
+    future.get_lookahead_gates(3, g0, window);
+    QL_ASSERT(window.empty());
+
+    // Mapping with the lookahead heuristic makes all two-qubit gates act on
+    // neighboring qubits.
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    program->add(kernel);
+    options->heuristic = Heuristic::LOOKAHEAD;
+    options->lookahead_mode = LookaheadMode::NO_ROUTING_FIRST;
+    Mapper().map(program, options.as_const());
+    for (const auto &gate : program->kernels[0]->gates) {
+        if (gate->operands.size() == 2) {
+            QL_ASSERT_EQ(topology.get_distance(gate->operands[0], gate->operands[1]), 1);
+        }
+    }
+
+    return 0;
+}
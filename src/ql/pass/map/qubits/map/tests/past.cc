@@ -0,0 +1,95 @@
+#include "ql/ir/compat/compat.h"
+#include "../detail/options.h"
+#include "../detail/free_cycle.h"
+#include "../detail/past.h"
+
+using namespace ql;
+using namespace ql::pass::map::qubits::map::detail;
+
+/**
+ * Schedules the given gates the way Past::schedule() did before it used
+ * resource state checkpoints, i.e. by trying all waiting gates on a copy of
+ * the FreeCycle map for every scheduled gate, and returns the cycle assigned to
+ * each gate.
+ */
+static utils::Map<ir::compat::GateRef, utils::UInt> schedule_with_copies(
+    const ir::compat::PlatformRef &platform,
+    const OptionsRef &options,
+    const ir::compat::GateRefs &gates
+) {
+    FreeCycle fc;
+    fc.initialize(platform, options);
+    utils::List<ir::compat::GateRef> waiting_gates;
+    for (const auto &gate : gates) {
+        waiting_gates.push_back(gate);
+    }
+    utils::Map<ir::compat::GateRef, utils::UInt> cycles;
+    while (!waiting_gates.empty()) {
+        utils::UInt start_cycle = ir::compat::MAX_CYCLE;
+        utils::List<ir::compat::GateRef>::iterator gate_it;
+        FreeCycle try_fc = fc;
+        for (auto try_gate_it = waiting_gates.begin(); try_gate_it != waiting_gates.end(); ++try_gate_it) {
+            utils::UInt try_start_cycle = try_fc.get_start_cycle(*try_gate_it);
+            try_fc.add(*try_gate_it, try_start_cycle);
+            if (try_start_cycle < start_cycle) {
+                start_cycle = try_start_cycle;
+                gate_it = try_gate_it;
+            }
+        }
+        fc.add(*gate_it, start_cycle);
+        cycles.set(*gate_it) = start_cycle;
+        waiting_gates.erase(gate_it);
+    }
+    return cycles;
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+
+    // A circuit with conflicts on the qubits, the qwgs (x and y on qubits 0
+    // and 1 or 5 and 6), the measurement units, and the edges.
+    auto circuit = utils::make<ir::compat::Kernel>("circuit", plat, 7, 32, 10);
+    circuit->x(0);
+    circuit->y(1);
+    circuit->x(5);
+    circuit->cz(2, 0);
+    circuit->y(6);
+    circuit->cz(0, 3);
+    circuit->measure(4);
+    circuit->cz(3, 1);
+    circuit->x(1);
+    circuit->measure(0);
+    circuit->y(5);
+    circuit->measure(1);
+    circuit->cz(6, 4);
+    circuit->x(2);
+    circuit->measure(3);
+
+    for (auto heuristic : {Heuristic::BASE, Heuristic::BASE_RC}) {
+        utils::Ptr<Options> options;
+        options.emplace();
+        options->heuristic = heuristic;
+
+        // Schedule the circuit using Past.
+        auto kernel = utils::make<ir::compat::Kernel>("past", plat, 7, 32, 10);
+        Past past;
+        past.initialize(kernel, options.as_const());
+        for (const auto &gate : circuit->gates) {
+            past.add(gate);
+        }
+        past.schedule();
+
+        // The result must be the same as when scheduling with copies.
+        auto expected = schedule_with_copies(plat, options.as_const(), circuit->gates);
+        QL_ASSERT_EQ(past.gates.size(), circuit->gates.size());
+        utils::UInt previous_cycle = 0;
+        for (const auto &gate : past.gates) {
+            QL_ASSERT_EQ(gate->cycle, expected.at(gate));
+            QL_ASSERT(gate->cycle >= previous_cycle);
+            previous_cycle = gate->cycle;
+        }
+
+    }
+
+    return 0;
+}
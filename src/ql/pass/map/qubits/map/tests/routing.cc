@@ -0,0 +1,114 @@
+#include "ql/ir/compat/compat.h"
+#include "ql/pass/ana/statistics/annotations.h"
+#include "../detail/mapper.h"
+
+using namespace ql;
+using namespace ql::pass::map::qubits::map::detail;
+
+/**
+ * Builds a program of two kernels: one that only needs routing because of the
+ * one-to-one initial placement, and one with conflicting interactions.
+ */
+static ir::compat::ProgramRef make_program(const ir::compat::PlatformRef &plat) {
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+
+    auto kernel = utils::make<ir::compat::Kernel>("pair", plat, 7, 32, 10);
+    for (utils::UInt i = 0; i < 3; i++) {
+        kernel->x(0);
+        kernel->cz(0, 6);
+        kernel->y(6);
+    }
+    program->add(kernel);
+
+    kernel = utils::make<ir::compat::Kernel>("mixed", plat, 7, 32, 10);
+    for (utils::UInt i = 0; i < 4; i++) {
+        kernel->cz(0, 6);
+        kernel->cnot(2, 4);
+        kernel->cz(1, 5);
+        kernel->cz(i, (i + 3) % 7);
+    }
+    program->add(kernel);
+
+    return program;
+}
+
+/**
+ * Returns the number following the given text in the first statistics line of
+ * the given kernel that contains it.
+ */
+static utils::UInt get_statistic(const ir::compat::KernelRef &kernel, const utils::Str &text) {
+    using pass::ana::statistics::AdditionalStats;
+    for (const auto &line : kernel->get_annotation<AdditionalStats>().stats) {
+        auto pos = line.find(text);
+        if (pos != utils::Str::npos) {
+            auto start = pos + text.size();
+            auto end = line.find_first_not_of("0123456789", start);
+            return utils::parse_uint(line.substr(start, end - start));
+        }
+    }
+    QL_ICE("statistic '" << text << "' not found for kernel " << kernel->name);
+}
+
+/**
+ * Maps a fresh copy of the test program with deterministic tie-breaking and
+ * the given number of bidirectional routing passes.
+ */
+static ir::compat::ProgramRef map_program(
+    const ir::compat::PlatformRef &plat,
+    utils::UInt bidirectional_passes
+) {
+    utils::Ptr<Options> options;
+    options.emplace();
+    options->tie_break_method = TieBreakMethod::FIRST;
+    options->bidirectional_passes = bidirectional_passes;
+    auto program = make_program(plat);
+    Mapper().map(program, options.as_const());
+    return program;
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    const auto &topology = *plat->topology;
+
+    auto routed = map_program(plat, 0);
+    auto refined = map_program(plat, 3);
+    QL_ASSERT_EQ(routed->kernels.size(), 2);
+    QL_ASSERT_EQ(refined->kernels.size(), 2);
+
+    // After routing, all two-qubit gates act on neighboring qubits.
+    for (const auto &program : {routed, refined}) {
+        for (const auto &kernel : program->kernels) {
+            for (const auto &gate : kernel->gates) {
+                if (gate->operands.size() == 2) {
+                    QL_ASSERT_EQ(topology.get_distance(gate->operands[0], gate->operands[1]), 1);
+                }
+            }
+        }
+    }
+
+    // Without refinement, no improvements are reported.
+    for (const auto &kernel : routed->kernels) {
+        QL_ASSERT_EQ(get_statistic(kernel, "improvements: "), 0);
+    }
+
+    // Qubits 0 and 6 are not neighbors, so the one-to-one placement needs a
+    // swap. Routing backward from the mapping at the end of the first kernel
+    // yields a placement in which they are, so refinement must find it.
+    QL_ASSERT(get_statistic(routed->kernels[0], "swaps added: ") > 0);
+    QL_ASSERT_EQ(get_statistic(refined->kernels[0], "swaps added: "), 0);
+    QL_ASSERT(get_statistic(refined->kernels[0], "improvements: ") > 0);
+
+    // Refinement never makes the result worse, and only changes it when it
+    // found an improvement.
+    for (utils::UInt k = 0; k < 2; k++) {
+        auto routed_swaps = get_statistic(routed->kernels[k], "swaps added: ");
+        auto refined_swaps = get_statistic(refined->kernels[k], "swaps added: ");
+        if (get_statistic(refined->kernels[k], "improvements: ")) {
+            QL_ASSERT(refined_swaps < routed_swaps);
+        } else {
+            QL_ASSERT_EQ(refined_swaps, routed_swaps);
+        }
+    }
+
+    return 0;
+}
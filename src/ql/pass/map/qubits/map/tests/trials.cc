@@ -0,0 +1,83 @@
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/describe.h"
+#include "ql/com/options.h"
+#include "ql/pmgr/manager.h"
+
+using namespace ql;
+
+/**
+ * Converts the given program to the new IR, maps it with random tie-breaking
+ * and path selection using the given number of threads, and returns the
+ * description and cycle of each resulting statement, block by block.
+ */
+static utils::Vec<utils::Vec<utils::Str>> map_program(
+    const ir::compat::ProgramRef &program,
+    utils::UInt num_threads,
+    utils::UInt num_trials,
+    utils::Bool parallel_kernels
+) {
+    com::options::global["num_threads"] = utils::to_string(num_threads);
+    auto ir = ir::convert_old_to_new(program);
+    pmgr::Manager manager;
+    manager.append_pass(
+        "map.qubits.Map",
+        "mapper",
+        {
+            {"tie_break_method", "random"},
+            {"path_selection_mode", "random"},
+            {"num_trials", utils::to_string(num_trials)},
+            {"trial_seed", "1234"},
+            {"parallel_kernels", parallel_kernels ? "yes" : "no"}
+        }
+    );
+    manager.compile(ir);
+
+    utils::Vec<utils::Vec<utils::Str>> result;
+    for (const auto &block : ir->program->blocks) {
+        result.emplace_back();
+        for (const auto &statement : block->statements) {
+            result.back().push_back(
+                utils::to_string(statement->cycle) + ": " + ir::describe(statement)
+            );
+        }
+    }
+    return result;
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+
+    // A program of which every kernel needs routing, with several equally
+    // good routes for most two-qubit gates. The trials of a kernel operate on
+    // shallow copies of it, so they share its input gates.
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    for (utils::UInt k = 0; k < 4; k++) {
+        auto kernel = utils::make<ir::compat::Kernel>(
+            "kernel_" + utils::to_string(k), plat, 7, 32, 10
+        );
+        kernel->x(k);
+        kernel->cz(0, 6);
+        kernel->cz(2, 4);
+        kernel->cnot(k % 7, (k + 4) % 7);
+        kernel->cz(1, 5);
+        kernel->measure(k);
+        program->add(kernel);
+    }
+
+    // Mapping with multiple trials is deterministic for a fixed seed,
+    // regardless of the number of threads used for the trials, and whether
+    // the kernels are mapped sequentially or concurrently.
+    auto serial = map_program(program, 1, 4, false);
+    QL_ASSERT_EQ(serial.size(), 4);
+    QL_ASSERT(serial == map_program(program, 1, 4, false));
+    QL_ASSERT(serial == map_program(program, 4, 4, false));
+    QL_ASSERT(serial == map_program(program, 4, 4, true));
+
+    // Single-trial mapping carries the random number generator over from
+    // kernel to kernel, so only sequential mapping is compared here.
+    auto single = map_program(program, 1, 1, false);
+    QL_ASSERT(single == map_program(program, 4, 1, false));
+
+    return 0;
+}
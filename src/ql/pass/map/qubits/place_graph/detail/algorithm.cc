@@ -0,0 +1,408 @@
+/** \file
+ * Scalable interaction-graph-based initial placement engine.
+ */
+
+#include "algorithm.h"
+
+#include <chrono>
+#include <queue>
+#include <algorithm>
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace place_graph {
+namespace detail {
+
+using namespace utils;
+using com::map::UNDEFINED_QUBIT;
+
+/**
+ * String conversion for placement results.
+ */
+std::ostream &operator<<(std::ostream &os, Result result) {
+    switch (result) {
+        case Result::ANY:       os << "any";        break;
+        case Result::NEW_MAP:   os << "newmap";     break;
+        case Result::FAILED:    os << "failed";     break;
+    }
+    return os;
+}
+
+/**
+ * Builds the interaction graph for the given kernel.
+ */
+void Algorithm::build_graph(const ir::compat::KernelRef &kernel) {
+    graph = com::ana::InteractionGraph(virt_core.size());
+    UInt num_two_qubit_gates = 0;
+    for (const auto &gate : kernel->gates) {
+        if (gate->operands.size() != 2 || gate->type() == ir::compat::GateType::WAIT) {
+            continue;
+        }
+        if (gate->operands[0] >= virt_core.size() || gate->operands[1] >= virt_core.size()) {
+            continue;
+        }
+        if (options.horizon && num_two_qubit_gates >= options.horizon) {
+            break;
+        }
+        graph.add_interaction(gate->operands[0], gate->operands[1]);
+        num_two_qubit_gates++;
+    }
+}
+
+/**
+ * Assigns the interacting virtual qubits to cores by greedy graph growing.
+ * Returns false if they don't fit.
+ */
+Bool Algorithm::partition() {
+    const auto &topology = *platform->topology;
+    UInt num_virt = virt_core.size();
+
+    // Determine the capacity of each core.
+    Vec<UInt> capacity(topology.get_num_cores(), 0);
+    for (UInt r = 0; r < num_real; r++) {
+        capacity[topology.get_core_index(r)]++;
+    }
+
+    // List the interacting qubits by decreasing weighted degree. These are
+    // used to seed each core and each disconnected component of the graph.
+    Vec<UInt> seeds;
+    Vec<UInt> weighted_degree(num_virt, 0);
+    for (UInt v = 0; v < num_virt; v++) {
+        weighted_degree[v] = graph.get_weighted_degree(v);
+        if (weighted_degree[v]) {
+            seeds.push_back(v);
+        }
+    }
+    if (seeds.size() > num_real) {
+        return false;
+    }
+    std::stable_sort(seeds.begin(), seeds.end(), [&weighted_degree](UInt a, UInt b) {
+        return weighted_degree[a] > weighted_degree[b];
+    });
+
+    // Grow each core in turn from the strongest-interacting unassigned qubit,
+    // repeatedly adding the unassigned qubit that interacts most with the
+    // qubits already in the core. The priority queue uses lazy deletion;
+    // entries with a gain that doesn't match gain[] are stale. Ties are broken
+    // in favor of the lowest qubit index.
+    Vec<UInt> gain(num_virt, 0);
+    Vec<UInt> touched;
+    using Queue = std::priority_queue<std::pair<UInt, UInt>>;
+    Queue queue;
+    auto push = [&queue, num_virt](UInt g, UInt v) {
+        queue.push({g, num_virt - 1 - v});
+    };
+    UInt next_seed = 0;
+    UInt num_assigned = 0;
+    for (UInt core = 0; core < capacity.size() && num_assigned < seeds.size(); core++) {
+        for (UInt remaining = capacity[core]; remaining > 0; remaining--) {
+
+            // Select the next qubit for this core.
+            UInt v = UNDEFINED_QUBIT;
+            while (!queue.empty()) {
+                auto entry = queue.top();
+                queue.pop();
+                auto candidate = num_virt - 1 - entry.second;
+                if (virt_core[candidate] == UNDEFINED_QUBIT && gain[candidate] == entry.first) {
+                    v = candidate;
+                    break;
+                }
+            }
+            if (v == UNDEFINED_QUBIT) {
+                while (next_seed < seeds.size() && virt_core[seeds[next_seed]] != UNDEFINED_QUBIT) {
+                    next_seed++;
+                }
+                if (next_seed >= seeds.size()) {
+                    break;
+                }
+                v = seeds[next_seed];
+            }
+
+            // Assign it and update the gains of its unassigned partners.
+            virt_core[v] = core;
+            order.push_back(v);
+            num_assigned++;
+            for (const auto &it : graph.get_neighbors(v)) {
+                if (virt_core[it.first] == UNDEFINED_QUBIT) {
+                    if (!gain[it.first]) {
+                        touched.push_back(it.first);
+                    }
+                    gain[it.first] += it.second;
+                    push(gain[it.first], it.first);
+                }
+            }
+
+        }
+
+        // Gains are relative to the current core, so reset them.
+        for (auto v : touched) {
+            gain[v] = 0;
+        }
+        touched.clear();
+        queue = Queue();
+
+    }
+
+    return num_assigned == seeds.size();
+}
+
+/**
+ * Places the qubits that were assigned to cores in assignment order.
+ */
+void Algorithm::place() {
+    const auto &topology = *platform->topology;
+
+    // For each core, list its locations by decreasing connectivity. The first
+    // free location in this list is used for qubits without placed partners.
+    Vec<Vec<UInt>> core_locations(topology.get_num_cores());
+    Vec<UInt> degree(num_real, 0);
+    for (UInt r = 0; r < num_real; r++) {
+        core_locations[topology.get_core_index(r)].push_back(r);
+        degree[r] = topology.get_neighbors(r).size();
+    }
+    for (auto &locations : core_locations) {
+        std::stable_sort(locations.begin(), locations.end(), [&degree](UInt a, UInt b) {
+            return degree[a] > degree[b];
+        });
+    }
+    Vec<UInt> next_seed_location(core_locations.size(), 0);
+
+    // Visitation stamps for the breadth-first searches, so the visited set
+    // doesn't need to be cleared for each search.
+    Vec<UInt> visited(num_real, 0);
+    UInt stamp = 0;
+
+    for (auto v : order) {
+        auto core = virt_core[v];
+
+        // Find the placed partner that v interacts with most.
+        UInt anchor = UNDEFINED_QUBIT;
+        UInt anchor_weight = 0;
+        for (const auto &it : graph.get_neighbors(v)) {
+            if (virt_to_real[it.first] != UNDEFINED_QUBIT && it.second > anchor_weight) {
+                anchor = virt_to_real[it.first];
+                anchor_weight = it.second;
+            }
+        }
+
+        // Collect the free locations in our core nearest to that partner.
+        Vec<UInt> candidates;
+        if (anchor != UNDEFINED_QUBIT) {
+            stamp++;
+            std::queue<UInt> bfs;
+            bfs.push(anchor);
+            visited[anchor] = stamp;
+            while (!bfs.empty() && candidates.size() < options.max_candidates) {
+                auto r = bfs.front();
+                bfs.pop();
+                if (real_to_virt[r] == UNDEFINED_QUBIT && topology.get_core_index(r) == core) {
+                    candidates.push_back(r);
+                }
+                for (auto n : topology.get_neighbors(r)) {
+                    if (visited[n] != stamp) {
+                        visited[n] = stamp;
+                        bfs.push(n);
+                    }
+                }
+            }
+        }
+
+        // Without placed partners (or reachable free locations), use the
+        // most-connected free location in the core.
+        if (candidates.empty()) {
+            auto &locations = core_locations[core];
+            auto &next = next_seed_location[core];
+            while (next < locations.size() && real_to_virt[locations[next]] != UNDEFINED_QUBIT) {
+                next++;
+            }
+            QL_ASSERT(next < locations.size());
+            candidates.push_back(locations[next]);
+        }
+
+        // Pick the candidate with the lowest cost.
+        UInt best = candidates.front();
+        UInt best_cost = get_cost(v, best);
+        for (UInt i = 1; i < candidates.size(); i++) {
+            auto cost = get_cost(v, candidates[i]);
+            if (cost < best_cost) {
+                best = candidates[i];
+                best_cost = cost;
+            }
+        }
+        virt_to_real[v] = best;
+        real_to_virt[best] = v;
+
+    }
+}
+
+/**
+ * Returns the weighted distance between virtual qubit v at location r and its
+ * placed interaction partners, ignoring virtual qubit except.
+ */
+UInt Algorithm::get_cost(UInt v, UInt r, UInt except) const {
+    UInt cost = 0;
+    for (const auto &it : graph.get_neighbors(v)) {
+        auto partner = virt_to_real[it.first];
+        if (it.first != except && partner != UNDEFINED_QUBIT) {
+            cost += it.second * platform->topology->get_distance(r, partner);
+        }
+    }
+    return cost;
+}
+
+/**
+ * Returns the total weighted distance of the current placement.
+ */
+UInt Algorithm::get_total_cost() const {
+    UInt cost = 0;
+    for (auto v : order) {
+        for (const auto &it : graph.get_neighbors(v)) {
+            if (it.first > v && virt_to_real[it.first] != UNDEFINED_QUBIT) {
+                cost += it.second * platform->topology->get_distance(
+                    virt_to_real[v], virt_to_real[it.first]
+                );
+            }
+        }
+    }
+    return cost;
+}
+
+/**
+ * Greedily refines the placement by moving qubits to neighboring locations in
+ * the same core.
+ */
+void Algorithm::refine() {
+    const auto &topology = *platform->topology;
+    for (UInt pass = 0; pass < options.max_refinement_passes; pass++) {
+        Bool improved = false;
+        for (auto v : order) {
+            auto r = virt_to_real[v];
+            for (auto n : topology.get_neighbors(r)) {
+                if (topology.get_core_index(n) != topology.get_core_index(r)) {
+                    continue;
+                }
+
+                // Compute the change in cost for moving v to n, swapping with
+                // the qubit at n if there is one. The distance between v and u
+                // themselves doesn't change, so it is left out.
+                auto u = real_to_virt[n];
+                auto before = (Int)get_cost(v, r, u);
+                auto after = (Int)get_cost(v, n, u);
+                if (u != UNDEFINED_QUBIT) {
+                    before += (Int)get_cost(u, n, v);
+                    after += (Int)get_cost(u, r, v);
+                }
+                if (after >= before) {
+                    continue;
+                }
+
+                // Apply the move.
+                virt_to_real[v] = n;
+                real_to_virt[n] = v;
+                real_to_virt[r] = u;
+                if (u != UNDEFINED_QUBIT) {
+                    virt_to_real[u] = r;
+                }
+                improved = true;
+                break;
+
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
+
+/**
+ * Runs the algorithm for the given kernel, putting the resulting placement in
+ * the given qubit map if a new mapping was found.
+ */
+Result Algorithm::run(
+    const ir::compat::KernelRef &kernel,
+    const Options &opt,
+    com::map::QubitMapping &v2r
+) {
+    auto start = std::chrono::steady_clock::now();
+    options = opt;
+    platform = kernel->platform;
+    num_real = platform->qubit_count;
+    UInt num_virt = v2r.get_virt_to_real().size();
+    virt_core.assign(num_virt, UNDEFINED_QUBIT);
+    virt_to_real.assign(num_virt, UNDEFINED_QUBIT);
+    real_to_virt.assign(num_real, UNDEFINED_QUBIT);
+    order.clear();
+
+    // Run the stages.
+    build_graph(kernel);
+    Result result;
+    if (!graph.get_num_edges()) {
+        result = Result::ANY;
+    } else if (!partition()) {
+        result = Result::FAILED;
+    } else {
+        place();
+        initial_cost = get_total_cost();
+        refine();
+        final_cost = get_total_cost();
+        result = Result::NEW_MAP;
+    }
+
+    // Copy the placement into the qubit map. Virtual qubits that don't take
+    // part in two-qubit gates are mapped to the remaining free locations only
+    // when map_all is set, preferring the location with the same index to
+    // stay close to a one-to-one mapping.
+    if (result == Result::NEW_MAP) {
+        UInt next_free = 0;
+        for (UInt v = 0; v < num_virt; v++) {
+            if (virt_to_real[v] == UNDEFINED_QUBIT && options.map_all) {
+                UInt r = v;
+                if (r >= num_real || real_to_virt[r] != UNDEFINED_QUBIT) {
+                    while (next_free < num_real && real_to_virt[next_free] != UNDEFINED_QUBIT) {
+                        next_free++;
+                    }
+                    QL_ASSERT(next_free < num_real);
+                    r = next_free;
+                }
+                virt_to_real[v] = r;
+                real_to_virt[r] = v;
+            }
+            v2r[v] = virt_to_real[v];
+        }
+    }
+
+    time_taken = std::chrono::duration_cast<std::chrono::duration<Real>>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+    return result;
+}
+
+/**
+ * Returns the total weighted distance before refinement.
+ */
+UInt Algorithm::get_initial_cost() const {
+    return initial_cost;
+}
+
+/**
+ * Returns the total weighted distance of the final placement.
+ */
+UInt Algorithm::get_final_cost() const {
+    return final_cost;
+}
+
+/**
+ * Returns the total time taken by run() in seconds.
+ */
+Real Algorithm::get_time_taken() const {
+    return time_taken;
+}
+
+} // namespace detail
+} // namespace place_graph
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,238 @@
+/** \file
+ * Scalable interaction-graph-based initial placement engine.
+ *
+ * Unlike the MIP-based placer, this does not try to find an optimal placement.
+ * Instead, it quickly finds a placement that keeps qubits that interact a lot
+ * close together, such that the router has less work to do. This works in
+ * three stages:
+ *
+ *  - the virtual qubits that take part in two-qubit gates are partitioned over
+ *    the cores of the platform (if there is more than one) by greedy graph
+ *    growing: starting from the unassigned qubit with the highest weighted
+ *    degree in the interaction graph, qubits are repeatedly added to the
+ *    current core by picking the unassigned qubit with the strongest
+ *    interaction with the qubits already in it, until the core is full;
+ *  - the qubits are placed in the order in which they were assigned, each
+ *    one at the free location in its core that minimizes the weighted distance
+ *    to its already-placed interaction partners, only considering the free
+ *    locations nearest to its strongest placed partner (or, if it has none, the
+ *    most-connected free location in the core); and
+ *  - the placement is refined by repeatedly moving qubits to a neighboring
+ *    location within the same core, swapping with the qubit there (if any),
+ *    whenever this reduces the total weighted distance, until no improving
+ *    move remains or the maximum number of refinement passes is reached.
+ *
+ * The total weighted distance is the sum over all interacting qubit pairs of
+ * the number of two-qubit gates between them times the distance between their
+ * locations. All stages take time roughly linear in the size of the
+ * interaction graph, save for the distance lookups, so this works for
+ * thousands of qubits.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/ir/compat/compat.h"
+#include "ql/com/map/qubit_mapping.h"
+#include "ql/com/ana/interaction_graph.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace place_graph {
+namespace detail {
+
+/**
+ * Options structure for configuring the graph-based placement algorithm.
+ */
+struct Options {
+
+    /**
+     * The placement algorithm will only consider the first horizon two-qubit
+     * gates of a kernel. 0 means that all gates should be considered.
+     */
+    utils::UInt horizon = 0;
+
+    /**
+     * Maximum number of refinement passes over all qubits.
+     */
+    utils::UInt max_refinement_passes = 10;
+
+    /**
+     * Maximum number of free candidate locations considered when placing a
+     * qubit next to its already-placed interaction partners.
+     */
+    utils::UInt max_candidates = 16;
+
+    /**
+     * When set, any virtual qubits not used in two-qubit gates will also be
+     * mapped to real qubits.
+     */
+    utils::Bool map_all = false;
+
+};
+
+/**
+ * Enumeration of the possible algorithm outcomes.
+ */
+enum class Result {
+
+    /**
+     * Any mapping will do, because there are no two-qubit gates in the circuit.
+     */
+    ANY,
+
+    /**
+     * A new mapping was computed.
+     */
+    NEW_MAP,
+
+    /**
+     * The interacting qubits don't fit on the platform.
+     */
+    FAILED
+
+};
+
+/**
+ * String conversion for placement results.
+ */
+std::ostream &operator<<(std::ostream &os, Result result);
+
+/**
+ * Interaction-graph-based initial placement algorithm.
+ */
+class Algorithm {
+private:
+
+    /**
+     * The options that we're being called with.
+     */
+    Options options;
+
+    /**
+     * Shorthand reference for the platform corresponding to the kernel.
+     */
+    ir::compat::PlatformRef platform;
+
+    /**
+     * The interaction graph of the (first horizon gates of the) kernel.
+     */
+    com::ana::InteractionGraph graph;
+
+    /**
+     * Number of real qubits.
+     */
+    utils::UInt num_real = 0;
+
+    /**
+     * The core that each virtual qubit was assigned to, or UNDEFINED_QUBIT if
+     * it wasn't.
+     */
+    utils::Vec<utils::UInt> virt_core;
+
+    /**
+     * The order in which the virtual qubits were assigned to cores.
+     */
+    utils::Vec<utils::UInt> order;
+
+    /**
+     * The location of each virtual qubit, or UNDEFINED_QUBIT if unplaced.
+     */
+    utils::Vec<utils::UInt> virt_to_real;
+
+    /**
+     * The virtual qubit at each location, or UNDEFINED_QUBIT if free.
+     */
+    utils::Vec<utils::UInt> real_to_virt;
+
+    /**
+     * Total weighted distance of the placement before refinement.
+     */
+    utils::UInt initial_cost = 0;
+
+    /**
+     * Total weighted distance of the final placement.
+     */
+    utils::UInt final_cost = 0;
+
+    /**
+     * Total time taken by run() in seconds.
+     */
+    utils::Real time_taken = 0.0;
+
+    /**
+     * Builds the interaction graph for the given kernel.
+     */
+    void build_graph(const ir::compat::KernelRef &kernel);
+
+    /**
+     * Assigns the interacting virtual qubits to cores by greedy graph growing.
+     * Returns false if they don't fit.
+     */
+    utils::Bool partition();
+
+    /**
+     * Places the qubits that were assigned to cores in assignment order.
+     */
+    void place();
+
+    /**
+     * Returns the weighted distance between virtual qubit v at location r and
+     * its placed interaction partners, ignoring virtual qubit except.
+     */
+    utils::UInt get_cost(
+        utils::UInt v,
+        utils::UInt r,
+        utils::UInt except = com::map::UNDEFINED_QUBIT
+    ) const;
+
+    /**
+     * Returns the total weighted distance of the current placement.
+     */
+    utils::UInt get_total_cost() const;
+
+    /**
+     * Greedily refines the placement by moving qubits to neighboring locations
+     * in the same core.
+     */
+    void refine();
+
+public:
+
+    /**
+     * Runs the algorithm for the given kernel, putting the resulting placement
+     * in the given qubit map if a new mapping was found.
+     */
+    Result run(
+        const ir::compat::KernelRef &kernel,
+        const Options &opt,
+        com::map::QubitMapping &v2r
+    );
+
+    /**
+     * Returns the total weighted distance before refinement.
+     */
+    utils::UInt get_initial_cost() const;
+
+    /**
+     * Returns the total weighted distance of the final placement.
+     */
+    utils::UInt get_final_cost() const;
+
+    /**
+     * Returns the total time taken by run() in seconds.
+     */
+    utils::Real get_time_taken() const;
+
+};
+
+} // namespace detail
+} // namespace place_graph
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
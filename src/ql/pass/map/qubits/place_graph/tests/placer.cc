@@ -0,0 +1,121 @@
+#include "ql/ir/compat/compat.h"
+#include "../detail/algorithm.h"
+
+using namespace ql;
+using namespace ql::pass::map::qubits::place_graph::detail;
+using com::map::UNDEFINED_QUBIT;
+
+/**
+ * Returns the total weighted distance of the given placement for the two-qubit
+ * gates of the given kernel, computed from the gate list directly.
+ */
+static utils::UInt get_cost(
+    const ir::compat::KernelRef &kernel,
+    const utils::Vec<utils::UInt> &virt_to_real
+) {
+    utils::UInt cost = 0;
+    for (const auto &gate : kernel->gates) {
+        if (gate->operands.size() == 2) {
+            cost += kernel->platform->topology->get_distance(
+                virt_to_real[gate->operands[0]],
+                virt_to_real[gate->operands[1]]
+            );
+        }
+    }
+    return cost;
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    const auto &topology = *plat->topology;
+
+    // A chain of interactions between virtual qubits 0 to 4, with the
+    // heaviest interaction between 0 and 1. Qubit 5 is only used by a
+    // single-qubit gate, and qubit 6 is not used at all.
+    auto kernel = utils::make<ir::compat::Kernel>("chain", plat, 7, 32, 10);
+    for (utils::UInt i = 0; i < 3; i++) {
+        kernel->cz(0, 1);
+    }
+    kernel->x(5);
+    kernel->cz(2, 1);
+    kernel->cz(1, 2);
+    kernel->cz(2, 3);
+    kernel->cz(4, 3);
+
+    Options options;
+    options.max_refinement_passes = 100;
+    Algorithm placer;
+    com::map::QubitMapping v2r(7);
+    QL_ASSERT_EQ(placer.run(kernel, options, v2r), Result::NEW_MAP);
+    auto virt_to_real = v2r.get_virt_to_real();
+
+    // The interacting qubits must be placed on distinct real qubits, the
+    // others must be left alone, and the strongest pair must be adjacent.
+    utils::Vec<utils::UInt> real_to_virt(plat->qubit_count, UNDEFINED_QUBIT);
+    for (utils::UInt v = 0; v < 5; v++) {
+        auto r = virt_to_real[v];
+        QL_ASSERT(r < plat->qubit_count);
+        QL_ASSERT_EQ(real_to_virt[r], UNDEFINED_QUBIT);
+        real_to_virt[r] = v;
+    }
+    QL_ASSERT_EQ(virt_to_real[5], UNDEFINED_QUBIT);
+    QL_ASSERT_EQ(virt_to_real[6], UNDEFINED_QUBIT);
+    QL_ASSERT_EQ(topology.get_distance(virt_to_real[0], virt_to_real[1]), 1);
+
+    // The reported cost must match the placement, and refinement must not
+    // have made it worse.
+    QL_ASSERT_EQ(placer.get_final_cost(), get_cost(kernel, virt_to_real));
+    QL_ASSERT(placer.get_final_cost() <= placer.get_initial_cost());
+
+    // Refinement ran to completion, so moving any qubit to a neighboring
+    // location, swapping with the qubit there if any, must not improve the
+    // cost.
+    for (utils::UInt v = 0; v < 5; v++) {
+        auto r = virt_to_real[v];
+        for (auto n : topology.get_neighbors(r)) {
+            auto moved = virt_to_real;
+            auto u = real_to_virt[n];
+            moved[v] = n;
+            if (u != UNDEFINED_QUBIT) {
+                moved[u] = r;
+            }
+            QL_ASSERT(get_cost(kernel, moved) >= placer.get_final_cost());
+        }
+    }
+
+    // With map_all, the remaining virtual qubits are mapped as well, making
+    // the mapping a permutation.
+    options.map_all = true;
+    com::map::QubitMapping v2r_all(7);
+    QL_ASSERT_EQ(placer.run(kernel, options, v2r_all), Result::NEW_MAP);
+    utils::Vec<utils::Bool> used(plat->qubit_count, false);
+    for (utils::UInt v = 0; v < 7; v++) {
+        auto r = v2r_all[v];
+        QL_ASSERT(r < plat->qubit_count);
+        QL_ASSERT(!used[r]);
+        used[r] = true;
+    }
+    options.map_all = false;
+
+    // With a horizon of one gate, only qubits 0 and 1 are placed.
+    options.horizon = 1;
+    com::map::QubitMapping v2r_horizon(7);
+    QL_ASSERT_EQ(placer.run(kernel, options, v2r_horizon), Result::NEW_MAP);
+    QL_ASSERT_EQ(topology.get_distance(v2r_horizon[0], v2r_horizon[1]), 1);
+    for (utils::UInt v = 2; v < 7; v++) {
+        QL_ASSERT_EQ(v2r_horizon[v], UNDEFINED_QUBIT);
+    }
+    options.horizon = 0;
+
+    // Without two-qubit gates any mapping will do, and the map is left alone.
+    auto single = utils::make<ir::compat::Kernel>("single", plat, 7, 32, 10);
+    single->x(0);
+    single->measure(1);
+    com::map::QubitMapping v2r_single(7, true);
+    QL_ASSERT_EQ(placer.run(single, options, v2r_single), Result::ANY);
+    for (utils::UInt v = 0; v < 7; v++) {
+        QL_ASSERT_EQ(v2r_single[v], v);
+    }
+
+    return 0;
+}
@@ -5,11 +5,14 @@
 #include "ql/pass/sch/list_schedule/list_schedule.h"
 
 #include "ql/utils/filesystem.h"
+#include "ql/utils/parallel.h"
+#include "ql/ir/ops.h"
 #include "ql/ir/old_to_new.h"
 #include "ql/com/ddg/build.h"
 #include "ql/com/ddg/ops.h"
 #include "ql/com/ddg/dot.h"
 #include "ql/com/sch/scheduler.h"
+#include "ql/com/options.h"
 #include "ql/pmgr/pass_types/base.h"
 
 namespace ql {
@@ -28,6 +31,13 @@ void ListSchedulePass::dump_docs(
     This pass analyzes the data dependencies between statements and applies
     quantum cycle numbers to them using optionally resource-constrained ASAP or
     ALAP list scheduling. All blocks in the program are scheduled independently.
+
+    If the `parallel_blocks` option is set, the top-level blocks of the
+    program are scheduled concurrently, limited by the `num_threads` global
+    option, unless dot graphs are to be written or debug logging is enabled.
+    In those cases the blocks are scheduled in program order, because the
+    uniquified block names used for the output depend on it. The resulting
+    schedule is the same either way.
     )");
 }
 
@@ -111,6 +121,16 @@ ListSchedulePass::ListSchedulePass(
         false
     );
 
+    options.add_bool(
+        "parallel_blocks",
+        "When set, the top-level blocks of the program are scheduled "
+        "concurrently, limited by the `num_threads` global option. The "
+        "resulting schedule is the same as when the blocks are scheduled "
+        "sequentially. This has no effect when dot graphs are written or "
+        "debug logging is enabled.",
+        false
+    );
+
 }
 
 /**
@@ -252,11 +272,38 @@ utils::Int ListSchedulePass::run(
     const ir::Ref &ir,
     const pmgr::pass_types::Context &context
 ) const {
+    if (ir->program.empty()) {
+        return 0;
+    }
+    const auto &blocks = ir->program->blocks;
+
+    // The top-level blocks are completely independent, so they can be
+    // scheduled concurrently if requested. The block names are only used for
+    // debug and dot output, so we only need to uniquify them (in program
+    // order) when that output is enabled.
+    auto num_threads = com::options::global["num_threads"].as_uint();
+    if (
+        context.options["parallel_blocks"].as_bool() &&
+        utils::get_num_threads(num_threads) > 1 &&
+        !QL_IS_LOG_DEBUG &&
+        !context.options["write_dot_graphs"].as_bool()
+    ) {
+
+        // Build the instruction type lookup indices before starting the
+        // threads, so they don't all wait for the first one to build them.
+        ir::build_instruction_type_indices(ir);
+
+        utils::parallel_for(blocks.size(), [&ir, &blocks, &context](utils::UInt i) {
+            utils::Set<utils::Str> used_names;
+            run_on_block(ir, blocks[i], blocks[i]->name, used_names, context);
+        }, num_threads);
+        return 0;
+
+    }
+
     utils::Set<utils::Str> used_names;
-    if (!ir->program.empty()) {
-        for (const auto &block : ir->program->blocks) {
-            run_on_block(ir, block, block->name, used_names, context);
-        }
+    for (const auto &block : blocks) {
+        run_on_block(ir, block, block->name, used_names, context);
     }
     return 0;
 }
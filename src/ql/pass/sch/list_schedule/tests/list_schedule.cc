@@ -0,0 +1,62 @@
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/com/options.h"
+#include "ql/pmgr/manager.h"
+
+using namespace ql;
+
+/**
+ * Schedules the given IR with the list scheduler, with or without scheduling
+ * the top-level blocks concurrently.
+ */
+static void schedule(const ir::Ref &ir, utils::Bool parallel_blocks) {
+    pmgr::Manager manager;
+    manager.append_pass(
+        "sch.ListSchedule",
+        "scheduler",
+        {{"parallel_blocks", parallel_blocks ? "yes" : "no"}}
+    );
+    manager.compile(ir);
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    for (utils::UInt k = 0; k < 8; k++) {
+        auto kernel = utils::make<ir::compat::Kernel>(
+            "kernel_" + utils::to_string(k), plat, 7, 32, 10
+        );
+        for (utils::UInt i = 0; i < 20; i++) {
+            auto q = (i * (k + 1)) % 7;
+            kernel->x(q);
+            kernel->cz(q, (q + 1 + k % 3) % 7);
+            kernel->y((q + 3) % 7);
+        }
+        kernel->measure(k % 7);
+        program->add(kernel);
+    }
+
+    // Schedule two independent conversions of the same program, one with a
+    // single thread and one with the top-level blocks scheduled concurrently.
+    com::options::global["num_threads"] = "4";
+    auto serial = ir::convert_old_to_new(program);
+    schedule(serial, false);
+    auto parallel = ir::convert_old_to_new(program);
+    schedule(parallel, true);
+
+    // The resulting schedules must be identical.
+    QL_ASSERT_EQ(serial->program->blocks.size(), parallel->program->blocks.size());
+    for (utils::UInt b = 0; b < serial->program->blocks.size(); b++) {
+        const auto &serial_block = serial->program->blocks[b];
+        const auto &parallel_block = parallel->program->blocks[b];
+        QL_ASSERT_EQ(serial_block->statements.size(), parallel_block->statements.size());
+        for (utils::UInt s = 0; s < serial_block->statements.size(); s++) {
+            QL_ASSERT_EQ(
+                serial_block->statements[s]->cycle,
+                parallel_block->statements[s]->cycle
+            );
+        }
+    }
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include "ql/pmgr/manager.h"
 
 #include "ql/utils/filesystem.h"
+#include "ql/utils/arena.h"
 #include "ql/com/options.h"
 #include "ql/arch/architecture.h"
 #include "ql/ir/cqasm/write.h"
@@ -900,8 +901,76 @@ void Manager::compile(const ir::Ref &ir) {
     // Ensure that all passes are constructed.
     construct();
 
+    // Set up a profiler if pass profiling is enabled.
+    profile::Ref profiler;
+    if (com::options::global["profile_passes"].as_bool()) {
+        profiler.emplace();
+    }
+
+    // Allocate new IR nodes from an arena if requested, unless the caller
+    // already set one up. The arena is attached to the IR root, such that it
+    // is released along with the program. If the program was compiled before
+    // with an arena, that arena is reused.
+    utils::ArenaRef arena = utils::ArenaScope::get_active();
+    utils::Bool own_arena = false;
+    if (!arena && com::options::global["ir_node_arena"].as_bool()) {
+        if (auto existing = ir->get_annotation_ptr<utils::ArenaRef>()) {
+            arena = *existing;
+        } else {
+            arena = utils::Arena::create();
+            ir->set_annotation<utils::ArenaRef>(arena);
+        }
+        own_arena = true;
+    }
+
+    // Compile the program.
+    {
+        utils::ArenaScope arena_scope(arena);
+        root->compile(ir, "", profiler);
+    }
+
+    // Report arena usage.
+    if (own_arena) {
+        QL_IOUT(
+            "IR node arena: " << arena->get_num_allocations() << " allocations ("
+            << arena->get_num_reuses() << " reused), "
+            << arena->get_num_forwarded() << " forwarded to the heap, "
+            << arena->get_num_live() << " still live, "
+            << (arena->get_num_chunk_bytes() >> 10) << " KiB of chunks"
+        );
+    }
+
+    // Write the profiling results.
+    if (profiler.has_value()) {
+        utils::Str prefix = com::options::global["output_dir"].as_str() + "/";
+        if (!ir->program.empty()) {
+            prefix += ir->program->unique_name;
+        } else {
+            prefix += ir->platform->name;
+        }
+        utils::OutFile(prefix + "_profile.json") << profiler->to_json().dump(4) << "\n";
+        utils::OutFile(prefix + "_profile.trace.json") << profiler->to_trace_json().dump() << "\n";
+        if (utils::logger::log_level >= utils::logger::LogLevel::LOG_INFO) {
+            utils::StrStrm ss;
+            profiler->dump_summary(ss, "  ");
+            QL_IOUT("pass profile:\n" << ss.str());
+        }
+    }
+
+}
+
+/**
+ * Like compile(), but records profiling information for all passes in the
+ * given profiler, regardless of the profile_passes option. No profiling
+ * output files are written.
+ */
+void Manager::compile(const ir::Ref &ir, const profile::Ref &profiler) {
+
+    // Ensure that all passes are constructed.
+    construct();
+
     // Compile the program.
-    root->compile(ir, "");
+    root->compile(ir, "", profiler);
 
 }
 
@@ -1026,29 +1026,59 @@ void Base::handle_debugging(
 
 /**
  * Wrapper around running the main pass implementation for this pass, taking
- * care of logging, profiling, etc.
+ * care of logging, profiling, etc. iteration is the loop iteration index for
+ * looping pass groups, used only for profiling.
  */
 utils::Int Base::run_main_pass(
     const ir::Ref &ir,
-    const Context &context
+    const Context &context,
+    const profile::Ref &profiler,
+    utils::UInt iteration
 ) const {
+    utils::UInt record = 0;
+    if (profiler.has_value() && is_conditional()) {
+        record = profiler->begin(
+            ir, context.full_pass_name, type_name,
+            profile::RecordKind::CONDITION, iteration
+        );
+    }
     QL_IOUT("starting pass \"" << context.full_pass_name << "\" of type \"" << type_name << "\"...");
     auto retval = run_internal(ir, context);
     QL_IOUT("completed pass \"" << context.full_pass_name << "\"; return value is " << retval);
+    if (profiler.has_value() && is_conditional()) {
+        profiler->end(ir, record);
+    }
     return retval;
 }
 
 /**
  * Wrapper around running the sub-passes for this pass, taking care of logging,
- * profiling, etc.
+ * profiling, etc. iteration is the loop iteration index for looping pass
+ * groups, used only for profiling.
  */
 void Base::run_sub_passes(
     const ir::Ref &ir,
-    const Context &context
+    const Context &context,
+    const profile::Ref &profiler,
+    utils::UInt iteration
 ) const {
+    utils::Bool is_loop = (
+        node_type == NodeType::GROUP_WHILE ||
+        node_type == NodeType::GROUP_REPEAT_UNTIL_NOT
+    );
+    utils::UInt record = 0;
+    if (profiler.has_value() && is_loop) {
+        record = profiler->begin(
+            ir, context.full_pass_name, type_name,
+            profile::RecordKind::ITERATION, iteration
+        );
+    }
     utils::Str sub_prefix = context.full_pass_name.empty() ? "" : (context.full_pass_name + ".");
     for (const auto &pass : sub_pass_order) {
-        pass->compile(ir, sub_prefix);
+        pass->compile(ir, sub_prefix, profiler);
+    }
+    if (profiler.has_value() && is_loop) {
+        profiler->end(ir, record);
     }
 }
 
@@ -1057,7 +1087,8 @@ void Base::run_sub_passes(
  */
 void Base::compile(
     const ir::Ref &ir,
-    const utils::Str &pass_name_prefix
+    const utils::Str &pass_name_prefix,
+    const profile::Ref &profiler
 ) {
 
     // The passes should already have been constructed by the pass manager.
@@ -1120,26 +1151,35 @@ void Base::compile(
         );
     }
 
+    // Start profiling this pass, if requested.
+    utils::UInt record = 0;
+    if (profiler.has_value()) {
+        record = profiler->begin(
+            ir, context.full_pass_name, type_name,
+            profile::RecordKind::PASS
+        );
+    }
+
     // Handle configured debugging actions before running the pass.
     handle_debugging(ir, context, false);
 
     // Traverse our level of the pass tree based on our node type.
     switch (node_type) {
         case NodeType::NORMAL: {
-            run_main_pass(ir, context);
+            run_main_pass(ir, context, profiler);
             break;
         }
 
         case NodeType::GROUP: {
-            run_sub_passes(ir, context);
+            run_sub_passes(ir, context, profiler);
             break;
         }
 
         case NodeType::GROUP_IF: {
-            auto retval = run_main_pass(ir, context);
+            auto retval = run_main_pass(ir, context, profiler);
             if (condition->evaluate(retval)) {
                 QL_IOUT("pass condition returned true, running sub-passes...");
-                run_sub_passes(ir, context);
+                run_sub_passes(ir, context, profiler);
             } else {
                 QL_IOUT("pass condition returned false, skipping " << sub_pass_order.size() << " sub-pass(es)");
             }
@@ -1148,24 +1188,24 @@ void Base::compile(
 
         case NodeType::GROUP_WHILE: {
             QL_IOUT("entering loop pass loop...");
-            while (true) {
-                auto retval = run_main_pass(ir, context);
+            for (utils::UInt iteration = 0; ; iteration++) {
+                auto retval = run_main_pass(ir, context, profiler, iteration);
                 if (!condition->evaluate(retval)) {
                     QL_IOUT("pass condition returned false, exiting loop");
                     break;
                 } else {
                     QL_IOUT("pass condition returned true, continuing loop...");
                 }
-                run_sub_passes(ir, context);
+                run_sub_passes(ir, context, profiler, iteration);
             }
             break;
         }
 
         case NodeType::GROUP_REPEAT_UNTIL_NOT: {
             QL_IOUT("entering loop pass loop...");
-            while (true) {
-                run_sub_passes(ir, context);
-                auto retval = run_main_pass(ir, context);
+            for (utils::UInt iteration = 0; ; iteration++) {
+                run_sub_passes(ir, context, profiler, iteration);
+                auto retval = run_main_pass(ir, context, profiler, iteration);
                 if (!condition->evaluate(retval)) {
                     QL_IOUT("pass condition returned false, exiting loop");
                     break;
@@ -1182,6 +1222,11 @@ void Base::compile(
     // Handle configured debugging actions after running the pass.
     handle_debugging(ir, context, true);
 
+    // Finish profiling this pass.
+    if (profiler.has_value()) {
+        profiler->end(ir, record);
+    }
+
 }
 
 } // namespace pass_types
@@ -0,0 +1,206 @@
+/** \file
+ * Contains the profiler that the pass management logic uses to measure the
+ * time and memory spent on each pass.
+ */
+
+#include "ql/pmgr/profile.h"
+
+#include <iomanip>
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/new_to_old.h"
+#include "ql/com/ana/metrics.h"
+
+namespace ql {
+namespace pmgr {
+namespace profile {
+
+/**
+ * String conversion for RecordKind.
+ */
+std::ostream &operator<<(std::ostream &os, RecordKind kind) {
+    switch (kind) {
+        case RecordKind::PASS:      os << "pass";      break;
+        case RecordKind::CONDITION: os << "condition"; break;
+        case RecordKind::ITERATION: os << "iteration"; break;
+    }
+    return os;
+}
+
+/**
+ * Returns the total number of IR conversions performed thus far.
+ */
+utils::UInt Profiler::get_num_ir_conversions() {
+    return ir::get_num_old_to_new_conversions() + ir::get_num_new_to_old_conversions();
+}
+
+/**
+ * Returns the number of statements in the given IR's program, or 0 if it
+ * has no program.
+ */
+utils::UInt Profiler::get_num_statements(const ir::Ref &ir) {
+    return com::ana::compute_program<com::ana::StatementCount>(ir);
+}
+
+/**
+ * Starts a new record nested within the innermost record that has not yet
+ * been ended. Returns the index of the new record, to be passed to end().
+ */
+utils::UInt Profiler::begin(
+    const ir::Ref &ir,
+    const utils::Str &name,
+    const utils::Str &type,
+    RecordKind kind,
+    utils::UInt iteration
+) {
+    Record record;
+    record.name = name;
+    record.type = type;
+    record.kind = kind;
+    record.iteration = iteration;
+    record.parent = stack.empty() ? utils::UMAX : stack.back();
+    record.depth = stack.size();
+    record.statements_in = get_num_statements(ir);
+    record.statements_out = 0;
+    record.ir_conversions = get_num_ir_conversions();
+
+    // Take the resource usage snapshot last, such that the statement counting
+    // above isn't attributed to the pass.
+    record.start = utils::ResourceUsage::now();
+
+    auto index = records.size();
+    records.push_back(record);
+    stack.push_back(index);
+    return index;
+}
+
+/**
+ * Ends the record with the given index, which must be the innermost record
+ * that has not been ended yet.
+ */
+void Profiler::end(const ir::Ref &ir, utils::UInt index) {
+    auto now = utils::ResourceUsage::now();
+    QL_ASSERT(!stack.empty() && stack.back() == index);
+    stack.pop_back();
+    auto &record = records[index];
+    record.usage = now.since(record.start);
+    record.statements_out = get_num_statements(ir);
+    record.ir_conversions = get_num_ir_conversions() - record.ir_conversions;
+}
+
+/**
+ * Returns the records collected thus far.
+ */
+const utils::Vec<Record> &Profiler::get_records() const {
+    return records;
+}
+
+/**
+ * Returns the collected records as a JSON object, for machine-readable
+ * processing.
+ */
+utils::Json Profiler::to_json() const {
+    utils::Json json_records = utils::Json::array();
+    for (const auto &record : records) {
+        utils::Json json_record;
+        json_record["name"] = record.name;
+        json_record["type"] = record.type;
+        json_record["kind"] = utils::to_string(record.kind);
+        json_record["iteration"] = record.iteration;
+        if (record.parent == utils::UMAX) {
+            json_record["parent"] = nullptr;
+        } else {
+            json_record["parent"] = record.parent;
+        }
+        json_record["depth"] = record.depth;
+        json_record["start_time"] = record.start.wall_time;
+        json_record["wall_time"] = record.usage.wall_time;
+        json_record["cpu_time"] = record.usage.cpu_time;
+        json_record["peak_rss_delta"] = record.usage.peak_rss;
+        json_record["statements_in"] = record.statements_in;
+        json_record["statements_out"] = record.statements_out;
+        json_record["ir_conversions"] = record.ir_conversions;
+        json_records.push_back(json_record);
+    }
+    utils::Json json;
+    json["units"] = {
+        {"start_time", "s"},
+        {"wall_time", "s"},
+        {"cpu_time", "s"},
+        {"peak_rss_delta", "B"}
+    };
+    json["records"] = json_records;
+    return json;
+}
+
+/**
+ * Returns the collected records as a JSON object in the Chrome trace-event
+ * format, which can be loaded in chrome://tracing, Perfetto, or speedscope.
+ */
+utils::Json Profiler::to_trace_json() const {
+    utils::Json events = utils::Json::array();
+    for (const auto &record : records) {
+        utils::Json event;
+        utils::Str name = record.name.empty() ? "<root>" : record.name;
+        if (record.kind != RecordKind::PASS) {
+            name += " [" + utils::to_string(record.kind) + " " + utils::to_string(record.iteration) + "]";
+        }
+        event["name"] = name;
+        event["cat"] = utils::to_string(record.kind);
+        event["ph"] = "X";
+        event["ts"] = record.start.wall_time * 1.0e6;
+        event["dur"] = record.usage.wall_time * 1.0e6;
+        event["pid"] = 0;
+        event["tid"] = 0;
+        event["args"] = {
+            {"type", record.type},
+            {"cpu_time_us", record.usage.cpu_time * 1.0e6},
+            {"peak_rss_delta", record.usage.peak_rss},
+            {"statements_in", record.statements_in},
+            {"statements_out", record.statements_out},
+            {"ir_conversions", record.ir_conversions}
+        };
+        events.push_back(event);
+    }
+    utils::Json json;
+    json["traceEvents"] = events;
+    json["displayTimeUnit"] = "ms";
+    return json;
+}
+
+/**
+ * Dumps a human-readable summary of the collected records to the given
+ * stream.
+ */
+void Profiler::dump_summary(
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    os << line_prefix;
+    os << std::setw(12) << "wall [ms]";
+    os << std::setw(12) << "cpu [ms]";
+    os << std::setw(12) << "rss+ [KiB]";
+    os << std::setw(10) << "stmts in";
+    os << std::setw(10) << "stmts out";
+    os << std::setw(6) << "conv";
+    os << "  pass\n";
+    for (const auto &record : records) {
+        os << line_prefix << std::fixed << std::setprecision(2);
+        os << std::setw(12) << record.usage.wall_time * 1.0e3;
+        os << std::setw(12) << record.usage.cpu_time * 1.0e3;
+        os << std::setw(12) << record.usage.peak_rss / 1024;
+        os << std::setw(10) << record.statements_in;
+        os << std::setw(10) << record.statements_out;
+        os << std::setw(6) << record.ir_conversions;
+        os << "  " << utils::Str(record.depth * 2, ' ');
+        os << (record.name.empty() ? "<root>" : record.name);
+        if (record.kind != RecordKind::PASS) {
+            os << " [" << record.kind << " " << record.iteration << "]";
+        }
+        os << "\n";
+    }
+    os.flush();
+}
+
+} // namespace profile
+} // namespace pmgr
+} // namespace ql
@@ -5,6 +5,8 @@
 
 #include "ql/resource/instrument.h"
 
+#include <mutex>
+
 /*#undef QL_DOUT
 #define QL_DOUT(x) ::std::cout << x << ::std::endl
 #undef QL_IF_LOG_DEBUG
@@ -79,6 +81,13 @@ struct Config {
      */
     utils::Map<utils::Vec<utils::Str>, Function> function_map;
 
+    /**
+     * Mutex protecting function_map. Since the configuration is shared between
+     * all clones of the resource, and different blocks may be scheduled
+     * concurrently, lookups and insertions must be serialized.
+     */
+    std::mutex function_map_mutex;
+
     /**
      * When set, function_keys is ignored, function_map is unused, and all
      * instrument usage is considered to be mutually exclusive.
@@ -462,6 +471,8 @@ void InstrumentResource::on_initialize(rmgr::Direction direction) {
     // Initialize state.
     state.clear();
     state.resize(cfg->instrument_names.size());
+    undo_log.clear();
+    checkpoints.clear();
 
     // Print result if debug is enabled.
     QL_IF_LOG_DEBUG {
@@ -630,13 +641,18 @@ utils::Bool InstrumentResource::on_gate(
         // seen before. Note that this is fine even when resources are cloned
         // (remember: config is NOT cloned!) because we only ever add indices
         // here. Doing so doesn't affect the state. At worst, it may change
-        // *future* indices added by other clones of this resource.
-        auto it = config->function_map.find(function_key);
-        if (it == config->function_map.end()) {
-            function = config->function_map.size();
-            config->function_map.set(function_key) = function;
-        } else {
-            function = it->second;
+        // *future* indices added by other clones of this resource. Clones may
+        // live in different threads, so we need to lock the map while doing
+        // this.
+        {
+            std::lock_guard<std::mutex> lock(config->function_map_mutex);
+            auto it = config->function_map.find(function_key);
+            if (it == config->function_map.end()) {
+                function = config->function_map.size();
+                config->function_map.set(function_key) = function;
+            } else {
+                function = it->second;
+            }
         }
         QL_DOUT("    function index = " << function);
 
@@ -712,6 +728,9 @@ utils::Bool InstrumentResource::on_gate(
             << affected.size() << " instruments"
         );
         for (auto index : affected) {
+            if (!checkpoints.empty()) {
+                undo_log.emplace_back(index, state[index]);
+            }
             if (config->direction == rmgr::Direction::FORWARD) {
                 state[index].erase({utils::MIN, range.first});
             } else if (config->direction == rmgr::Direction::BACKWARD) {
@@ -729,6 +748,36 @@ utils::Bool InstrumentResource::on_gate(
     return true;
 }
 
+/**
+ * Starts a checkpoint for the reservation state.
+ */
+utils::Bool InstrumentResource::on_checkpoint() {
+    checkpoints.push_back(undo_log.size());
+    return true;
+}
+
+/**
+ * Rolls back to the most recent checkpoint.
+ */
+void InstrumentResource::on_rollback() {
+    auto size = checkpoints.back();
+    checkpoints.pop_back();
+    while (undo_log.size() > size) {
+        state[undo_log.back().first] = std::move(undo_log.back().second);
+        undo_log.pop_back();
+    }
+}
+
+/**
+ * Removes the most recent checkpoint, keeping the reservations.
+ */
+void InstrumentResource::on_commit() {
+    checkpoints.pop_back();
+    if (checkpoints.empty()) {
+        undo_log.clear();
+    }
+}
+
 /**
  * Dumps documentation for this resource.
  */
@@ -1289,6 +1338,7 @@ void InstrumentResource::on_dump_state(
                 if (this->config->mutually_exclusive) {
                     os << "reserved";
                 } else {
+                    std::lock_guard<std::mutex> lock(this->config->function_map_mutex);
                     for (const auto &it : this->config->function_map) {
                         if (val == it.second) {
                             os << it.first;
@@ -54,12 +54,6 @@ struct Config {
      */
     utils::UInt num_channels;
 
-    /**
-     * When set, there is a defined scheduling direction, which means it's
-     * sufficient to only track the latest reservation for each qubit.
-     */
-    utils::Bool optimize;
-
     /**
      * The (desugared) JSON configuration of this resource. Only retained for
      * dumping the configuration.
@@ -80,7 +74,6 @@ void InterCoreChannelResource::on_initialize(rmgr::Direction direction) {
 
     // Set the easy stuff.
     cfg->num_cores = context->platform->topology->get_num_cores();
-    cfg->optimize = direction != rmgr::Direction::UNDEFINED;
 
     // Parse the JSON configuration.
     cfg->json = context->configuration;
@@ -178,11 +171,10 @@ void InterCoreChannelResource::on_initialize(rmgr::Direction direction) {
     config = cfg;
 
     // Initialize state.
-    state.clear();
-    state.resize(cfg->num_cores);
-    for (auto &s : state) {
-        s.resize(cfg->num_channels);
-    }
+    state.initialize(
+        cfg->num_cores * cfg->num_channels,
+        direction != rmgr::Direction::UNDEFINED
+    );
 
     // Print result if debug is enabled.
     QL_IF_LOG_DEBUG {
@@ -209,6 +201,25 @@ void InterCoreChannelResource::on_initialize(rmgr::Direction direction) {
 #undef ERROR
 }
 
+/**
+ * Returns the first channel of the given core that is free for the given cycle
+ * range, or num_channels if there is none.
+ */
+utils::UInt InterCoreChannelResource::find_free_channel(
+    utils::UInt core,
+    utils::Int start,
+    utils::Int end
+) const {
+    auto num_channels = config->num_channels;
+    auto slot = core * num_channels;
+    for (utils::UInt channel = 0; channel < num_channels; channel++) {
+        if (state.is_free(slot + channel, start, end)) {
+            return channel;
+        }
+    }
+    return num_channels;
+}
+
 /**
  * Checks availability of and/or reserves a gate.
  */
@@ -279,21 +290,12 @@ utils::Bool InterCoreChannelResource::on_gate(
     }
 
     // Compute cycle range for this gate.
-    State::Range range = {
-        cycle,
-        cycle + gate.duration_cycles
-    };
+    utils::Int start = cycle;
+    utils::Int end = cycle + gate.duration_cycles;
 
     // Check availability.
     for (auto core : affected) {
-        utils::Bool core_available = false;
-        for (auto &s : state[core]) {
-            if (s.find(range).type == utils::RangeMatchType::NONE) {
-                core_available = true;
-                break;
-            }
-        }
-        if (!core_available) {
+        if (find_free_channel(core, start, end) >= config->num_channels) {
             QL_DOUT(" -> not available because core " << core << " I/O is saturated");
             return false;
         }
@@ -307,18 +309,9 @@ utils::Bool InterCoreChannelResource::on_gate(
             << affected.size() << " cores"
         );
         for (auto core : affected) {
-            utils::Bool core_found = false;
-            for (auto &s : state[core]) {
-                if (s.find(range).type == utils::RangeMatchType::NONE) {
-                    if (config->optimize) {
-                        s.clear();
-                    }
-                    s.set(range);
-                    core_found = true;
-                    break;
-                }
-            }
-            QL_ASSERT(core_found);
+            auto channel = find_free_channel(core, start, end);
+            QL_ASSERT(channel < config->num_channels);
+            state.reserve(core * config->num_channels + channel, start, end);
         }
     } else {
         QL_DOUT(
@@ -329,6 +322,28 @@ utils::Bool InterCoreChannelResource::on_gate(
     return true;
 }
 
+/**
+ * Starts a checkpoint for the reservation state.
+ */
+utils::Bool InterCoreChannelResource::on_checkpoint() {
+    state.checkpoint();
+    return true;
+}
+
+/**
+ * Rolls back to the most recent checkpoint.
+ */
+void InterCoreChannelResource::on_rollback() {
+    state.rollback();
+}
+
+/**
+ * Removes the most recent checkpoint, keeping the reservations.
+ */
+void InterCoreChannelResource::on_commit() {
+    state.commit();
+}
+
 /**
  * Dumps documentation for this resource.
  */
@@ -435,7 +450,7 @@ void InterCoreChannelResource::on_dump_config(
     std::ostream &os,
     const utils::Str &line_prefix
 ) const {
-    if (state.empty()) {
+    if (!config) {
         os << line_prefix << "Not yet initialized" << std::endl;
         return;
     }
@@ -450,16 +465,15 @@ void InterCoreChannelResource::on_dump_state(
     std::ostream &os,
     const utils::Str &line_prefix
 ) const {
-    if (state.empty()) {
+    if (!config) {
         os << line_prefix << "Not yet initialized" << std::endl;
         return;
     }
-    for (utils::UInt core = 0; core < state.size(); core++) {
+    for (utils::UInt core = 0; core < config->num_cores; core++) {
         os << line_prefix << "Core " << core << ":\n";
-        const auto &core_state = state[core];
-        for (utils::UInt channel = 0; channel < core_state.size(); channel++) {
+        for (utils::UInt channel = 0; channel < config->num_channels; channel++) {
             os << line_prefix << "  Channel " << channel << ":\n";
-            core_state[channel].dump_state(os, line_prefix + "    ");
+            state.dump_state(core * config->num_channels + channel, os, line_prefix + "    ");
         }
     }
     os.flush();
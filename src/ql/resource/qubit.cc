@@ -13,8 +13,10 @@ namespace qubit {
  * Initializes this resource.
  */
 void QubitResource::on_initialize(rmgr::Direction direction) {
-    state = utils::Vec<State>(context->platform->qubit_count);
-    optimize = direction != rmgr::Direction::UNDEFINED;
+    state.initialize(
+        context->platform->qubit_count,
+        direction != rmgr::Direction::UNDEFINED
+    );
 }
 
 /**
@@ -27,14 +29,12 @@ utils::Bool QubitResource::on_gate(
 ) {
 
     // Compute cycle range for this gate.
-    State::Range range = {
-        cycle,
-        cycle + gate.duration_cycles
-    };
+    utils::Int start = cycle;
+    utils::Int end = cycle + gate.duration_cycles;
 
     // Check qubit availability for all operands.
     for (auto qubit : gate.qubits) {
-        if (state[qubit].find(range).type != utils::RangeMatchType::NONE) {
+        if (!state.is_free(qubit, start, end)) {
             return false;
         }
     }
@@ -42,16 +42,55 @@ utils::Bool QubitResource::on_gate(
     // If we're committing, reserve for all operands.
     if (commit) {
         for (auto qubit : gate.qubits) {
-            if (optimize) {
-                state[qubit].clear();
+            state.reserve(qubit, start, end);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Checks availability of a batch of gates.
+ */
+void QubitResource::on_gate_batch(
+    utils::Int cycle,
+    const utils::Vec<rmgr::resource_types::GateData> &gates,
+    utils::Vec<utils::Bool> &mask
+) {
+    for (utils::UInt i = 0; i < gates.size(); i++) {
+        if (!mask[i]) continue;
+        utils::Int end = cycle + gates[i].duration_cycles;
+        for (auto qubit : gates[i].qubits) {
+            if (!state.is_free(qubit, cycle, end)) {
+                mask[i] = false;
+                break;
             }
-            state[qubit].set(range);
         }
     }
+}
 
+/**
+ * Starts a checkpoint for the reservation state.
+ */
+utils::Bool QubitResource::on_checkpoint() {
+    state.checkpoint();
     return true;
 }
 
+/**
+ * Rolls back to the most recent checkpoint.
+ */
+void QubitResource::on_rollback() {
+    state.rollback();
+}
+
+/**
+ * Removes the most recent checkpoint, keeping the reservations.
+ */
+void QubitResource::on_commit() {
+    state.commit();
+}
+
 /**
  * Dumps documentation for this resource.
  */
@@ -94,7 +133,7 @@ void QubitResource::on_dump_state(
 ) const {
     for (utils::UInt q = 0; q < state.size(); q++) {
         os << line_prefix << "Qubit " << q << ":\n";
-        state[q].dump_state(os, line_prefix + "  ");
+        state.dump_state(q, os, line_prefix + "  ");
     }
 }
 
@@ -0,0 +1,175 @@
+/** \file
+ * Defines a table of cycle reservations for a number of exclusive resource
+ * slots (qubits, communication channels, etc.), used by the resources that
+ * only need to know whether a slot is in use.
+ */
+
+#include "ql/resource/reservations.h"
+
+#include <algorithm>
+#include <iterator>
+#include "ql/utils/exception.h"
+
+namespace ql {
+namespace resource {
+
+/**
+ * Resets the table to the given number of slots without reservations. If
+ * dense is set, only the latest reservation is tracked for each slot.
+ */
+void ReservationTable::initialize(utils::UInt num_slots, utils::Bool dense) {
+    this->dense = dense;
+    undo_log.clear();
+    checkpoints.clear();
+    first.clear();
+    second.clear();
+    ranges.clear();
+    if (dense) {
+
+        // An empty range at the lowest possible cycle never overlaps with
+        // anything, so it represents the absence of a reservation.
+        first.resize(num_slots, utils::MIN);
+        second.resize(num_slots, utils::MIN);
+
+    } else {
+        ranges.resize(num_slots);
+    }
+}
+
+/**
+ * Returns the number of slots in the table.
+ */
+utils::UInt ReservationTable::size() const {
+    return dense ? first.size() : ranges.size();
+}
+
+/**
+ * Returns whether range a sorts before range b in the reservation vectors.
+ * This is the same order as used by utils::RangeSet, i.e. by ascending start
+ * cycle and then by descending end cycle.
+ */
+static utils::Bool range_before(
+    const ReservationTable::Range &a,
+    const ReservationTable::Range &b
+) {
+    return a.first < b.first || (a.first == b.first && a.second > b.second);
+}
+
+/**
+ * Implementation of is_free() for sparse mode.
+ */
+utils::Bool ReservationTable::is_free_sparse(
+    utils::UInt slot,
+    utils::Int start,
+    utils::Int end
+) const {
+
+    // The reservations are disjoint, so only the reservations immediately
+    // before and after the insertion position of the range can overlap with
+    // it.
+    const auto &slot_ranges = ranges[slot];
+    Range range = {start, end};
+    auto it = std::lower_bound(slot_ranges.begin(), slot_ranges.end(), range, range_before);
+    if (it != slot_ranges.begin() && std::prev(it)->second > start) {
+        return false;
+    }
+    if (it != slot_ranges.end() && end > it->first) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Implementation of reserve() for sparse mode.
+ */
+void ReservationTable::reserve_sparse(
+    utils::UInt slot,
+    utils::Int start,
+    utils::Int end
+) {
+    auto &slot_ranges = ranges[slot];
+    Range range = {start, end};
+    if (!checkpoints.empty()) {
+        undo_log.push_back({slot, range});
+    }
+    slot_ranges.insert(
+        std::upper_bound(slot_ranges.begin(), slot_ranges.end(), range, range_before),
+        range
+    );
+}
+
+/**
+ * Starts logging the reservations that are made from now on, such that they
+ * can be rolled back with rollback(). Checkpoints can be nested; each
+ * checkpoint() must be matched by a rollback() or commit().
+ */
+void ReservationTable::checkpoint() {
+    checkpoints.push_back(undo_log.size());
+}
+
+/**
+ * Undoes all reservations made since the most recent checkpoint, and removes
+ * that checkpoint.
+ */
+void ReservationTable::rollback() {
+    QL_ASSERT(!checkpoints.empty());
+    auto size = checkpoints.back();
+    checkpoints.pop_back();
+    while (undo_log.size() > size) {
+        const auto &entry = undo_log.back();
+        if (dense) {
+            first[entry.slot] = entry.range.first;
+            second[entry.slot] = entry.range.second;
+        } else {
+
+            // Reservations are undone in reverse order, so the range is
+            // still there.
+            auto &slot_ranges = ranges[entry.slot];
+            auto it = std::lower_bound(slot_ranges.begin(), slot_ranges.end(), entry.range, range_before);
+            QL_ASSERT(it != slot_ranges.end() && *it == entry.range);
+            slot_ranges.erase(it);
+
+        }
+        undo_log.pop_back();
+    }
+}
+
+/**
+ * Removes the most recent checkpoint, keeping the reservations made since.
+ * They can still be rolled back by rolling back an enclosing checkpoint.
+ */
+void ReservationTable::commit() {
+    QL_ASSERT(!checkpoints.empty());
+    checkpoints.pop_back();
+    if (checkpoints.empty()) {
+        undo_log.clear();
+    }
+}
+
+/**
+ * Dumps the reservations for the given slot.
+ */
+void ReservationTable::dump_state(
+    utils::UInt slot,
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    if (dense) {
+        if (first[slot] == utils::MIN && second[slot] == utils::MIN) {
+            os << line_prefix << "empty" << std::endl;
+        } else {
+            os << line_prefix << "[" << first[slot] << ".." << second[slot] << ")" << std::endl;
+        }
+        return;
+    }
+    if (ranges[slot].empty()) {
+        os << line_prefix << "empty" << std::endl;
+        return;
+    }
+    for (const auto &range : ranges[slot]) {
+        os << line_prefix << "[" << range.first << ".." << range.second << ")" << std::endl;
+    }
+}
+
+} // namespace resource
+} // namespace ql
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "ql/utils/rangemap.h"
+#include "ql/resource/reservations.h"
+
+using namespace ql::utils;
+using namespace ql::resource;
+
+/**
+ * Checks the table against the RangeSet-based implementation it replaced, for
+ * a random sequence of reservations with cycles that increase in dense mode
+ * and are arbitrary otherwise.
+ */
+static void check_against_range_set(Bool dense) {
+    const UInt num_slots = 4;
+    ReservationTable table;
+    table.initialize(num_slots, dense);
+    QL_ASSERT_EQ(table.size(), num_slots);
+    Vec<RangeSet<Int>> reference(num_slots);
+
+    std::mt19937 rng(dense ? 1 : 2);
+    Int cycle = -20;
+    for (UInt i = 0; i < 2000; i++) {
+        auto slot = rng() % num_slots;
+        if (dense) {
+            cycle += rng() % 3;
+        } else {
+            cycle = (Int)(rng() % 200) - 100;
+        }
+        auto duration = (Int)(rng() % 4);
+        RangeSet<Int>::Range range = {cycle, cycle + duration};
+        auto free = reference[slot].find(range).type == RangeMatchType::NONE;
+        QL_ASSERT_EQ(table.is_free(slot, range.first, range.second), free);
+        if (free) {
+            if (dense) {
+                reference[slot].clear();
+            }
+            reference[slot].set(range);
+            table.reserve(slot, range.first, range.second);
+        }
+    }
+}
+
+/**
+ * Checks that rolling back a checkpoint restores the table exactly, including
+ * for nested checkpoints and committed inner checkpoints.
+ */
+static void check_rollback(Bool dense) {
+    const UInt num_slots = 3;
+    ReservationTable table;
+    table.initialize(num_slots, dense);
+
+    std::mt19937 rng(dense ? 3 : 4);
+    Int cycle = 0;
+    auto reserve_some = [&](UInt count) {
+        for (UInt i = 0; i < count; i++) {
+            auto slot = rng() % num_slots;
+            cycle += rng() % 3;
+            auto start = dense ? cycle : (Int)(rng() % 100);
+            auto end = start + (Int)(rng() % 4);
+            if (table.is_free(slot, start, end)) {
+                table.reserve(slot, start, end);
+            }
+        }
+    };
+    auto dump = [&]() -> Str {
+        std::ostringstream ss;
+        for (UInt slot = 0; slot < num_slots; slot++) {
+            table.dump_state(slot, ss, "");
+        }
+        return ss.str();
+    };
+
+    reserve_some(20);
+    auto outer = dump();
+    table.checkpoint();
+    reserve_some(20);
+    auto inner = dump();
+    table.checkpoint();
+    reserve_some(20);
+    table.rollback();
+    QL_ASSERT(dump() == inner);
+    table.checkpoint();
+    reserve_some(20);
+    table.commit();
+    table.rollback();
+    QL_ASSERT(dump() == outer);
+}
+
+int main() {
+    ReservationTable table;
+    table.initialize(2, true);
+    QL_ASSERT(table.is_free(0, -5, 5));
+    table.reserve(0, 2, 5);
+    QL_ASSERT(!table.is_free(0, 4, 6));
+    QL_ASSERT(table.is_free(0, 5, 6));
+    QL_ASSERT(table.is_free(1, 4, 6));
+
+    table.initialize(1, false);
+    table.reserve(0, 10, 12);
+    table.reserve(0, 0, 2);
+    QL_ASSERT(!table.is_free(0, 1, 3));
+    QL_ASSERT(table.is_free(0, 2, 10));
+    QL_ASSERT(!table.is_free(0, 11, 11));
+
+    check_against_range_set(true);
+    check_against_range_set(false);
+    check_rollback(true);
+    check_rollback(false);
+
+    return 0;
+}
@@ -32,6 +32,56 @@ void Base::on_initialize(Direction direction) {
     (void)direction;
 }
 
+/**
+ * Abstract implementation for gate_batch(). mask has one entry for each gate;
+ * only the gates for which the entry is set need to be checked, and the entry
+ * must be cleared for those that are not available. The state must not be
+ * updated. The default implementation calls on_gate() for each gate;
+ * resources that can check availability in a tighter loop over their internal
+ * state should override this.
+ */
+void Base::on_gate_batch(
+    utils::Int cycle,
+    const utils::Vec<GateData> &gates,
+    utils::Vec<utils::Bool> &mask
+) {
+    for (utils::UInt i = 0; i < gates.size(); i++) {
+        if (mask[i] && !on_gate(cycle, gates[i], false)) {
+            mask[i] = false;
+        }
+    }
+}
+
+/**
+ * Abstract implementation for checkpoint(). Resources that can roll back their
+ * state changes more efficiently than by cloning the whole state (typically by
+ * keeping an undo log of the changes made since the checkpoint) should
+ * override this to start such a checkpoint and return true, and should
+ * override on_rollback() and on_commit() as well. Checkpoints may be nested.
+ * The default implementation returns false.
+ */
+utils::Bool Base::on_checkpoint() {
+    return false;
+}
+
+/**
+ * Abstract implementation for rollback(). Only called for checkpoints for
+ * which on_checkpoint() returned true. The default implementation throws an
+ * exception.
+ */
+void Base::on_rollback() {
+    QL_ICE("resource " << get_name() << " does not implement rollback()");
+}
+
+/**
+ * Abstract implementation for commit(). Only called for checkpoints for which
+ * on_checkpoint() returned true. The default implementation throws an
+ * exception.
+ */
+void Base::on_commit() {
+    QL_ICE("resource " << get_name() << " does not implement commit()");
+}
+
 /**
  * Returns the type name for this resource.
  */
@@ -169,6 +219,16 @@ utils::Bool Base::gate(
     if (!initialized) {
         throw utils::Exception("resource gate() called before initialization");
     }
+    return this->gate(cycle, get_gate_data(statement), commit);
+}
+
+/**
+ * Builds the gate data structure for the given new-IR statement, as passed to
+ * gate(). This only depends on the statement and the context of the resource,
+ * so the result can be reused for every resource constructed for the same
+ * platform, for any cycle.
+ */
+GateData Base::get_gate_data(const ir::StatementRef &statement) const {
 
     // Convert to GateData wrapper.
     static const utils::Json EMPTY = {};
@@ -217,7 +277,85 @@ utils::Bool Base::gate(
         }
     }
 
-    return this->gate(cycle, data, commit);
+    return data;
+}
+
+/**
+ * Checks the availability of a batch of gates for the given (start) cycle
+ * without updating the state. mask has one entry for each gate; the entries
+ * for gates that are not available are cleared, while the entries that are
+ * already cleared are left alone. Note that the cycle number may be negative.
+ */
+void Base::gate_batch(
+    utils::Int cycle,
+    const utils::Vec<GateData> &gates,
+    utils::Vec<utils::Bool> &mask
+) {
+    if (!initialized) {
+        throw utils::Exception("resource gate_batch() called before initialization");
+    }
+
+    // Verify that the scheduling direction (if any) is respected, as for
+    // gate().
+    utils::Bool out_of_order = false;
+    switch (direction) {
+        case Direction::FORWARD: out_of_order = cycle < prev_cycle; break;
+        case Direction::BACKWARD: out_of_order = cycle > prev_cycle; break;
+        default: void();
+    }
+    if (out_of_order) {
+        for (utils::UInt i = 0; i < mask.size(); i++) {
+            mask[i] = false;
+        }
+        return;
+    }
+
+    // Run the resource implementation.
+    on_gate_batch(cycle, gates, mask);
+
+}
+
+/**
+ * Starts a checkpoint, such that all state changes made from now on can be
+ * undone by rollback() or kept by commit(). Returns false if the resource
+ * doesn't support this, in which case the caller must save a clone of the
+ * resource instead, and must not call rollback() or commit() for this
+ * checkpoint.
+ */
+utils::Bool Base::checkpoint() {
+    if (!initialized) {
+        throw utils::Exception("resource checkpoint() called before initialization");
+    }
+    if (!on_checkpoint()) {
+        return false;
+    }
+    checkpoint_prev_cycles.push_back(prev_cycle);
+    return true;
+}
+
+/**
+ * Undoes all state changes made since the most recent checkpoint for which
+ * checkpoint() returned true, and removes that checkpoint.
+ */
+void Base::rollback() {
+    if (checkpoint_prev_cycles.empty()) {
+        throw utils::Exception("resource rollback() called without checkpoint");
+    }
+    on_rollback();
+    prev_cycle = checkpoint_prev_cycles.back();
+    checkpoint_prev_cycles.pop_back();
+}
+
+/**
+ * Removes the most recent checkpoint for which checkpoint() returned true,
+ * keeping the state changes made since.
+ */
+void Base::commit() {
+    if (checkpoint_prev_cycles.empty()) {
+        throw utils::Exception("resource commit() called without checkpoint");
+    }
+    on_commit();
+    checkpoint_prev_cycles.pop_back();
 }
 
 /**
@@ -5,6 +5,7 @@
 
 #include "ql/rmgr/state.h"
 
+#include <algorithm>
 #include "ql/ir/ops.h"
 #include "ql/ir/describe.h"
 
@@ -14,11 +15,30 @@ namespace rmgr {
 /**
  * Constructor for the initial state, called from Manager::build().
  */
-State::State() : resources(), is_broken(false) {
+State::State() : resources(), is_broken(false), checkpoints() {
 }
 
 /**
- * Copy constructor that clones the resource states.
+ * Clones the given checkpoints, including the resource states saved in them.
+ */
+utils::Vec<State::Checkpoint> State::clone_checkpoints(
+    const utils::Vec<Checkpoint> &src
+) {
+    utils::Vec<Checkpoint> checkpoints;
+    for (const auto &src_checkpoint : src) {
+        Checkpoint checkpoint;
+        for (const auto &clone : src_checkpoint.clones) {
+            checkpoint.clones.push_back(clone.clone());
+        }
+        checkpoint.is_broken = src_checkpoint.is_broken;
+        checkpoints.push_back(std::move(checkpoint));
+    }
+    return checkpoints;
+}
+
+/**
+ * Copy constructor that clones the resource states, including any
+ * checkpoints.
  */
 State::State(const State &src) {
     resources.resize(src.resources.size());
@@ -26,10 +46,12 @@ State::State(const State &src) {
         resources[i] = src.resources[i].clone();
     }
     is_broken = src.is_broken;
+    checkpoints = clone_checkpoints(src.checkpoints);
 }
 
 /**
- * Copy assignment operator that clones the resource states.
+ * Copy assignment operator that clones the resource states, including any
+ * checkpoints.
  */
 State &State::operator=(const State &src) {
     resources.resize(src.resources.size());
@@ -37,6 +59,7 @@ State &State::operator=(const State &src) {
         resources[i] = src.resources[i].clone();
     }
     is_broken = src.is_broken;
+    checkpoints = clone_checkpoints(src.checkpoints);
     return *this;
 }
 
@@ -78,6 +101,46 @@ utils::Bool State::available(
     return true;
 }
 
+/**
+ * Checks which of the given new-IR statements can be scheduled at the given
+ * (start) cycle. The returned mask has an entry for each statement that is set
+ * if and only if available() would return true for it. This is faster than
+ * calling available() for each statement, because the statements are only
+ * converted to the form used by the resources once, and each resource checks
+ * the whole batch at once. Note that the cycle number may be negative.
+ */
+utils::Vec<utils::Bool> State::available_batch(
+    utils::Int cycle,
+    const utils::Vec<ir::StatementRef> &statements
+) const {
+    if (is_broken) {
+        throw utils::Exception("usage of resource state that was left in an undefined state");
+    }
+    utils::Vec<utils::Bool> mask(statements.size(), true);
+    if (resources.empty()) {
+        return mask;
+    }
+
+    // The gate data only depends on the statement and the platform, which is
+    // the same for all resources, so we only need to build it once.
+    utils::Vec<resource_types::GateData> gates;
+    gates.reserve(statements.size());
+    for (const auto &statement : statements) {
+        gates.push_back(resources.front()->get_gate_data(statement));
+    }
+
+    // Let each resource clear the entries for the statements it can't
+    // accommodate, until there are no statements left.
+    for (auto &resource : resources) {
+        resource->gate_batch(cycle, gates, mask);
+        if (std::find(mask.begin(), mask.end(), true) == mask.end()) {
+            break;
+        }
+    }
+
+    return mask;
+}
+
 /**
  * Schedules the given gate at the given (start) cycle. Throws an exception
  * if this is not possible. When an exception is thrown, the resulting state
@@ -129,6 +192,73 @@ void State::reserve(
     }
 }
 
+/**
+ * Starts a checkpoint, such that all reservations made from now on can be
+ * undone by rollback() or kept by commit(). This allows reservations to be
+ * made speculatively without copying the state: resources that support it keep
+ * an undo log of the changes made since the checkpoint, so the cost is
+ * proportional to the number of changes rather than to the size of the state.
+ * The state of any other resources is cloned. Checkpoints can be nested; each
+ * checkpoint() must be matched by a rollback() or commit(). Copies of the
+ * state include its active checkpoints.
+ */
+void State::checkpoint() {
+    Checkpoint checkpoint;
+    checkpoint.clones.resize(resources.size());
+    for (utils::UInt i = 0; i < resources.size(); i++) {
+        if (!resources[i]->checkpoint()) {
+            checkpoint.clones[i] = resources[i].clone();
+        }
+    }
+    checkpoint.is_broken = is_broken;
+    checkpoints.push_back(std::move(checkpoint));
+}
+
+/**
+ * Undoes all reservations made since the most recent checkpoint, and removes
+ * that checkpoint. This also recovers from a failed reserve() made since the
+ * checkpoint.
+ */
+void State::rollback() {
+    if (checkpoints.empty()) {
+        throw utils::Exception("resource state rollback() called without checkpoint");
+    }
+    auto &checkpoint = checkpoints.back();
+    for (utils::UInt i = 0; i < resources.size(); i++) {
+        if (!checkpoint.clones[i].has_value()) {
+            resources[i]->rollback();
+        } else {
+            resources[i] = std::move(checkpoint.clones[i]);
+        }
+    }
+    is_broken = checkpoint.is_broken;
+    checkpoints.pop_back();
+}
+
+/**
+ * Removes the most recent checkpoint, keeping the reservations made since.
+ * They can still be undone by rolling back an enclosing checkpoint.
+ */
+void State::commit() {
+    if (checkpoints.empty()) {
+        throw utils::Exception("resource state commit() called without checkpoint");
+    }
+    auto &checkpoint = checkpoints.back();
+    for (utils::UInt i = 0; i < resources.size(); i++) {
+        if (!checkpoint.clones[i].has_value()) {
+            resources[i]->commit();
+        }
+    }
+    checkpoints.pop_back();
+}
+
+/**
+ * Returns the number of active checkpoints.
+ */
+utils::UInt State::get_num_checkpoints() const {
+    return checkpoints.size();
+}
+
 /**
  * Dumps a debug representation of the current resource state.
  */
@@ -0,0 +1,115 @@
+#include <random>
+
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/rmgr/manager.h"
+
+using namespace ql;
+
+/**
+ * Schedules random batches of the given statements with the given resources,
+ * checking at each step that available_batch() agrees with available() for
+ * each statement in the batch.
+ */
+static void check_batches(
+    const rmgr::Manager &manager,
+    const utils::Vec<ir::StatementRef> &statements,
+    utils::UInt seed
+) {
+    std::mt19937 rng(seed);
+    auto state = manager.build(rmgr::Direction::FORWARD);
+    utils::Int cycle = 0;
+    utils::Int last_reserved = 0;
+    utils::UInt num_reserved = 0;
+    utils::UInt num_unavailable = 0;
+    for (utils::UInt step = 0; step < 200; step++) {
+
+        // Check a random batch, which may contain duplicates.
+        utils::Vec<ir::StatementRef> batch;
+        auto size = rng() % 12;
+        for (utils::UInt i = 0; i < size; i++) {
+            batch.push_back(statements[rng() % statements.size()]);
+        }
+        auto mask = state.available_batch(cycle, batch);
+        QL_ASSERT_EQ(mask.size(), batch.size());
+        for (utils::UInt i = 0; i < batch.size(); i++) {
+            QL_ASSERT_EQ(mask[i], state.available(cycle, batch[i]));
+            if (!mask[i]) {
+                num_unavailable++;
+            }
+        }
+
+        // Cycles before the most recent reservation are out of order for
+        // forward scheduling, so nothing is available there.
+        if (num_reserved) {
+            auto earlier_mask = state.available_batch(last_reserved - 1, batch);
+            QL_ASSERT_EQ(earlier_mask.size(), batch.size());
+            for (utils::UInt i = 0; i < batch.size(); i++) {
+                QL_ASSERT(!earlier_mask[i]);
+                QL_ASSERT(!state.available(last_reserved - 1, batch[i]));
+            }
+        }
+
+        // Reserve one of the available statements, if any, and sometimes
+        // advance to the next cycle.
+        for (utils::UInt i = 0; i < batch.size(); i++) {
+            if (mask[i]) {
+                state.reserve(cycle, batch[i]);
+                last_reserved = cycle;
+                num_reserved++;
+                break;
+            }
+        }
+        if (rng() % 3 == 0) {
+            cycle++;
+        }
+
+    }
+
+    // Make sure the test actually exercised both outcomes.
+    QL_ASSERT(num_reserved > 0);
+    QL_ASSERT(num_unavailable > 0);
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    auto kernel = utils::make<ir::compat::Kernel>("gates", plat, 7, 32, 10);
+    for (utils::UInt q = 0; q < 7; q++) {
+        kernel->x(q);
+        kernel->y(q);
+        kernel->measure(q);
+    }
+    kernel->cz(2, 0);
+    kernel->cz(0, 3);
+    kernel->cz(3, 1);
+    kernel->cz(1, 4);
+    kernel->cz(2, 5);
+    kernel->cz(5, 3);
+    kernel->cz(3, 6);
+    kernel->cz(6, 4);
+    program->add(kernel);
+    auto ir = ir::convert_old_to_new(program);
+    utils::Vec<ir::StatementRef> statements;
+    for (const auto &statement : ir->program->blocks[0]->statements) {
+        statements.push_back(statement);
+    }
+
+    // The channel resource has no batch implementation of its own, so it
+    // relies on the default one. Let it allow two gates at a time on the
+    // single core of cc_light.
+    utils::Json channel_config = utils::Json::object();
+    channel_config["inter_core_required"] = false;
+    channel_config["num_channels"] = utils::UInt(2);
+
+    // Check the default cc_light resources (qubits and instruments) along
+    // with the channel resource, and the channel resource by itself.
+    auto manager = rmgr::Manager::from_defaults(plat, {}, ir);
+    manager.add_resource("InterCoreChannel", "channels", channel_config);
+    check_batches(manager, statements, 1);
+    rmgr::Manager channels(plat, "", {}, {}, ir);
+    channels.add_resource("InterCoreChannel", "channels", channel_config);
+    check_batches(channels, statements, 2);
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <sstream>
+
+#include "ql/utils/set.h"
+#include "ql/ir/compat/compat.h"
+#include "ql/rmgr/manager.h"
+
+using namespace ql;
+
+/**
+ * Resource that only allows a single gate to start in each cycle. It does not
+ * support checkpoints itself, so State has to clone it at each checkpoint.
+ */
+class OneGatePerCycleResource : public rmgr::resource_types::Base {
+private:
+
+    /**
+     * The cycles in which a gate starts.
+     */
+    utils::Set<utils::Int> used;
+
+protected:
+
+    utils::Bool on_gate(
+        utils::Int cycle,
+        const rmgr::resource_types::GateData &gate,
+        utils::Bool commit
+    ) override {
+        (void)gate;
+        if (used.count(cycle)) {
+            return false;
+        }
+        if (commit) {
+            used.insert(cycle);
+        }
+        return true;
+    }
+
+    void on_dump_docs(std::ostream &os, const utils::Str &line_prefix) const override {
+        os << line_prefix << "Test resource.\n";
+    }
+
+    void on_dump_config(std::ostream &os, const utils::Str &line_prefix) const override {
+        os << line_prefix << "No configuration.\n";
+    }
+
+    void on_dump_state(std::ostream &os, const utils::Str &line_prefix) const override {
+        for (auto cycle : used) {
+            os << line_prefix << "cycle " << cycle << " in use\n";
+        }
+    }
+
+public:
+
+    explicit OneGatePerCycleResource(const rmgr::Context &context) : Base(context) {}
+
+    utils::Str get_friendly_type() const override {
+        return "One gate per cycle";
+    }
+
+};
+
+/**
+ * Returns the debug representation of the given resource state.
+ */
+static utils::Str dump(const rmgr::State &state) {
+    std::ostringstream ss;
+    state.dump(ss);
+    return ss.str();
+}
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto kernel = utils::make<ir::compat::Kernel>("gates", plat, 7, 32, 10);
+    kernel->x(0);
+    kernel->y(1);
+    kernel->x(1);
+    kernel->x(2);
+    kernel->y(3);
+    auto x0 = kernel->gates[0];
+    auto y1 = kernel->gates[1];
+    auto x1 = kernel->gates[2];
+    auto x2 = kernel->gates[3];
+    auto y3 = kernel->gates[4];
+
+    // Build a state for the default cc_light resources, which support
+    // checkpoints, plus a resource that has to be cloned instead.
+    rmgr::Factory factory;
+    factory.register_resource<OneGatePerCycleResource>("OneGatePerCycle");
+    auto manager = rmgr::Manager::from_defaults(plat, factory);
+    manager.add_resource("OneGatePerCycle");
+    auto state = manager.build(rmgr::Direction::FORWARD);
+    state.reserve(0, x2);
+    auto initial = dump(state);
+
+    // The qwg instrument resource only allows x(0) and y(1) to start in the
+    // same cycle if they use the same function, so reserving x(0) in cycle 2
+    // blocks y(1) but not x(1) there; the test resource blocks cycle 2
+    // altogether. Rolling back must undo both, including the function
+    // recorded in the instrument undo log and the cloned test resource.
+    QL_ASSERT(state.available(2, y1));
+    state.checkpoint();
+    QL_ASSERT_EQ(state.get_num_checkpoints(), 1);
+    state.reserve(2, x0);
+    QL_ASSERT(!state.available(2, y1));
+    QL_ASSERT(!state.available(2, x1));
+    QL_ASSERT(state.available(4, x1));
+    QL_ASSERT(dump(state) != initial);
+    state.rollback();
+    QL_ASSERT_EQ(state.get_num_checkpoints(), 0);
+    QL_ASSERT_EQ(dump(state), initial);
+    QL_ASSERT(state.available(2, y1));
+
+    // Nested checkpoints: committing the inner checkpoint keeps its
+    // reservations, but they are still undone by rolling back the outer one.
+    // Reservations may also restart from an earlier cycle after a rollback,
+    // even though the state is built for forward scheduling.
+    state.checkpoint();
+    state.reserve(2, x0);
+    auto after_x0 = dump(state);
+    state.checkpoint();
+    state.reserve(4, y3);
+    state.rollback();
+    QL_ASSERT_EQ(dump(state), after_x0);
+    state.checkpoint();
+    state.reserve(4, y3);
+    state.commit();
+    QL_ASSERT_EQ(state.get_num_checkpoints(), 1);
+    QL_ASSERT(!state.available(4, x1));
+    state.rollback();
+    QL_ASSERT_EQ(dump(state), initial);
+    state.checkpoint();
+    state.reserve(1, y1);
+    state.commit();
+    QL_ASSERT_EQ(state.get_num_checkpoints(), 0);
+    QL_ASSERT(!state.available(1, x0));
+    state = manager.build(rmgr::Direction::FORWARD);
+    state.reserve(0, x2);
+
+    // A failed reservation leaves the state broken, which can only be
+    // recovered from by rolling back.
+    state.checkpoint();
+    state.reserve(2, x0);
+    utils::Bool failed = false;
+    try {
+        state.reserve(2, y1);
+    } catch (utils::Exception &) {
+        failed = true;
+    }
+    QL_ASSERT(failed);
+    failed = false;
+    try {
+        state.available(3, x1);
+    } catch (utils::Exception &) {
+        failed = true;
+    }
+    QL_ASSERT(failed);
+    state.rollback();
+    QL_ASSERT_EQ(dump(state), initial);
+    QL_ASSERT(state.available(2, y1));
+
+    // Copies of a state with active checkpoints are independent of the
+    // original, and can each be rolled back.
+    state.checkpoint();
+    state.reserve(2, x0);
+    auto copy = state;
+    QL_ASSERT_EQ(copy.get_num_checkpoints(), 1);
+    copy.reserve(4, y3);
+    QL_ASSERT(state.available(4, y3));
+    state.rollback();
+    QL_ASSERT_EQ(dump(state), initial);
+    QL_ASSERT(!copy.available(4, x1));
+    copy.rollback();
+    QL_ASSERT_EQ(dump(copy), initial);
+
+    return 0;
+}
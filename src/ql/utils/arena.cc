@@ -0,0 +1,258 @@
+/** \file
+ * Provides a pooled arena allocator that tree nodes can optionally be
+ * allocated from, to avoid the overhead of millions of small heap allocations
+ * for large programs.
+ */
+
+#include "ql/utils/arena.h"
+
+#include <new>
+#include "ql/utils/logger.h"
+
+namespace ql {
+namespace utils {
+
+const UInt Arena::GRANULE;
+const UInt Arena::MAX_POOLED_SIZE;
+const UInt Arena::CHUNK_SIZE;
+const UInt Arena::NUM_SIZE_CLASSES;
+
+/**
+ * Source of unique arena identifiers. Zero is never used, so it can mark an
+ * empty pool cache.
+ */
+static std::atomic<UInt> next_arena_id{1};
+
+/**
+ * Cache for the pool of the arena that the current thread used most recently,
+ * to avoid the lock and the map lookup for all but the first allocation.
+ */
+struct PoolCache {
+
+    /**
+     * Unique identifier of the arena that the pool belongs to. Arena pointers
+     * can't be used for this, because a new arena may be allocated at the
+     * address of a released arena.
+     */
+    UInt arena_id = 0;
+
+    /**
+     * The cached pool.
+     */
+    void *pool = nullptr;
+
+};
+
+/**
+ * The pool cache for the current thread.
+ */
+static thread_local PoolCache pool_cache;
+
+/**
+ * Constructs an empty arena. No memory is allocated until the first
+ * allocation.
+ */
+Arena::Arena() : id(next_arena_id++) {
+}
+
+/**
+ * Returns all chunks to the system.
+ */
+Arena::~Arena() {
+    for (const auto &it : pools) {
+        for (auto chunk : it.second->chunks) {
+            ::operator delete(chunk);
+        }
+    }
+}
+
+/**
+ * Deleter for the ArenaRef returned by create(). Destroys the arena if no
+ * objects allocated from it are alive anymore, or leaks it otherwise.
+ */
+void Arena::release(Arena *arena) {
+    auto num_live = arena->sum(&Pool::num_live);
+    if (num_live) {
+        QL_WOUT(
+            "leaking arena with " << (arena->sum(&Pool::num_chunk_bytes) >> 10) <<
+            " KiB of chunks, because " << num_live << " objects allocated " <<
+            "from it are still alive"
+        );
+        return;
+    }
+    delete arena;
+}
+
+/**
+ * Creates a new arena.
+ */
+ArenaRef Arena::create() {
+    return ArenaRef(new Arena(), &Arena::release);
+}
+
+/**
+ * Returns the pool for the calling thread, creating it if needed.
+ */
+Arena::Pool &Arena::get_pool() {
+    if (pool_cache.arena_id == id) {
+        return *static_cast<Pool*>(pool_cache.pool);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &pool = pools.set(std::this_thread::get_id());
+    if (!pool) {
+        pool.reset(new Pool());
+    }
+    pool_cache.arena_id = id;
+    pool_cache.pool = pool.get();
+    return *pool;
+}
+
+/**
+ * Returns the sum of the given counter over all pools.
+ */
+Int Arena::sum(Counter Pool::*counter) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Int result = 0;
+    for (const auto &it : pools) {
+        result += ((*it.second).*counter).get();
+    }
+    return result;
+}
+
+/**
+ * Allocates a block of the given size and alignment.
+ */
+void *Arena::allocate(UInt size, UInt alignment) {
+    if (!size) {
+        size = 1;
+    }
+    auto &pool = get_pool();
+    pool.num_live.add(1);
+
+    // Forward allocations we can't pool to the global allocator.
+    if (size > MAX_POOLED_SIZE || alignment > GRANULE) {
+        pool.num_forwarded.add(1);
+        return ::operator new(size);
+    }
+
+    // Try to reuse a block from the free list for this size class.
+    pool.num_allocations.add(1);
+    auto size_class = (size - 1) / GRANULE;
+    if (auto block = pool.free_lists[size_class]) {
+        pool.free_lists[size_class] = block->next;
+        pool.num_reuses.add(1);
+        return block;
+    }
+
+    // Bump-allocate from the current chunk, starting a new one if needed. The
+    // remainder of the previous chunk is simply wasted; it is never more than
+    // MAX_POOLED_SIZE bytes.
+    auto rounded_size = (size_class + 1) * GRANULE;
+    if (pool.remaining < rounded_size) {
+        pool.cursor = static_cast<char*>(::operator new(CHUNK_SIZE));
+        pool.remaining = CHUNK_SIZE;
+        pool.chunks.push_back(pool.cursor);
+        pool.num_chunk_bytes.add(CHUNK_SIZE);
+    }
+    void *ptr = pool.cursor;
+    pool.cursor += rounded_size;
+    pool.remaining -= rounded_size;
+    return ptr;
+}
+
+/**
+ * Deallocates a block previously returned by allocate() with the same size and
+ * alignment. This may be called from a different thread than the one that
+ * allocated the block.
+ */
+void Arena::deallocate(void *ptr, UInt size, UInt alignment) {
+    if (!ptr) {
+        return;
+    }
+    if (!size) {
+        size = 1;
+    }
+    auto &pool = get_pool();
+    pool.num_live.add(-1);
+    if (size > MAX_POOLED_SIZE || alignment > GRANULE) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    // Blocks are interchangeable between pools of the same arena, so a block
+    // allocated by another thread can simply be added to the free list of
+    // the calling thread.
+    auto size_class = (size - 1) / GRANULE;
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = pool.free_lists[size_class];
+    pool.free_lists[size_class] = block;
+
+}
+
+/**
+ * Returns the total number of allocations served by the arena itself.
+ */
+UInt Arena::get_num_allocations() {
+    return sum(&Pool::num_allocations);
+}
+
+/**
+ * Returns the number of allocations that reused a previously deallocated
+ * block.
+ */
+UInt Arena::get_num_reuses() {
+    return sum(&Pool::num_reuses);
+}
+
+/**
+ * Returns the number of allocations that were forwarded to the global
+ * allocator because they were too large or too strictly aligned.
+ */
+UInt Arena::get_num_forwarded() {
+    return sum(&Pool::num_forwarded);
+}
+
+/**
+ * Returns the number of allocations that have not been deallocated yet.
+ */
+UInt Arena::get_num_live() {
+    return sum(&Pool::num_live);
+}
+
+/**
+ * Returns the number of bytes of chunk memory requested from the system.
+ */
+UInt Arena::get_num_chunk_bytes() {
+    return sum(&Pool::num_chunk_bytes);
+}
+
+/**
+ * The arena that is active for the current thread.
+ */
+static thread_local ArenaRef active_arena;
+
+/**
+ * Makes the given arena active. An empty reference disables arena allocation
+ * within the scope.
+ */
+ArenaScope::ArenaScope(const ArenaRef &arena) : previous(active_arena) {
+    active_arena = arena;
+}
+
+/**
+ * Restores the previously active arena.
+ */
+ArenaScope::~ArenaScope() {
+    active_arena = std::move(previous);
+}
+
+/**
+ * Returns the arena that is active for the current thread, or nullptr if none
+ * is.
+ */
+const ArenaRef &ArenaScope::get_active() {
+    return active_arena;
+}
+
+} // namespace utils
+} // namespace ql
@@ -0,0 +1,96 @@
+/** \file
+ * Provides a minimal facility for running independent pieces of work on
+ * multiple threads.
+ */
+
+#include "ql/utils/parallel.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "ql/utils/vec.h"
+#include "ql/utils/arena.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Returns the number of worker threads to use for the given requested number
+ * of threads. Zero means that the hardware concurrency should be used.
+ */
+UInt get_num_threads(UInt requested) {
+    if (requested) {
+        return requested;
+    }
+    return max<UInt>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * Calls fn(i) for each i in [0, count), distributing the calls dynamically
+ * over at most num_threads threads (the calling thread included). Zero means
+ * that the hardware concurrency is used. The arena that is active for the
+ * calling thread (if any) is also made active in the worker threads, so tree
+ * nodes constructed by fn are allocated from the same arena.
+ *
+ * If any of the calls throws an exception, no further calls are started, and
+ * the first exception is rethrown in the calling thread after all workers have
+ * stopped.
+ *
+ * fn must of course be safe to call concurrently for different indices.
+ */
+void parallel_for(UInt count, const std::function<void(UInt)> &fn, UInt num_threads) {
+    num_threads = min(get_num_threads(num_threads), count);
+
+    // Don't bother with threads if there's nothing to parallelize.
+    if (num_threads <= 1) {
+        for (UInt i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<UInt> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+    auto arena = ArenaScope::get_active();
+
+    auto worker = [&]() {
+        ArenaScope scope(arena);
+        while (!failed) {
+            auto i = next++;
+            if (i >= count) {
+                break;
+            }
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    // Spawn num_threads - 1 workers, and use the calling thread as the last
+    // one.
+    Vec<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (UInt t = 1; t < num_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+} // namespace utils
+} // namespace ql
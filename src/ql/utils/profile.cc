@@ -0,0 +1,219 @@
+/** \file
+ * Provides platform-agnostic primitives for measuring the time and memory used
+ * by (parts of) the compiler, for profiling and benchmarking purposes.
+ */
+
+#include "ql/utils/profile.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+namespace ql {
+namespace utils {
+
+/**
+ * Returns the number of seconds of wall-clock time elapsed since some
+ * arbitrary but fixed point in time (namely the first call to this function).
+ * Uses a monotonic clock, so differences between values are always
+ * non-negative.
+ */
+Real get_wall_time() {
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point epoch = Clock::now();
+    return std::chrono::duration<Real>(Clock::now() - epoch).count();
+}
+
+/**
+ * Returns the number of seconds of CPU time (user + system) consumed by this
+ * process thus far, summed over all threads. Returns 0 if this cannot be
+ * determined on the current platform.
+ */
+Real get_cpu_time() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+
+    // FILETIMEs are in units of 100ns.
+    auto to_seconds = [](const FILETIME &ft) {
+        return (Real)(((UInt)ft.dwHighDateTime << 32) | ft.dwLowDateTime) * 1.0e-7;
+    };
+    return to_seconds(kernel) + to_seconds(user);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0.0;
+    }
+    return (
+        (Real)usage.ru_utime.tv_sec + (Real)usage.ru_utime.tv_usec * 1.0e-6 +
+        (Real)usage.ru_stime.tv_sec + (Real)usage.ru_stime.tv_usec * 1.0e-6
+    );
+#endif
+}
+
+/**
+ * Returns the peak resident set size of this process thus far in bytes, or 0
+ * if this cannot be determined on the current platform.
+ */
+UInt get_peak_rss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+#ifdef __APPLE__
+    // ru_maxrss is in bytes on Mac.
+    return usage.ru_maxrss;
+#else
+    // ru_maxrss is in kilobytes on Linux and most BSDs.
+    return (UInt)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+/**
+ * Constructs a snapshot with all counters set to zero.
+ */
+ResourceUsage::ResourceUsage() :
+    wall_time(0.0),
+    cpu_time(0.0),
+    peak_rss(0)
+{
+}
+
+/**
+ * Takes a snapshot of the current resource usage counters.
+ */
+ResourceUsage ResourceUsage::now() {
+    ResourceUsage usage;
+    usage.wall_time = get_wall_time();
+    usage.cpu_time = get_cpu_time();
+    usage.peak_rss = get_peak_rss();
+    return usage;
+}
+
+/**
+ * Returns the resource usage from the given earlier snapshot up to this
+ * snapshot. The peak RSS of the result is the amount by which the peak
+ * resident set size grew in between the snapshots, which is zero if the
+ * previous peak was not exceeded.
+ */
+ResourceUsage ResourceUsage::since(const ResourceUsage &start) const {
+    ResourceUsage usage;
+    usage.wall_time = wall_time - start.wall_time;
+    usage.cpu_time = cpu_time - start.cpu_time;
+    usage.peak_rss = (peak_rss > start.peak_rss) ? (peak_rss - start.peak_rss) : 0;
+    return usage;
+}
+
+/**
+ * Constructs a stopped stopwatch with no accumulated time.
+ */
+Stopwatch::Stopwatch() :
+    started(),
+    total_ns(0),
+    count(0),
+    running(false)
+{
+}
+
+/**
+ * Starts the stopwatch. No-op if it is already running.
+ */
+void Stopwatch::start() {
+    if (running) return;
+    running = true;
+    started = Clock::now();
+}
+
+/**
+ * Stops the stopwatch, adding the time since start() to the accumulated
+ * time. No-op if it is not running.
+ */
+void Stopwatch::stop() {
+    if (!running) return;
+    total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - started
+    ).count();
+    count++;
+    running = false;
+}
+
+/**
+ * Resets the accumulated time and count, and stops the stopwatch.
+ */
+void Stopwatch::reset() {
+    total_ns = 0;
+    count = 0;
+    running = false;
+}
+
+/**
+ * Returns the accumulated time in seconds, excluding the currently running
+ * period (if any).
+ */
+Real Stopwatch::get_seconds() const {
+    return (Real)total_ns * 1.0e-9;
+}
+
+/**
+ * Returns the number of completed start()/stop() cycles.
+ */
+UInt Stopwatch::get_count() const {
+    return count;
+}
+
+/**
+ * Adds the accumulated time and count of the given stopwatch to this one.
+ */
+void Stopwatch::merge(const Stopwatch &other) {
+    total_ns += other.total_ns;
+    count += other.count;
+}
+
+/**
+ * Returns whether the stopwatch is currently running.
+ */
+Bool Stopwatch::is_running() const {
+    return running;
+}
+
+/**
+ * Starts the given stopwatch.
+ */
+ScopedTimer::ScopedTimer(Stopwatch &stopwatch) :
+    stopwatch(stopwatch),
+    owner(!stopwatch.is_running())
+{
+    if (owner) {
+        stopwatch.start();
+    }
+}
+
+/**
+ * Stops the stopwatch, if this timer started it.
+ */
+ScopedTimer::~ScopedTimer() {
+    if (owner) {
+        stopwatch.stop();
+    }
+}
+
+} // namespace utils
+} // namespace ql
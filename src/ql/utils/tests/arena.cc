@@ -0,0 +1,129 @@
+#include <thread>
+
+#include "ql/utils/arena.h"
+#include "ql/utils/exception.h"
+#include "ql/utils/logger.h"
+
+using namespace ql::utils;
+
+struct Node {
+    UInt value;
+    UInt padding[3];
+    explicit Node(UInt value) : value(value), padding() {}
+};
+
+struct Large {
+    Byte data[1024];
+};
+
+int main() {
+
+    // Basic allocation, reuse, and forwarding.
+    {
+        auto arena = Arena::create();
+        auto a = arena->allocate(24, 8);
+        auto b = arena->allocate(24, 8);
+        QL_ASSERT(a != b);
+        QL_ASSERT(reinterpret_cast<UInt>(a) % Arena::GRANULE == 0);
+        QL_ASSERT(reinterpret_cast<UInt>(b) % Arena::GRANULE == 0);
+        QL_ASSERT_EQ(arena->get_num_allocations(), 2);
+        QL_ASSERT_EQ(arena->get_num_live(), 2);
+        arena->deallocate(a, 24, 8);
+        QL_ASSERT_EQ(arena->get_num_live(), 1);
+        auto c = arena->allocate(20, 4);
+        QL_ASSERT(c == a);
+        QL_ASSERT_EQ(arena->get_num_reuses(), 1);
+        auto d = arena->allocate(Arena::MAX_POOLED_SIZE + 1, 8);
+        QL_ASSERT_EQ(arena->get_num_forwarded(), 1);
+        arena->deallocate(d, Arena::MAX_POOLED_SIZE + 1, 8);
+        arena->deallocate(b, 24, 8);
+        arena->deallocate(c, 20, 4);
+        QL_ASSERT_EQ(arena->get_num_live(), 0);
+        QL_ASSERT_EQ(arena->get_num_chunk_bytes(), Arena::CHUNK_SIZE);
+    }
+
+    // Chunk overflow.
+    {
+        auto arena = Arena::create();
+        Vec<void*> ptrs;
+        for (UInt i = 0; i < 2 * Arena::CHUNK_SIZE / 64; i++) {
+            ptrs.push_back(arena->allocate(64, 8));
+        }
+        QL_ASSERT_EQ(arena->get_num_chunk_bytes(), 2 * Arena::CHUNK_SIZE);
+        for (auto ptr : ptrs) {
+            arena->deallocate(ptr, 64, 8);
+        }
+    }
+
+    // Allocation from multiple threads, with blocks allocated by one thread
+    // being deallocated by another.
+    {
+        const UInt num_threads = 4;
+        const UInt num_blocks = 10000;
+        auto arena = Arena::create();
+        Vec<Vec<void*>> ptrs(num_threads);
+        Vec<std::thread> threads;
+        for (UInt t = 0; t < num_threads; t++) {
+            threads.emplace_back([&arena, &ptrs, t, num_blocks]() {
+                for (UInt i = 0; i < num_blocks; i++) {
+                    ptrs[t].push_back(arena->allocate(32, 8));
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+        QL_ASSERT_EQ(arena->get_num_allocations(), num_threads * num_blocks);
+        QL_ASSERT_EQ(arena->get_num_live(), num_threads * num_blocks);
+        for (UInt t = 0; t < num_threads; t++) {
+            threads.emplace_back([&arena, &ptrs, t, num_threads]() {
+                for (auto ptr : ptrs[(t + 1) % num_threads]) {
+                    arena->deallocate(ptr, 32, 8);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        QL_ASSERT_EQ(arena->get_num_live(), 0);
+    }
+
+    // Active arena scopes.
+    QL_ASSERT(!ArenaScope::get_active());
+    {
+        auto arena = Arena::create();
+        ArenaScope scope(arena);
+        QL_ASSERT(ArenaScope::get_active() == arena);
+        {
+            auto node = make_shared_in_active_arena<Node>(42);
+            QL_ASSERT_EQ(node->value, 42);
+            QL_ASSERT_EQ(arena->get_num_allocations(), 1);
+            auto large = make_shared_in_active_arena<Large>();
+            QL_ASSERT_EQ(arena->get_num_forwarded(), 1);
+            {
+                ArenaScope inner(nullptr);
+                QL_ASSERT(!ArenaScope::get_active());
+                auto heap_node = make_shared_in_active_arena<Node>(1);
+                QL_ASSERT_EQ(arena->get_num_allocations(), 1);
+            }
+            QL_ASSERT(ArenaScope::get_active() == arena);
+        }
+        QL_ASSERT_EQ(arena->get_num_live(), 0);
+    }
+    QL_ASSERT(!ArenaScope::get_active());
+
+    // Objects that are still alive when the arena is released remain valid,
+    // because the arena is leaked in that case.
+    logger::set_log_level("LOG_NOTHING");
+    std::shared_ptr<Node> survivor;
+    {
+        auto arena = Arena::create();
+        ArenaScope scope(arena);
+        survivor = make_shared_in_active_arena<Node>(42);
+    }
+    QL_ASSERT_EQ(survivor->value, 42);
+    survivor.reset();
+
+    return 0;
+}
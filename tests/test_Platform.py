@@ -57,5 +57,25 @@ class Test_platform(unittest.TestCase):
             os.path.join(curdir, 'golden', name + '_last.qasm')
         ))
 
+    def test_platform_shared(self):
+        config_fn = os.path.join(curdir, 'test_cfg_none.json')
+        ql.Platform.clear_shared()
+        platf_a = ql.Platform.get_shared('shared', config_fn)
+        platf_b = ql.Platform.get_shared('shared', config_fn)
+        self.assertEqual(platf_a.config_file, config_fn)
+        self.assertEqual(platf_a.get_qubit_number(), platf_b.get_qubit_number())
+        self.assertEqual(platf_a.dump_info(), platf_b.dump_info())
+        ql.Platform.clear_shared()
+
+    def test_platform_preprocessed_config(self):
+        config_fn = os.path.join(curdir, 'test_cfg_none.json')
+        cache_fn = os.path.join(output_dir, 'test_platform_preprocessed.bin')
+        platf = ql.Platform('preprocessed', config_fn)
+        platf.save_preprocessed_config(cache_fn)
+        loaded = ql.Platform('preprocessed', cache_fn)
+        self.assertEqual(loaded.config_file, config_fn)
+        self.assertEqual(loaded.get_qubit_number(), platf.get_qubit_number())
+        self.assertEqual(loaded.dump_info(), platf.dump_info())
+
 if __name__ == '__main__':
     unittest.main()